@@ -0,0 +1,70 @@
+description('Test that changing an attribute of a parsed element does not change another element that was parsed with identical attributes.');
+
+document.write("<div id='container' style='display: none'>"
+    + "<span class='a' title='t'></span><span class='a' title='t'></span>"
+    + "<p class='b' align='right'></p><p class='b' align='right'></p>"
+    + "<p class='c' align='center'></p><p class='c' align='center'></p>"
+    + "<b title='t' lang='en'></b><b title='t' lang='en'></b>"
+    + "<i class='d' title='t'></i><i class='d' title='t'></i>"
+    + "<input type='text' class='e' value='v'><input type='text' class='e' value='v'>"
+    + "</div>");
+
+var container = document.getElementById('container');
+var spans = container.getElementsByTagName('span');
+var paragraphs = container.getElementsByTagName('p');
+var bolds = container.getElementsByTagName('b');
+var italics = container.getElementsByTagName('i');
+var inputs = container.getElementsByTagName('input');
+
+debug("setAttribute and removeAttribute");
+spans[0].setAttribute('title', 'changed');
+shouldBe("spans[0].title", "'changed'");
+shouldBe("spans[1].title", "'t'");
+paragraphs[2].removeAttribute('align');
+shouldBe("paragraphs[2].hasAttribute('align')", "false");
+shouldBe("paragraphs[3].getAttribute('align')", "'center'");
+shouldBe("getComputedStyle(paragraphs[2]).textAlign", "'-webkit-auto'");
+shouldBe("getComputedStyle(paragraphs[3]).textAlign", "'-webkit-center'");
+
+debug("Setting the value of an item of the attributes collection");
+paragraphs[0].attributes[1].value = 'left';
+shouldBe("paragraphs[0].getAttribute('align')", "'left'");
+shouldBe("paragraphs[1].getAttribute('align')", "'right'");
+shouldBe("getComputedStyle(paragraphs[0]).textAlign", "'-webkit-left'");
+shouldBe("getComputedStyle(paragraphs[1]).textAlign", "'-webkit-right'");
+
+debug("Attr nodes from getAttributeNode and attributes.item");
+var attr = bolds[0].getAttributeNode('title');
+shouldBe("bolds[0].getAttributeNode('title')", "attr");
+shouldBe("bolds[1].getAttributeNode('title') == attr", "false");
+shouldBe("bolds[1].getAttributeNode('title').ownerElement", "bolds[1]");
+attr.value = 'changed';
+shouldBe("bolds[0].title", "'changed'");
+shouldBe("bolds[1].title", "'t'");
+bolds[1].attributes.item(1).nodeValue = 'fr';
+shouldBe("bolds[0].lang", "'en'");
+shouldBe("bolds[1].lang", "'fr'");
+
+debug("Attribute nodes found by XPath");
+var result = document.evaluate("//i[@class='d']/@title", document, null, XPathResult.ORDERED_NODE_SNAPSHOT_TYPE, null);
+shouldBe("result.snapshotLength", "2");
+shouldBe("result.snapshotItem(0).ownerElement", "italics[0]");
+shouldBe("result.snapshotItem(1).ownerElement", "italics[1]");
+result.snapshotItem(0).value = 'changed';
+shouldBe("italics[0].title", "'changed'");
+shouldBe("italics[1].title", "'t'");
+shouldBe("document.evaluate(\"count(//i[@title='t'])\", document, null, XPathResult.NUMBER_TYPE, null).numberValue", "1");
+
+debug("Changing the type of an input");
+inputs[0].type = 'checkbox';
+shouldBe("inputs[0].type", "'checkbox'");
+shouldBe("inputs[1].type", "'text'");
+shouldBe("inputs[1].value", "'v'");
+shouldBe("inputs[1].getAttribute('value')", "'v'");
+inputs[0].type = 'text';
+inputs[1].type = 'hidden';
+shouldBe("inputs[0].type", "'text'");
+shouldBe("inputs[0].value", "'v'");
+shouldBe("inputs[1].type", "'hidden'");
+
+var successfullyParsed = true;
@@ -0,0 +1,40 @@
+description('Test that a control\'s labels list is updated when the control\'s id or a label\'s for attribute changes.');
+
+document.write("<label id='label1'></label><input id='input1'><div><label id='label2'></label></div>");
+var label1 = document.getElementById('label1');
+var label2 = document.getElementById('label2');
+var input = document.getElementById('input1');
+var labels = input.labels;
+
+debug("No label refers to the input");
+shouldBe("labels.length", "0");
+
+debug("Set the for attribute of a label");
+label1.htmlFor = 'input1';
+shouldBe("labels.length", "1");
+shouldBe("labels[0]", "label1");
+
+debug("Set the for attribute of a label in another element");
+label2.setAttribute('for', 'input1');
+shouldBe("labels.length", "2");
+shouldBe("labels[1]", "label2");
+
+debug("Change the id of the input");
+input.id = 'input2';
+shouldBe("labels.length", "0");
+
+debug("Change the for attribute of a label to the new id");
+label2.setAttribute('for', 'input2');
+shouldBe("labels.length", "1");
+shouldBe("labels[0]", "label2");
+
+debug("Change the id of the input back");
+input.setAttribute('id', 'input1');
+shouldBe("labels.length", "1");
+shouldBe("labels[0]", "label1");
+
+debug("Remove the for attribute of a label");
+label1.removeAttribute('for');
+shouldBe("labels.length", "0");
+
+var successfullyParsed = true;
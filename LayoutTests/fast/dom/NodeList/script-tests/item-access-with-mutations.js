@@ -0,0 +1,102 @@
+description("Tests that live node lists and HTMLCollections read backwards and out of order return the right items when the DOM changes between reads.");
+
+function readItems(list, indices)
+{
+    var ids = [];
+    for (var i = 0; i < indices.length; ++i) {
+        var item = list[indices[i]];
+        ids.push(item ? item.id : "undefined");
+    }
+    return ids.join(" ");
+}
+
+function reversed(list)
+{
+    var indices = [];
+    for (var i = list.length - 1; i >= 0; --i)
+        indices.push(i);
+    return indices;
+}
+
+var scattered = [3, 0, 5, 1, 4, 2];
+
+var container = document.createElement("div");
+document.body.appendChild(container);
+var markup = "";
+for (var i = 0; i < 6; ++i)
+    markup += '<span id="s' + i + '" class="item" name="target"></span>';
+for (var i = 0; i < 6; ++i)
+    markup += '<a id="a' + i + '" href="#"></a>';
+container.innerHTML = markup;
+
+function element(id)
+{
+    return document.getElementById(id);
+}
+
+debug("\n1. A class list with an item removed");
+var classList = container.getElementsByClassName("item");
+shouldBe('readItems(classList, reversed(classList))', '"s5 s4 s3 s2 s1 s0"');
+shouldBe('readItems(classList, scattered)', '"s3 s0 s5 s1 s4 s2"');
+container.removeChild(element("s2"));
+shouldBe('readItems(classList, reversed(classList))', '"s5 s4 s3 s1 s0"');
+shouldBe('readItems(classList, scattered)', '"s4 s0 undefined s1 s5 s3"');
+
+debug("\n2. A class list with class attributes changed");
+element("s4").className = "other";
+shouldBe('readItems(classList, reversed(classList))', '"s5 s3 s1 s0"');
+shouldBe('readItems(classList, scattered)', '"s5 s0 undefined s1 undefined s3"');
+element("a0").className = "item";
+shouldBe('readItems(classList, reversed(classList))', '"a0 s5 s3 s1 s0"');
+shouldBe('readItems(classList, scattered)', '"s5 s0 undefined s1 a0 s3"');
+element("s4").className = "item";
+shouldBe('readItems(classList, reversed(classList))', '"a0 s5 s4 s3 s1 s0"');
+
+debug("\n3. A tag list with items removed and inserted");
+var tagList = container.getElementsByTagName("span");
+shouldBe('readItems(tagList, reversed(tagList))', '"s5 s4 s3 s1 s0"');
+container.removeChild(element("s0"));
+shouldBe('readItems(tagList, reversed(tagList))', '"s5 s4 s3 s1"');
+shouldBe('readItems(tagList, scattered)', '"s5 s1 undefined s3 undefined s4"');
+var s6 = document.createElement("span");
+s6.id = "s6";
+s6.className = "item";
+s6.setAttribute("name", "target");
+container.insertBefore(s6, element("s3"));
+shouldBe('readItems(tagList, reversed(tagList))', '"s5 s4 s3 s6 s1"');
+shouldBe('readItems(tagList, scattered)', '"s4 s1 undefined s6 s5 s3"');
+shouldBe('readItems(classList, reversed(classList))', '"a0 s5 s4 s3 s6 s1"');
+
+debug("\n4. A name list with name attributes changed");
+var nameList = document.getElementsByName("target");
+shouldBe('readItems(nameList, reversed(nameList))', '"s5 s4 s3 s6 s1"');
+element("s3").setAttribute("name", "other");
+shouldBe('readItems(nameList, reversed(nameList))', '"s5 s4 s6 s1"');
+element("a1").setAttribute("name", "target");
+shouldBe('readItems(nameList, reversed(nameList))', '"a1 s5 s4 s6 s1"');
+shouldBe('readItems(nameList, scattered)', '"s5 s1 undefined s6 a1 s4"');
+
+debug("\n5. The links collection with href attributes changed");
+var links = document.links;
+shouldBe('readItems(links, reversed(links))', '"a5 a4 a3 a2 a1 a0"');
+shouldBe('readItems(links, scattered)', '"a3 a0 a5 a1 a4 a2"');
+element("a2").removeAttribute("href");
+shouldBe('readItems(links, reversed(links))', '"a5 a4 a3 a1 a0"');
+shouldBe('readItems(links, scattered)', '"a4 a0 undefined a1 a5 a3"');
+element("a2").setAttribute("href", "#");
+shouldBe('readItems(links, reversed(links))', '"a5 a4 a3 a2 a1 a0"');
+container.removeChild(element("a4"));
+shouldBe('readItems(links, scattered)', '"a3 a0 undefined a1 a5 a2"');
+
+debug("\n6. The anchors collection with name attributes changed");
+var anchors = document.anchors;
+shouldBe('readItems(anchors, reversed(anchors))', '"a1"');
+element("a3").setAttribute("name", "anchor");
+element("a5").setAttribute("name", "anchor");
+shouldBe('readItems(anchors, reversed(anchors))', '"a5 a3 a1"');
+element("a3").removeAttribute("name");
+shouldBe('readItems(anchors, [1, 0, 2])', '"a5 a1 undefined"');
+
+document.body.removeChild(container);
+
+var successfullyParsed = true;
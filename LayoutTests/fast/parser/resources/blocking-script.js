@@ -0,0 +1 @@
+var blockingScriptRuns = (window.blockingScriptRuns || 0) + 1;
@@ -0,0 +1 @@
+document.write('<span id="written-by-external-script">external</span>');
@@ -0,0 +1 @@
+document.write('<textarea id="written-textarea">');
@@ -0,0 +1,16 @@
+// Builds a document fragment shaped like a typical application page: nested
+// containers, lists of items with a few classes each and some ids.
+function buildSelectorTree(container) {
+    var html = "<div id='header' class='bar'><a class='logo' href='#'>x</a><ul class='nav'>";
+    for (var i = 0; i < 20; ++i)
+        html += "<li class='nav-item'><a href='#" + i + "'>" + i + "</a></li>";
+    html += "</ul></div><div id='main' class='content'>";
+    for (var i = 0; i < 100; ++i) {
+        html += "<div class='section" + (i % 10 ? "" : " featured") + "'><h2 class='title'>" + i + "</h2><ul class='items'>";
+        for (var j = 0; j < 10; ++j)
+            html += "<li class='item " + (j % 2 ? "odd" : "even") + "' id='item-" + i + "-" + j + "'><span class='label'>" + j + "</span><input type='checkbox'></li>";
+        html += "</ul></div>";
+    }
+    html += "</div><div id='footer' class='bar'><p class='note'>end</p></div>";
+    container.innerHTML = html;
+}
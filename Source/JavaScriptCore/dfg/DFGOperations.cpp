@@ -62,6 +62,115 @@ EncodedJSValue operationValueAdd(ExecState* exec, EncodedJSValue encodedOp1, Enc
     return JSValue::encode(jsAddSlowCase(exec, op1, op2));
 }
 
+#if ENABLE(JIT_OPTIMIZE_TYPED_ARRAY_ACCESS)
+// Typed arrays fail the array speculation in the speculative JIT, so their accesses come
+// through here. Elements are reached through the embedder's descriptor rather than the
+// wrapper's index getter and setter.
+static const TypedArrayDescriptor* typedArrayDescriptorFor(JSGlobalData* globalData, JSCell* cell, TypedArrayType& type)
+{
+    const ClassInfo* classInfo = cell->structure()->classInfo();
+    for (unsigned i = 0; i < NumberOfTypedArrayTypes; ++i) {
+        type = static_cast<TypedArrayType>(i);
+        const TypedArrayDescriptor& descriptor = globalData->typedArrayDescriptor(type);
+        if (descriptor.m_classInfo == classInfo)
+            return &descriptor;
+    }
+    return 0;
+}
+
+static void* typedArrayStorage(JSCell* base, const TypedArrayDescriptor* descriptor, uint32_t index)
+{
+    char* cell = reinterpret_cast<char*>(base);
+    if (index >= *reinterpret_cast<unsigned*>(cell + descriptor->m_lengthOffset))
+        return 0;
+    return *reinterpret_cast<void**>(cell + descriptor->m_storageOffset);
+}
+
+static bool getTypedArrayIndex(JSGlobalData* globalData, JSCell* base, uint32_t index, JSValue& result)
+{
+    TypedArrayType type;
+    const TypedArrayDescriptor* descriptor = typedArrayDescriptorFor(globalData, base, type);
+    if (!descriptor)
+        return false;
+    void* storage = typedArrayStorage(base, descriptor, index);
+    if (!storage)
+        return false;
+
+    double number;
+    switch (type) {
+    case TypedArrayInt8:
+        result = jsNumber(static_cast<int8_t*>(storage)[index]);
+        return true;
+    case TypedArrayUint8:
+        result = jsNumber(static_cast<uint8_t*>(storage)[index]);
+        return true;
+    case TypedArrayInt16:
+        result = jsNumber(static_cast<int16_t*>(storage)[index]);
+        return true;
+    case TypedArrayUint16:
+        result = jsNumber(static_cast<uint16_t*>(storage)[index]);
+        return true;
+    case TypedArrayInt32:
+        result = jsNumber(static_cast<int32_t*>(storage)[index]);
+        return true;
+    case TypedArrayUint32:
+        result = jsNumber(static_cast<uint32_t*>(storage)[index]);
+        return true;
+    case TypedArrayFloat32:
+        number = static_cast<float*>(storage)[index];
+        break;
+    case TypedArrayFloat64:
+        number = static_cast<double*>(storage)[index];
+        break;
+    default:
+        ASSERT_NOT_REACHED();
+        return false;
+    }
+    // Only the canonical NaN may be boxed; other bit patterns could be mistaken for cells.
+    result = jsNumber(isnan(number) ? nonInlineNaN() : number);
+    return true;
+}
+
+static bool putTypedArrayIndex(JSGlobalData* globalData, JSCell* base, uint32_t index, JSValue value)
+{
+    // Leave conversions that could call back into script to the generic path.
+    if (!value.isNumber())
+        return false;
+    TypedArrayType type;
+    const TypedArrayDescriptor* descriptor = typedArrayDescriptorFor(globalData, base, type);
+    if (!descriptor)
+        return false;
+    void* storage = typedArrayStorage(base, descriptor, index);
+    if (!storage)
+        return false;
+
+    int32_t intValue = value.isInt32() ? value.asInt32() : toInt32(value.asDouble());
+    switch (type) {
+    case TypedArrayInt8:
+    case TypedArrayUint8:
+        static_cast<uint8_t*>(storage)[index] = intValue;
+        return true;
+    case TypedArrayInt16:
+    case TypedArrayUint16:
+        static_cast<uint16_t*>(storage)[index] = intValue;
+        return true;
+    case TypedArrayInt32:
+    case TypedArrayUint32:
+        static_cast<int32_t*>(storage)[index] = intValue;
+        return true;
+    case TypedArrayFloat32:
+        static_cast<float*>(storage)[index] = value.uncheckedGetNumber();
+        return true;
+    case TypedArrayFloat64:
+        static_cast<double*>(storage)[index] = value.uncheckedGetNumber();
+        return true;
+    default:
+        ASSERT_NOT_REACHED();
+        return false;
+    }
+}
+#endif
+
 EncodedJSValue operationGetByVal(ExecState* exec, EncodedJSValue encodedBase, EncodedJSValue encodedProperty)
 {
     JSValue baseValue = JSValue::decode(encodedBase);
@@ -86,6 +195,12 @@ EncodedJSValue operationGetByVal(ExecState* exec, EncodedJSValue encodedBase, En
             if (isJSByteArray(globalData, base) && asByteArray(base)->canAccessIndex(i))
                 return JSValue::encode(asByteArray(base)->getIndex(exec, i));
 
+#if ENABLE(JIT_OPTIMIZE_TYPED_ARRAY_ACCESS)
+            JSValue result;
+            if (getTypedArrayIndex(globalData, base, i, result))
+                return JSValue::encode(result);
+#endif
+
             return JSValue::encode(baseValue.get(exec, i));
         }
 
@@ -146,6 +261,11 @@ ALWAYS_INLINE static void operationPutByValInternal(ExecState* exec, EncodedJSVa
             }
         }
 
+#if ENABLE(JIT_OPTIMIZE_TYPED_ARRAY_ACCESS)
+        if (baseValue.isCell() && putTypedArrayIndex(globalData, baseValue.asCell(), i, value))
+            return;
+#endif
+
         baseValue.put(exec, i, value);
         return;
     }
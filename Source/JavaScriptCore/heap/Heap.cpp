@@ -24,6 +24,7 @@
 #include "CodeBlock.h"
 #include "ConservativeRoots.h"
 #include "GCActivityCallback.h"
+#include "HeapSnapshot.h"
 #include "Interpreter.h"
 #include "JSGlobalData.h"
 #include "JSGlobalObject.h"
@@ -32,6 +33,10 @@
 #include "Tracing.h"
 #include <algorithm>
 
+#if COMPILER(MSVC)
+#include <intrin.h>
+#endif
+
 #define COLLECT_ON_EVERY_SLOW_ALLOCATION 0
 
 using namespace std;
@@ -129,6 +134,31 @@ void* Heap::allocateSlowCase(size_t bytes)
     return result;
 }
 
+void Heap::startSamplingAllocationSites(unsigned interval)
+{
+    ASSERT(interval);
+    m_allocationSiteSampler = adoptPtr(new AllocationSiteSampler(interval));
+}
+
+void Heap::stopSamplingAllocationSites()
+{
+    m_allocationSiteSampler.clear();
+}
+
+// Not inlined, so that the return address is in the code that asked for the cell.
+NEVER_INLINE void Heap::sampleAllocation(void* cell)
+{
+    if (!m_allocationSiteSampler->shouldSample())
+        return;
+#if COMPILER(GCC)
+    m_allocationSiteSampler->add(static_cast<JSCell*>(cell), __builtin_return_address(0));
+#elif COMPILER(MSVC)
+    m_allocationSiteSampler->add(static_cast<JSCell*>(cell), _ReturnAddress());
+#else
+    UNUSED_PARAM(cell);
+#endif
+}
+
 void Heap::protect(JSValue k)
 {
     ASSERT(k);
@@ -311,7 +341,6 @@ public:
     PassOwnPtr<TypeCountSet> take();
     
 private:
-    const char* typeName(JSCell*);
     OwnPtr<TypeCountSet> m_typeCountSet;
 };
 
@@ -320,7 +349,7 @@ inline TypeCounter::TypeCounter()
 {
 }
 
-inline const char* TypeCounter::typeName(JSCell* cell)
+const char* Heap::typeName(JSCell* cell)
 {
     if (cell->isString())
         return "string";
@@ -339,7 +368,7 @@ inline const char* TypeCounter::typeName(JSCell* cell)
 
 inline void TypeCounter::operator()(JSCell* cell)
 {
-    m_typeCountSet->add(typeName(cell));
+    m_typeCountSet->add(Heap::typeName(cell));
 }
 
 inline PassOwnPtr<TypeCountSet> TypeCounter::take()
@@ -396,6 +425,9 @@ void Heap::reset(SweepToggle sweepToggle)
 
     JAVASCRIPTCORE_GC_MARKED();
 
+    if (m_allocationSiteSampler)
+        m_allocationSiteSampler->removeDeadSamples();
+
     m_markedSpace.reset();
     m_extraCost = 0;
 
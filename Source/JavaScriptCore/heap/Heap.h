@@ -32,6 +32,7 @@
 
 namespace JSC {
 
+    class AllocationSiteSampler;
     class GCActivityCallback;
     class GlobalCodeBlock;
     class HeapRootMarker;
@@ -91,6 +92,13 @@ namespace JSC {
         size_t protectedGlobalObjectCount();
         PassOwnPtr<TypeCountSet> protectedObjectTypeCounts();
         PassOwnPtr<TypeCountSet> objectTypeCounts();
+        static const char* typeName(JSCell*);
+
+        // Records the code that made every interval'th allocation, so that heap
+        // snapshots can say where the sampled objects that are still alive came from.
+        void startSamplingAllocationSites(unsigned interval);
+        void stopSamplingAllocationSites();
+        AllocationSiteSampler* allocationSiteSampler() { return m_allocationSiteSampler.get(); }
 
         void pushTempSortVector(Vector<ValueStringPair>*);
         void popTempSortVector(Vector<ValueStringPair>*);
@@ -112,6 +120,7 @@ namespace JSC {
 
         void* allocateSlowCase(size_t);
         void reportExtraMemoryCostSlowCase(size_t);
+        void sampleAllocation(void*);
 
         void markRoots();
         void markProtectedObjects(HeapRootMarker&);
@@ -131,6 +140,7 @@ namespace JSC {
         HashSet<MarkedArgumentBuffer*>* m_markListSet;
 
         OwnPtr<GCActivityCallback> m_activityCallback;
+        OwnPtr<AllocationSiteSampler> m_allocationSiteSampler;
 
         JSGlobalData* m_globalData;
         
@@ -0,0 +1,421 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HeapSnapshot.h"
+
+#include "Heap.h"
+#include "JSObject.h"
+#include "Structure.h"
+#include <algorithm>
+#include <wtf/text/StringHash.h>
+
+using namespace std;
+
+namespace JSC {
+
+// The last byte is the format version.
+static const char snapshotSignature[] = { 'J', 'S', 'C', 'H', 'E', 'A', 'P', 1 };
+
+void AllocationSiteSampler::removeDeadSamples()
+{
+    Vector<JSCell*> deadCells;
+    SampleMap::const_iterator end = m_samples.end();
+    for (SampleMap::const_iterator it = m_samples.begin(); it != end; ++it) {
+        if (!Heap::isMarked(it->first))
+            deadCells.append(it->first);
+    }
+    for (size_t i = 0; i < deadCells.size(); ++i)
+        m_samples.remove(deadCells[i]);
+}
+
+static size_t cellBytes(JSCell* cell)
+{
+    size_t bytes = MarkedBlock::blockFor(cell)->cellSize();
+    if (cell->isObject()) {
+        JSObject* object = asObject(cell);
+        if (!object->isUsingInlineStorage())
+            bytes += object->structure()->propertyStorageCapacity() * sizeof(WriteBarrierBase<Unknown>);
+    }
+    return bytes;
+}
+
+class HeapSnapshotBuilder {
+public:
+    HeapSnapshotBuilder(HeapSnapshot* snapshot)
+        : m_snapshot(snapshot)
+    {
+    }
+
+    void operator()(JSCell*);
+    void addAllocationSites(const AllocationSiteSampler&);
+
+private:
+    HeapSnapshot* m_snapshot;
+    HashMap<const char*, size_t> m_classIndices;
+    HashMap<Structure*, size_t> m_structureIndices;
+    HashMap<const void*, size_t> m_siteIndices;
+};
+
+void HeapSnapshotBuilder::operator()(JSCell* cell)
+{
+    const char* className = Heap::typeName(cell);
+    size_t bytes = cellBytes(cell);
+
+    ++m_snapshot->m_objectCount;
+    m_snapshot->m_bytes += bytes;
+
+    pair<HashMap<const char*, size_t>::iterator, bool> classResult = m_classIndices.add(className, m_snapshot->m_classes.size());
+    if (classResult.second) {
+        HeapSnapshot::ClassEntry entry = { className, 0, 0 };
+        m_snapshot->m_classes.append(entry);
+    }
+    HeapSnapshot::ClassEntry& classEntry = m_snapshot->m_classes[classResult.first->second];
+    ++classEntry.count;
+    classEntry.bytes += bytes;
+
+    Structure* structure = cell->structure();
+    pair<HashMap<Structure*, size_t>::iterator, bool> structureResult = m_structureIndices.add(structure, m_snapshot->m_structures.size());
+    if (structureResult.second) {
+        HeapSnapshot::StructureEntry entry = { reinterpret_cast<uintptr_t>(structure), classEntry.className, structure->propertyStorageSize(), 0, 0 };
+        m_snapshot->m_structures.append(entry);
+    }
+    HeapSnapshot::StructureEntry& structureEntry = m_snapshot->m_structures[structureResult.first->second];
+    ++structureEntry.count;
+    structureEntry.bytes += bytes;
+}
+
+void HeapSnapshotBuilder::addAllocationSites(const AllocationSiteSampler& sampler)
+{
+    m_snapshot->m_samplingInterval = sampler.interval();
+
+    AllocationSiteSampler::SampleMap::const_iterator end = sampler.samples().end();
+    for (AllocationSiteSampler::SampleMap::const_iterator it = sampler.samples().begin(); it != end; ++it) {
+        pair<HashMap<const void*, size_t>::iterator, bool> result = m_siteIndices.add(it->second, m_snapshot->m_allocationSites.size());
+        if (result.second) {
+            HeapSnapshot::AllocationSiteEntry entry = { reinterpret_cast<uintptr_t>(it->second), 0, 0 };
+            m_snapshot->m_allocationSites.append(entry);
+        }
+        HeapSnapshot::AllocationSiteEntry& siteEntry = m_snapshot->m_allocationSites[result.first->second];
+        siteEntry.count += sampler.interval();
+        siteEntry.bytes += static_cast<int64_t>(cellBytes(it->first)) * sampler.interval();
+    }
+}
+
+HeapSnapshot::HeapSnapshot()
+    : m_objectCount(0)
+    , m_bytes(0)
+    , m_samplingInterval(0)
+{
+}
+
+PassOwnPtr<HeapSnapshot> HeapSnapshot::take(Heap& heap)
+{
+    // Collecting also drops the samples of cells that are no longer reachable.
+    heap.collectAllGarbage();
+
+    OwnPtr<HeapSnapshot> snapshot = adoptPtr(new HeapSnapshot);
+    HeapSnapshotBuilder builder(snapshot.get());
+    heap.forEach(builder);
+    if (AllocationSiteSampler* sampler = heap.allocationSiteSampler())
+        builder.addAllocationSites(*sampler);
+
+    snapshot->sortEntries();
+    return snapshot.release();
+}
+
+template<typename Entry> static bool isLarger(const Entry& a, const Entry& b)
+{
+    return a.bytes > b.bytes;
+}
+
+void HeapSnapshot::sortEntries()
+{
+    stable_sort(m_classes.begin(), m_classes.end(), isLarger<ClassEntry>);
+    stable_sort(m_structures.begin(), m_structures.end(), isLarger<StructureEntry>);
+    stable_sort(m_allocationSites.begin(), m_allocationSites.end(), isLarger<AllocationSiteEntry>);
+}
+
+static String entryKey(const HeapSnapshot::ClassEntry& entry) { return entry.className.data(); }
+static uint64_t entryKey(const HeapSnapshot::StructureEntry& entry) { return entry.structureID; }
+static uint64_t entryKey(const HeapSnapshot::AllocationSiteEntry& entry) { return entry.site; }
+
+template<typename Key, typename Entry> static void diffEntries(const Vector<Entry>& from, const Vector<Entry>& to, Vector<Entry>& result)
+{
+    HashMap<Key, size_t> fromIndices;
+    for (size_t i = 0; i < from.size(); ++i)
+        fromIndices.add(entryKey(from[i]), i);
+
+    Vector<bool> matched(from.size());
+    matched.fill(false);
+
+    for (size_t i = 0; i < to.size(); ++i) {
+        Entry entry = to[i];
+        typename HashMap<Key, size_t>::iterator it = fromIndices.find(entryKey(entry));
+        if (it != fromIndices.end()) {
+            matched[it->second] = true;
+            entry.count -= from[it->second].count;
+            entry.bytes -= from[it->second].bytes;
+        }
+        if (entry.count || entry.bytes)
+            result.append(entry);
+    }
+
+    for (size_t i = 0; i < from.size(); ++i) {
+        if (matched[i])
+            continue;
+        Entry entry = from[i];
+        entry.count = -entry.count;
+        entry.bytes = -entry.bytes;
+        result.append(entry);
+    }
+}
+
+PassOwnPtr<HeapSnapshot> HeapSnapshot::diff(const HeapSnapshot& from, const HeapSnapshot& to)
+{
+    OwnPtr<HeapSnapshot> snapshot = adoptPtr(new HeapSnapshot);
+    snapshot->m_objectCount = to.m_objectCount - from.m_objectCount;
+    snapshot->m_bytes = to.m_bytes - from.m_bytes;
+    snapshot->m_samplingInterval = to.m_samplingInterval;
+
+    diffEntries<String>(from.m_classes, to.m_classes, snapshot->m_classes);
+    diffEntries<uint64_t>(from.m_structures, to.m_structures, snapshot->m_structures);
+    diffEntries<uint64_t>(from.m_allocationSites, to.m_allocationSites, snapshot->m_allocationSites);
+
+    snapshot->sortEntries();
+    return snapshot.release();
+}
+
+// Numbers are written as LEB128 variable length integers, signed ones after
+// zigzag encoding, so the small counts that make up most of a snapshot take
+// a byte or two each.
+static void appendUnsigned(Vector<char>& data, uint64_t value)
+{
+    while (value >= 0x80) {
+        data.append(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    data.append(static_cast<char>(value));
+}
+
+static void appendSigned(Vector<char>& data, int64_t value)
+{
+    appendUnsigned(data, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+class SnapshotNameTable {
+public:
+    unsigned indexOf(const CString& name)
+    {
+        pair<HashMap<String, unsigned>::iterator, bool> result = m_indices.add(name.data(), m_names.size());
+        if (result.second)
+            m_names.append(name);
+        return result.first->second;
+    }
+
+    const Vector<CString>& names() const { return m_names; }
+
+private:
+    HashMap<String, unsigned> m_indices;
+    Vector<CString> m_names;
+};
+
+void HeapSnapshot::encode(Vector<char>& data) const
+{
+    SnapshotNameTable nameTable;
+    Vector<unsigned> classNames(m_classes.size());
+    for (size_t i = 0; i < m_classes.size(); ++i)
+        classNames[i] = nameTable.indexOf(m_classes[i].className);
+    Vector<unsigned> structureNames(m_structures.size());
+    for (size_t i = 0; i < m_structures.size(); ++i)
+        structureNames[i] = nameTable.indexOf(m_structures[i].className);
+
+    data.append(snapshotSignature, sizeof(snapshotSignature));
+    appendUnsigned(data, m_samplingInterval);
+    appendSigned(data, m_objectCount);
+    appendSigned(data, m_bytes);
+
+    const Vector<CString>& names = nameTable.names();
+    appendUnsigned(data, names.size());
+    for (size_t i = 0; i < names.size(); ++i) {
+        appendUnsigned(data, names[i].length());
+        data.append(names[i].data(), names[i].length());
+    }
+
+    appendUnsigned(data, m_classes.size());
+    for (size_t i = 0; i < m_classes.size(); ++i) {
+        appendUnsigned(data, classNames[i]);
+        appendSigned(data, m_classes[i].count);
+        appendSigned(data, m_classes[i].bytes);
+    }
+
+    appendUnsigned(data, m_structures.size());
+    for (size_t i = 0; i < m_structures.size(); ++i) {
+        appendUnsigned(data, m_structures[i].structureID);
+        appendUnsigned(data, structureNames[i]);
+        appendUnsigned(data, m_structures[i].propertyStorageSize);
+        appendSigned(data, m_structures[i].count);
+        appendSigned(data, m_structures[i].bytes);
+    }
+
+    appendUnsigned(data, m_allocationSites.size());
+    for (size_t i = 0; i < m_allocationSites.size(); ++i) {
+        appendUnsigned(data, m_allocationSites[i].site);
+        appendSigned(data, m_allocationSites[i].count);
+        appendSigned(data, m_allocationSites[i].bytes);
+    }
+}
+
+class SnapshotReader {
+public:
+    SnapshotReader(const char* data, size_t length)
+        : m_data(data)
+        , m_length(length)
+        , m_position(0)
+        , m_failed(false)
+    {
+    }
+
+    bool failed() const { return m_failed; }
+    bool atEnd() const { return m_position == m_length; }
+
+    bool readSignature()
+    {
+        if (m_length < sizeof(snapshotSignature) || memcmp(m_data, snapshotSignature, sizeof(snapshotSignature))) {
+            m_failed = true;
+            return false;
+        }
+        m_position = sizeof(snapshotSignature);
+        return true;
+    }
+
+    uint64_t readUnsigned()
+    {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (m_position == m_length)
+                break;
+            unsigned char byte = m_data[m_position++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+        m_failed = true;
+        return 0;
+    }
+
+    int64_t readSigned()
+    {
+        uint64_t value = readUnsigned();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // Counts are checked against the bytes left, so that a corrupt count
+    // cannot make us reserve huge vectors.
+    size_t readCount()
+    {
+        uint64_t count = readUnsigned();
+        if (count > m_length - m_position) {
+            m_failed = true;
+            return 0;
+        }
+        return static_cast<size_t>(count);
+    }
+
+    CString readString()
+    {
+        size_t length = readCount();
+        if (m_failed)
+            return CString();
+        CString string(m_data + m_position, length);
+        m_position += length;
+        return string;
+    }
+
+private:
+    const char* m_data;
+    size_t m_length;
+    size_t m_position;
+    bool m_failed;
+};
+
+PassOwnPtr<HeapSnapshot> HeapSnapshot::decode(const char* data, size_t length)
+{
+    SnapshotReader reader(data, length);
+    if (!reader.readSignature())
+        return 0;
+
+    OwnPtr<HeapSnapshot> snapshot = adoptPtr(new HeapSnapshot);
+    snapshot->m_samplingInterval = reader.readUnsigned();
+    snapshot->m_objectCount = reader.readSigned();
+    snapshot->m_bytes = reader.readSigned();
+
+    Vector<CString> names(reader.readCount());
+    for (size_t i = 0; i < names.size() && !reader.failed(); ++i)
+        names[i] = reader.readString();
+
+    size_t classCount = reader.readCount();
+    for (size_t i = 0; i < classCount && !reader.failed(); ++i) {
+        ClassEntry entry;
+        uint64_t nameIndex = reader.readUnsigned();
+        if (nameIndex >= names.size())
+            return 0;
+        entry.className = names[nameIndex];
+        entry.count = reader.readSigned();
+        entry.bytes = reader.readSigned();
+        snapshot->m_classes.append(entry);
+    }
+
+    size_t structureCount = reader.readCount();
+    for (size_t i = 0; i < structureCount && !reader.failed(); ++i) {
+        StructureEntry entry;
+        entry.structureID = reader.readUnsigned();
+        uint64_t nameIndex = reader.readUnsigned();
+        if (!entry.structureID || nameIndex >= names.size())
+            return 0;
+        entry.className = names[nameIndex];
+        entry.propertyStorageSize = reader.readUnsigned();
+        entry.count = reader.readSigned();
+        entry.bytes = reader.readSigned();
+        snapshot->m_structures.append(entry);
+    }
+
+    size_t siteCount = reader.readCount();
+    for (size_t i = 0; i < siteCount && !reader.failed(); ++i) {
+        AllocationSiteEntry entry;
+        entry.site = reader.readUnsigned();
+        if (!entry.site)
+            return 0;
+        entry.count = reader.readSigned();
+        entry.bytes = reader.readSigned();
+        snapshot->m_allocationSites.append(entry);
+    }
+
+    if (reader.failed() || !reader.atEnd())
+        return 0;
+    return snapshot.release();
+}
+
+} // namespace JSC
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HeapSnapshot_h
+#define HeapSnapshot_h
+
+#include <wtf/FastAllocBase.h>
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+    class Heap;
+    class JSCell;
+
+    // Remembers the allocation site of every interval'th cell allocated. Samples
+    // for cells that did not survive a collection are dropped as part of that
+    // collection, so a cell that is reused is never attributed to its old site.
+    class AllocationSiteSampler {
+        WTF_MAKE_NONCOPYABLE(AllocationSiteSampler); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        typedef HashMap<JSCell*, const void*> SampleMap;
+
+        AllocationSiteSampler(unsigned interval)
+            : m_interval(interval)
+            , m_countdown(interval)
+        {
+        }
+
+        bool shouldSample()
+        {
+            if (--m_countdown)
+                return false;
+            m_countdown = m_interval;
+            return true;
+        }
+
+        void add(JSCell* cell, const void* site) { m_samples.set(cell, site); }
+        void removeDeadSamples();
+
+        unsigned interval() const { return m_interval; }
+        const SampleMap& samples() const { return m_samples; }
+
+    private:
+        unsigned m_interval;
+        unsigned m_countdown;
+        SampleMap m_samples;
+    };
+
+    // Live object counts and sizes broken down by ClassInfo, by Structure and,
+    // if the heap is sampling allocation sites, by the code that allocated them.
+    // Sizes include out-of-line property storage but not other malloc'ed memory,
+    // such as string characters. A snapshot can be encoded into a compact binary
+    // form and decoded again, so that snapshots taken far apart in time can be
+    // diffed offline.
+    class HeapSnapshot {
+        WTF_MAKE_NONCOPYABLE(HeapSnapshot); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        struct ClassEntry {
+            CString className;
+            int64_t count;
+            int64_t bytes;
+        };
+
+        // Structure identifiers are addresses, so a Structure that dies may
+        // share its identifier with a later one.
+        struct StructureEntry {
+            uint64_t structureID;
+            CString className;
+            unsigned propertyStorageSize;
+            int64_t count;
+            int64_t bytes;
+        };
+
+        // Counts are estimates: the live samples multiplied by the sampling interval.
+        struct AllocationSiteEntry {
+            uint64_t site;
+            int64_t count;
+            int64_t bytes;
+        };
+
+        // Collects garbage first, so that only reachable objects are counted.
+        static PassOwnPtr<HeapSnapshot> take(Heap&);
+
+        // The change in every count between the two snapshots. Entries that did
+        // not change are left out.
+        static PassOwnPtr<HeapSnapshot> diff(const HeapSnapshot& from, const HeapSnapshot& to);
+
+        void encode(Vector<char>&) const;
+        // Returns 0 if the data is not a snapshot written by encode().
+        static PassOwnPtr<HeapSnapshot> decode(const char* data, size_t length);
+
+        int64_t objectCount() const { return m_objectCount; }
+        int64_t bytes() const { return m_bytes; }
+        unsigned samplingInterval() const { return m_samplingInterval; }
+
+        // Sorted by decreasing size.
+        const Vector<ClassEntry>& classes() const { return m_classes; }
+        const Vector<StructureEntry>& structures() const { return m_structures; }
+        const Vector<AllocationSiteEntry>& allocationSites() const { return m_allocationSites; }
+
+    private:
+        friend class HeapSnapshotBuilder;
+
+        HeapSnapshot();
+
+        void sortEntries();
+
+        int64_t m_objectCount;
+        int64_t m_bytes;
+        unsigned m_samplingInterval;
+        Vector<ClassEntry> m_classes;
+        Vector<StructureEntry> m_structures;
+        Vector<AllocationSiteEntry> m_allocationSites;
+    };
+
+} // namespace JSC
+
+#endif // HeapSnapshot_h
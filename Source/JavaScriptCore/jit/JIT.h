@@ -995,6 +995,10 @@ namespace JSC {
 #endif
         void* m_linkerOffset;
         static CodePtr stringGetByValStubGenerator(JSGlobalData* globalData, ExecutablePool* pool);
+#if ENABLE(JIT_OPTIMIZE_TYPED_ARRAY_ACCESS)
+        static CodePtr typedArrayGetByValStubGenerator(JSGlobalData* globalData, ExecutablePool* pool);
+        static CodePtr typedArrayPutByValStubGenerator(JSGlobalData* globalData, ExecutablePool* pool);
+#endif
     } JIT_CLASS_ALIGNMENT;
 
     inline void JIT::emit_op_loop(Instruction* currentInstruction)
@@ -1366,11 +1366,20 @@ void JIT::emitSlow_op_put_by_val(Instruction* currentInstruction, Vector<SlowCas
 
     linkSlowCase(iter); // property int32 check
     linkSlowCaseIfNotJSCell(iter, base); // base cell check
+#if ENABLE(JIT_OPTIMIZE_TYPED_ARRAY_ACCESS)
+    Jump nonCell = jump();
+#endif
     linkSlowCase(iter); // base not array check
+#if ENABLE(JIT_OPTIMIZE_TYPED_ARRAY_ACCESS)
+    emitGetVirtualRegister(value, regT3);
+    emitNakedCall(m_globalData->getCTIStub(typedArrayPutByValStubGenerator));
+    emitJumpSlowToHot(branchTestPtr(NonZero, regT0), OPCODE_LENGTH(op_put_by_val));
+    nonCell.link(this);
+#endif
     linkSlowCase(iter); // in vector check
 
     JITStubCall stubPutByValCall(this, cti_op_put_by_val);
-    stubPutByValCall.addArgument(regT0);
+    stubPutByValCall.addArgument(base, regT2);
     stubPutByValCall.addArgument(property, regT2);
     stubPutByValCall.addArgument(value, regT2);
     stubPutByValCall.call();
@@ -46,6 +46,10 @@
 #include <stdio.h>
 #endif
 
+#if ENABLE(JIT_OPTIMIZE_TYPED_ARRAY_ACCESS)
+#include <limits>
+#endif
+
 using namespace std;
 
 namespace JSC {
@@ -81,6 +85,182 @@ JIT::CodePtr JIT::stringGetByValStubGenerator(JSGlobalData* globalData, Executab
     return patchBuffer.finalizeCode().m_code;
 }
 
+#if ENABLE(JIT_OPTIMIZE_TYPED_ARRAY_ACCESS)
+// Boxing an arbitrary NaN read out of a float array could produce a value that looks like a
+// pointer, so NaNs are all replaced with this one.
+static const double typedArrayNaN = std::numeric_limits<double>::quiet_NaN();
+
+static MacroAssembler::Scale scaleForTypedArrayType(TypedArrayType type)
+{
+    switch (type) {
+    case TypedArrayInt8:
+    case TypedArrayUint8:
+        return MacroAssembler::TimesOne;
+    case TypedArrayInt16:
+    case TypedArrayUint16:
+        return MacroAssembler::TimesTwo;
+    case TypedArrayInt32:
+    case TypedArrayUint32:
+    case TypedArrayFloat32:
+        return MacroAssembler::TimesFour;
+    case TypedArrayFloat64:
+        return MacroAssembler::TimesEight;
+    default:
+        ASSERT_NOT_REACHED();
+        return MacroAssembler::TimesOne;
+    }
+}
+
+// Called from the get_by_val slow case with the base cell in regT0 and the index, already checked
+// to be an integer and zero extended, in regT1. Returns the element in regT0, or 0 if the base is
+// not a typed array or the index is out of bounds.
+JIT::CodePtr JIT::typedArrayGetByValStubGenerator(JSGlobalData* globalData, ExecutablePool* pool)
+{
+    JSInterfaceJIT jit;
+    JumpList failures;
+    jit.loadPtr(Address(regT0, JSCell::structureOffset()), regT2);
+    jit.loadPtr(Address(regT2, Structure::classInfoOffset()), regT2);
+
+    for (unsigned i = 0; i < NumberOfTypedArrayTypes; ++i) {
+        TypedArrayType type = static_cast<TypedArrayType>(i);
+        const TypedArrayDescriptor& descriptor = globalData->typedArrayDescriptor(type);
+        if (!descriptor.m_classInfo)
+            continue;
+
+        Jump notThisType = jit.branchPtr(NotEqual, regT2, TrustedImmPtr(descriptor.m_classInfo));
+        failures.append(jit.branch32(AboveOrEqual, regT1, Address(regT0, descriptor.m_lengthOffset)));
+        jit.loadPtr(Address(regT0, descriptor.m_storageOffset), regT2);
+        BaseIndex element(regT2, regT1, scaleForTypedArrayType(type));
+
+        switch (type) {
+        case TypedArrayInt8:
+            jit.load8Signed(element, regT0);
+            break;
+        case TypedArrayUint8:
+            jit.load8(element, regT0);
+            break;
+        case TypedArrayInt16:
+            jit.load16Signed(element, regT0);
+            break;
+        case TypedArrayUint16:
+            jit.load16(element, regT0);
+            break;
+        case TypedArrayInt32:
+            jit.load32(element, regT0);
+            break;
+        case TypedArrayUint32:
+            // Elements that don't fit in an int32 have to be boxed as doubles; leave those to the stub.
+            jit.load32(element, regT0);
+            failures.append(jit.branch32(LessThan, regT0, TrustedImm32(0)));
+            break;
+        case TypedArrayFloat32:
+            jit.loadFloat(element, fpRegT0);
+            jit.convertFloatToDouble(fpRegT0, fpRegT0);
+            break;
+        case TypedArrayFloat64:
+            jit.loadDouble(element, fpRegT0);
+            break;
+        default:
+            ASSERT_NOT_REACHED();
+        }
+
+        if (type == TypedArrayFloat32 || type == TypedArrayFloat64) {
+            Jump notNaN = jit.branchDouble(DoubleEqual, fpRegT0, fpRegT0);
+            jit.loadDouble(&typedArrayNaN, fpRegT0);
+            notNaN.link(&jit);
+            jit.moveDoubleToPtr(fpRegT0, regT0);
+            jit.subPtr(tagTypeNumberRegister, regT0);
+        } else
+            jit.orPtr(tagTypeNumberRegister, regT0);
+        jit.ret();
+
+        notThisType.link(&jit);
+    }
+
+    failures.link(&jit);
+    jit.move(TrustedImm32(0), regT0);
+    jit.ret();
+
+    LinkBuffer patchBuffer(&jit, pool, 0);
+    return patchBuffer.finalizeCode().m_code;
+}
+
+// Called from the put_by_val slow case with the base cell in regT0, the index in regT1 as for
+// get_by_val, and the value in regT3. Leaves regT0 non-zero if the element was stored; values
+// that aren't numbers or need a full ToInt32 conversion leave 0 in regT0 for the stub to handle.
+JIT::CodePtr JIT::typedArrayPutByValStubGenerator(JSGlobalData* globalData, ExecutablePool* pool)
+{
+    JSInterfaceJIT jit;
+    JumpList failures;
+    jit.loadPtr(Address(regT0, JSCell::structureOffset()), regT2);
+    jit.loadPtr(Address(regT2, Structure::classInfoOffset()), regT2);
+
+    for (unsigned i = 0; i < NumberOfTypedArrayTypes; ++i) {
+        TypedArrayType type = static_cast<TypedArrayType>(i);
+        const TypedArrayDescriptor& descriptor = globalData->typedArrayDescriptor(type);
+        if (!descriptor.m_classInfo)
+            continue;
+
+        Jump notThisType = jit.branchPtr(NotEqual, regT2, TrustedImmPtr(descriptor.m_classInfo));
+        failures.append(jit.branch32(AboveOrEqual, regT1, Address(regT0, descriptor.m_lengthOffset)));
+        jit.loadPtr(Address(regT0, descriptor.m_storageOffset), regT2);
+        BaseIndex element(regT2, regT1, scaleForTypedArrayType(type));
+
+        if (type == TypedArrayFloat32 || type == TypedArrayFloat64) {
+            Jump notInt = jit.branchPtr(Below, regT3, tagTypeNumberRegister);
+            jit.convertInt32ToDouble(regT3, fpRegT0);
+            Jump haveDouble = jit.jump();
+            notInt.link(&jit);
+            failures.append(jit.emitJumpIfNotImmediateNumber(regT3));
+            jit.addPtr(tagTypeNumberRegister, regT3);
+            jit.movePtrToDouble(regT3, fpRegT0);
+            haveDouble.link(&jit);
+
+            if (type == TypedArrayFloat32) {
+                jit.convertDoubleToFloat(fpRegT0, fpRegT0);
+                jit.storeFloat(fpRegT0, element);
+            } else
+                jit.storeDouble(fpRegT0, element);
+        } else {
+            Jump isInt = jit.branchPtr(AboveOrEqual, regT3, tagTypeNumberRegister);
+            failures.append(jit.emitJumpIfNotImmediateNumber(regT3));
+            jit.addPtr(tagTypeNumberRegister, regT3);
+            jit.movePtrToDouble(regT3, fpRegT0);
+            // NaN and doubles outside the int32 range need the full ToInt32 conversion.
+            failures.append(jit.branchTruncateDoubleToInt32(fpRegT0, regT3));
+            isInt.link(&jit);
+
+            switch (type) {
+            case TypedArrayInt8:
+            case TypedArrayUint8:
+                jit.store8(regT3, element);
+                break;
+            case TypedArrayInt16:
+            case TypedArrayUint16:
+                jit.store16(regT3, element);
+                break;
+            case TypedArrayInt32:
+            case TypedArrayUint32:
+                jit.store32(regT3, element);
+                break;
+            default:
+                ASSERT_NOT_REACHED();
+            }
+        }
+        jit.ret();
+
+        notThisType.link(&jit);
+    }
+
+    failures.link(&jit);
+    jit.move(TrustedImm32(0), regT0);
+    jit.ret();
+
+    LinkBuffer patchBuffer(&jit, pool, 0);
+    return patchBuffer.finalizeCode().m_code;
+}
+#endif
+
 void JIT::emit_op_get_by_val(Instruction* currentInstruction)
 {
     unsigned dst = currentInstruction[1].u.operand;
@@ -125,8 +305,15 @@ void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCas
     Jump failed = branchTestPtr(Zero, regT0);
     emitPutVirtualRegister(dst, regT0);
     emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_get_by_val));
-    failed.link(this);
     notString.link(this);
+#if ENABLE(JIT_OPTIMIZE_TYPED_ARRAY_ACCESS)
+    emitNakedCall(m_globalData->getCTIStub(typedArrayGetByValStubGenerator));
+    Jump notTypedArray = branchTestPtr(Zero, regT0);
+    emitPutVirtualRegister(dst, regT0);
+    emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_get_by_val));
+    notTypedArray.link(this);
+#endif
+    failed.link(this);
     nonCell.link(this);
     
     linkSlowCase(iter); // vector length check
@@ -26,6 +26,7 @@
 #include "Completion.h"
 #include "CurrentTime.h"
 #include "ExceptionHelpers.h"
+#include "HeapSnapshot.h"
 #include "InitializeThreading.h"
 #include "JSArray.h"
 #include "JSFunction.h"
@@ -74,6 +75,9 @@ static bool fillBufferWithContentsOfFile(const UString& fileName, Vector<char>&
 static EncodedJSValue JSC_HOST_CALL functionPrint(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionDebug(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionGC(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionHeapSnapshot(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionDiffHeapSnapshots(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionStartSamplingAllocationSites(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionVersion(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionRun(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionLoad(ExecState*);
@@ -154,6 +158,9 @@ GlobalObject::GlobalObject(JSGlobalData& globalData, const Vector<UString>& argu
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "print"), functionPrint));
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "quit"), functionQuit));
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "gc"), functionGC));
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "heapSnapshot"), functionHeapSnapshot));
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 2, Identifier(globalExec(), "diffHeapSnapshots"), functionDiffHeapSnapshots));
+    putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "startSamplingAllocationSites"), functionStartSamplingAllocationSites));
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "version"), functionVersion));
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "run"), functionRun));
     putDirectFunction(globalExec(), new (globalExec()) JSFunction(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "load"), functionLoad));
@@ -198,6 +205,80 @@ EncodedJSValue JSC_HOST_CALL functionGC(ExecState* exec)
     return JSValue::encode(jsUndefined());
 }
 
+// Writes a snapshot of the live heap to the given file, to be compared with a
+// later one by diffHeapSnapshots(). Returns the size of the live objects.
+// Only this shell exposes these. The browser runs pages on V8, so a hook in
+// WebCore's bindings would never reach JSC's heap.
+EncodedJSValue JSC_HOST_CALL functionHeapSnapshot(ExecState* exec)
+{
+    UString fileName = exec->argument(0).toString(exec);
+
+    OwnPtr<HeapSnapshot> snapshot;
+    {
+        JSLock lock(SilenceAssertionsOnly);
+        snapshot = HeapSnapshot::take(*exec->heap());
+    }
+    Vector<char> data;
+    snapshot->encode(data);
+
+    FILE* file = fopen(fileName.utf8().data(), "wb");
+    if (!file)
+        return JSValue::encode(throwError(exec, createError(exec, "Could not open file.")));
+    size_t written = fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+    if (written != data.size())
+        return JSValue::encode(throwError(exec, createError(exec, "Could not write file.")));
+
+    return JSValue::encode(jsNumber(static_cast<double>(snapshot->bytes())));
+}
+
+static PassOwnPtr<HeapSnapshot> readHeapSnapshot(const UString& fileName)
+{
+    FILE* file = fopen(fileName.utf8().data(), "rb");
+    if (!file)
+        return 0;
+    Vector<char> data;
+    char buffer[4096];
+    while (size_t length = fread(buffer, 1, sizeof(buffer), file))
+        data.append(buffer, length);
+    bool failed = ferror(file);
+    fclose(file);
+    if (failed)
+        return 0;
+    return HeapSnapshot::decode(data.data(), data.size());
+}
+
+// Prints what grew and shrank between two snapshots written by heapSnapshot().
+EncodedJSValue JSC_HOST_CALL functionDiffHeapSnapshots(ExecState* exec)
+{
+    OwnPtr<HeapSnapshot> from = readHeapSnapshot(exec->argument(0).toString(exec));
+    OwnPtr<HeapSnapshot> to = readHeapSnapshot(exec->argument(1).toString(exec));
+    if (!from || !to)
+        return JSValue::encode(throwError(exec, createError(exec, "Could not read heap snapshot.")));
+
+    OwnPtr<HeapSnapshot> diff = HeapSnapshot::diff(*from, *to);
+    printf("Objects: %+lld, bytes: %+lld\n", static_cast<long long>(diff->objectCount()), static_cast<long long>(diff->bytes()));
+    const Vector<HeapSnapshot::ClassEntry>& classes = diff->classes();
+    for (size_t i = 0; i < classes.size(); ++i)
+        printf("%s: %+lld objects, %+lld bytes\n", classes[i].className.data(), static_cast<long long>(classes[i].count), static_cast<long long>(classes[i].bytes));
+    const Vector<HeapSnapshot::AllocationSiteEntry>& sites = diff->allocationSites();
+    for (size_t i = 0; i < sites.size(); ++i)
+        printf("Allocated at 0x%llx: %+lld objects, %+lld bytes\n", static_cast<unsigned long long>(sites[i].site), static_cast<long long>(sites[i].count), static_cast<long long>(sites[i].bytes));
+    fflush(stdout);
+
+    return JSValue::encode(jsUndefined());
+}
+
+EncodedJSValue JSC_HOST_CALL functionStartSamplingAllocationSites(ExecState* exec)
+{
+    unsigned interval = exec->argument(0).toUInt32(exec);
+    if (interval)
+        exec->heap()->startSamplingAllocationSites(interval);
+    else
+        exec->heap()->stopSamplingAllocationSites();
+    return JSValue::encode(jsUndefined());
+}
+
 EncodedJSValue JSC_HOST_CALL functionVersion(ExecState*)
 {
     // We need this function for compatibility with the Mozilla JS tests but for now
@@ -72,6 +72,7 @@ class JSParser {
 public:
     JSParser(Lexer*, JSGlobalData*, FunctionParameters*, bool isStrictContext, bool isFunction, SourceProvider*);
     const char* parseProgram();
+    const char* checkProgramSyntax();
 private:
     struct AllowInOverride {
         AllowInOverride(JSParser* parser)
@@ -616,6 +617,12 @@ const char* jsParse(JSGlobalData* globalData, FunctionParameters* parameters, JS
     return parser.parseProgram();
 }
 
+const char* jsCheckSyntax(JSGlobalData* globalData, const SourceCode* source)
+{
+    JSParser parser(globalData->lexer, globalData, 0, false, false, source->provider());
+    return parser.checkProgramSyntax();
+}
+
 JSParser::JSParser(Lexer* lexer, JSGlobalData* globalData, FunctionParameters* parameters, bool inStrictContext, bool isFunction, SourceProvider* provider)
     : m_lexer(lexer)
     , m_stack(globalData->stack())
@@ -673,6 +680,19 @@ const char* JSParser::parseProgram()
     return 0;
 }
 
+const char* JSParser::checkProgramSyntax()
+{
+    unsigned oldFunctionCacheSize = m_functionCache ? m_functionCache->byteSize() : 0;
+    SyntaxChecker context(m_globalData, m_lexer);
+    if (!parseSourceElements<CheckForStrictMode>(context) || !consume(EOFTOK))
+        return m_errorMessage;
+
+    unsigned functionCacheSize = m_functionCache ? m_functionCache->byteSize() : 0;
+    if (functionCacheSize != oldFunctionCacheSize)
+        m_lexer->sourceProvider()->notifyCacheSizeChanged(functionCacheSize - oldFunctionCacheSize);
+    return 0;
+}
+
 bool JSParser::allowAutomaticSemicolon()
 {
     return match(CLOSEBRACE) || match(EOFTOK) || m_lexer->prevTerminator();
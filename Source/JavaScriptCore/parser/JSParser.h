@@ -160,5 +160,7 @@ enum JSParserStrictness { JSParseNormal, JSParseStrict };
 enum JSParserMode { JSParseProgramCode, JSParseFunctionCode };
 
 const char* jsParse(JSGlobalData*, FunctionParameters*, JSParserStrictness, JSParserMode, const SourceCode*);
+// Checks the syntax of program code without building a tree, filling the source provider's function cache.
+const char* jsCheckSyntax(JSGlobalData*, const SourceCode*);
 }
 #endif // JSParser_h
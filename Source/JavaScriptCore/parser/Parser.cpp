@@ -60,6 +60,21 @@ void Parser::parse(JSGlobalData* globalData, FunctionParameters* parameters, JSP
     }
 }
 
+bool Parser::preparse(JSGlobalData* globalData, const SourceCode& source)
+{
+    ASSERT(globalData);
+
+    Lexer& lexer = *globalData->lexer;
+    lexer.setCode(source, m_arena);
+
+    const char* parseError = jsCheckSyntax(globalData, &source);
+    bool lexError = lexer.sawError();
+    lexer.clear();
+    m_arena.reset();
+
+    return !parseError && !lexError;
+}
+
 void Parser::didFinishParsing(SourceElements* sourceElements, ParserArenaData<DeclarationStacks::VarStack>* varStack, 
                               ParserArenaData<DeclarationStacks::FunctionStack>* funcStack, CodeFeatures features, int lastLine, int numConstants, IdentifierSet& capturedVars)
 {
@@ -52,6 +52,11 @@ namespace JSC {
         template <class ParsedNode>
         PassRefPtr<ParsedNode> parse(JSGlobalObject* lexicalGlobalObject, Debugger*, ExecState*, const SourceCode& source, FunctionParameters*, JSParserStrictness strictness, JSObject** exception);
 
+        // Checks the syntax of program code and fills the source provider's function cache,
+        // without building a tree. Does not touch the heap, so it may run on any thread that
+        // owns the given JSGlobalData.
+        bool preparse(JSGlobalData*, const SourceCode&);
+
         void didFinishParsing(SourceElements*, ParserArenaData<DeclarationStacks::VarStack>*, 
                               ParserArenaData<DeclarationStacks::FunctionStack>*, CodeFeatures features,
                               int lastLine, int numConstants, IdentifierSet&);
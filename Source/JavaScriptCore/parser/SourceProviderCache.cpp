@@ -26,6 +26,7 @@
 #include "config.h"
 #include "SourceProviderCache.h"
 
+#include "Identifier.h"
 #include "SourceProviderCacheItem.h"
 
 namespace JSC {
@@ -47,6 +48,49 @@ unsigned SourceProviderCache::byteSize() const
     return m_contentByteSize + sizeof(*this) + m_map.capacity() * sizeof(SourceProviderCacheItem*);
 }
 
+static void detachIdentifiers(Vector<RefPtr<StringImpl> >& identifiers)
+{
+    // An identifier removes itself from the current thread's identifier table when it
+    // is destroyed, so it must not be released on any thread but the one that created it.
+    size_t size = identifiers.size();
+    for (size_t i = 0; i < size; ++i)
+        identifiers[i] = StringImpl::create(identifiers[i]->characters(), identifiers[i]->length());
+}
+
+static void internIdentifiers(JSGlobalData* globalData, Vector<RefPtr<StringImpl> >& identifiers)
+{
+    size_t size = identifiers.size();
+    for (size_t i = 0; i < size; ++i)
+        identifiers[i] = Identifier(globalData, identifiers[i].get()).impl();
+}
+
+void SourceProviderCache::detachFromIdentifierTable()
+{
+    HashMap<int, SourceProviderCacheItem*>::iterator end = m_map.end();
+    for (HashMap<int, SourceProviderCacheItem*>::iterator it = m_map.begin(); it != end; ++it) {
+        detachIdentifiers(it->second->usedVariables);
+        detachIdentifiers(it->second->writtenVariables);
+    }
+}
+
+void SourceProviderCache::adoptDetachedItems(JSGlobalData* globalData, SourceProviderCache& other)
+{
+    HashMap<int, SourceProviderCacheItem*>::iterator end = other.m_map.end();
+    for (HashMap<int, SourceProviderCacheItem*>::iterator it = other.m_map.begin(); it != end; ++it) {
+        SourceProviderCacheItem* item = it->second;
+        if (m_map.contains(it->first)) {
+            delete item;
+            continue;
+        }
+        internIdentifiers(globalData, item->usedVariables);
+        internIdentifiers(globalData, item->writtenVariables);
+        m_map.add(it->first, item);
+        m_contentByteSize += item->approximateByteSize();
+    }
+    other.m_map.clear();
+    other.m_contentByteSize = 0;
+}
+
 void SourceProviderCache::add(int sourcePosition, PassOwnPtr<SourceProviderCacheItem> item, unsigned size)
 {
     m_map.add(sourcePosition, item.leakPtr());
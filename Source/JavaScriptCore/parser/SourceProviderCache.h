@@ -28,6 +28,7 @@
 
 namespace JSC {
 
+class JSGlobalData;
 class SourceProviderCacheItem;
 
 class SourceProviderCache {
@@ -40,6 +41,13 @@ public:
     void add(int sourcePosition, PassOwnPtr<SourceProviderCacheItem>, unsigned size);
     const SourceProviderCacheItem* get(int sourcePosition) const { return m_map.get(sourcePosition); }
 
+    // Items hold identifiers that belong to the identifier table of the thread that
+    // parsed the source. A cache filled on a background thread must be detached from
+    // that table before being handed over, and the receiving thread then adopts its
+    // items, re-interning their identifiers in its own table.
+    void detachFromIdentifierTable();
+    void adoptDetachedItems(JSGlobalData*, SourceProviderCache&);
+
 private:
     HashMap<int, SourceProviderCacheItem*> m_map;
     unsigned m_contentByteSize;
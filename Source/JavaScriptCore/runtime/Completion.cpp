@@ -75,4 +75,10 @@ Completion evaluate(ExecState* exec, ScopeChainNode* scopeChain, const SourceCod
     return Completion(Normal, result);
 }
 
+bool preparse(JSGlobalData* globalData, const SourceCode& source)
+{
+    ASSERT(globalData->identifierTable == wtfThreadData().currentIdentifierTable());
+    return globalData->parser->preparse(globalData, source);
+}
+
 } // namespace JSC
@@ -28,6 +28,7 @@
 namespace JSC {
 
     class ExecState;
+    class JSGlobalData;
     class ScopeChainNode;
     class SourceCode;
 
@@ -58,6 +59,10 @@ namespace JSC {
     Completion checkSyntax(ExecState*, const SourceCode&);
     Completion evaluate(ExecState*, ScopeChainNode*, const SourceCode&, JSValue thisValue = JSValue());
 
+    // Syntax checks the program without executing it and records the extent of its
+    // functions in the source provider's cache, so that a later parse can skip them.
+    bool preparse(JSGlobalData*, const SourceCode&);
+
 } // namespace JSC
 
 #endif // Completion_h
@@ -391,10 +391,12 @@ namespace JSC {
         m_operationInProgress = Allocation;
         void* result = m_markedSpace.allocate(bytes);
         m_operationInProgress = NoOperation;
-        if (result)
-            return result;
+        if (!result)
+            result = allocateSlowCase(bytes);
 
-        return allocateSlowCase(bytes);
+        if (UNLIKELY(!!m_allocationSiteSampler))
+            sampleAllocation(result);
+        return result;
     }
 
     inline void* JSCell::operator new(size_t size, JSGlobalData* globalData)
@@ -74,6 +74,7 @@ namespace JSC {
     class RegExp;
 #endif
 
+    struct ClassInfo;
     struct HashTable;
     struct Instruction;
 
@@ -102,6 +103,41 @@ namespace JSC {
         ThreadStackTypeSmall
     };
 
+    enum TypedArrayType {
+        TypedArrayInt8,
+        TypedArrayUint8,
+        TypedArrayInt16,
+        TypedArrayUint16,
+        TypedArrayInt32,
+        TypedArrayUint32,
+        TypedArrayFloat32,
+        TypedArrayFloat64,
+        NumberOfTypedArrayTypes
+    };
+
+    // Typed arrays are implemented by the embedder, which describes where the wrapper
+    // object for each kind of array keeps its element storage pointer and length. This
+    // lets compiled code read and write elements without calling out.
+    struct TypedArrayDescriptor {
+        TypedArrayDescriptor()
+            : m_classInfo(0)
+            , m_storageOffset(0)
+            , m_lengthOffset(0)
+        {
+        }
+
+        TypedArrayDescriptor(const ClassInfo* classInfo, size_t storageOffset, size_t lengthOffset)
+            : m_classInfo(classInfo)
+            , m_storageOffset(storageOffset)
+            , m_lengthOffset(lengthOffset)
+        {
+        }
+
+        const ClassInfo* m_classInfo;
+        size_t m_storageOffset;
+        size_t m_lengthOffset;
+    };
+
     class JSGlobalData : public RefCounted<JSGlobalData> {
     public:
         // WebCore has a one-to-one mapping of threads to JSGlobalDatas;
@@ -269,6 +305,14 @@ namespace JSC {
         HandleSlot allocateLocalHandle() { return heap.allocateLocalHandle(); }
         void clearBuiltinStructures();
 
+        // Descriptors are read when code is compiled, so they need to be registered
+        // before any script runs.
+        void registerTypedArrayDescriptor(TypedArrayType type, const TypedArrayDescriptor& descriptor)
+        {
+            m_typedArrayDescriptors[type] = descriptor;
+        }
+        const TypedArrayDescriptor& typedArrayDescriptor(TypedArrayType type) const { return m_typedArrayDescriptors[type]; }
+
     private:
         JSGlobalData(GlobalDataType, ThreadStackType);
         static JSGlobalData*& sharedInstanceInternal();
@@ -277,6 +321,7 @@ namespace JSC {
         bool m_canUseJIT;
 #endif
         StackBounds m_stack;
+        TypedArrayDescriptor m_typedArrayDescriptors[NumberOfTypedArrayTypes];
     };
 
     inline HandleSlot allocateGlobalHandle(JSGlobalData& globalData)
@@ -33,6 +33,7 @@
 namespace JSC {
     
 static const unsigned substringFromRopeCutoff = 4;
+static const unsigned maxPatternLengthForRopeSearch = 32;
 
 // Overview: this methods converts a JSString from holding a string in rope form
 // down to a simple UString representation.  It does so by building up the string
@@ -66,6 +67,31 @@ void JSString::resolveRope(ExecState* exec) const
     }
     UChar* position = buffer + m_length;
 
+    // Most ropes are just the two or three strings that were concatenated; copy those
+    // straight across without going through the work queue.
+    bool hasNestedRopes = false;
+    for (unsigned i = 0; i < m_fiberCount; ++i) {
+        if (RopeImpl::isRope(m_other.m_fibers[i])) {
+            hasNestedRopes = true;
+            break;
+        }
+    }
+    if (!hasNestedRopes) {
+        position = buffer;
+        for (unsigned i = 0; i < m_fiberCount; ++i) {
+            StringImpl* string = static_cast<StringImpl*>(m_other.m_fibers[i]);
+            unsigned length = string->length();
+            StringImpl::copyChars(position, string->characters(), length);
+            position += length;
+            string->deref();
+            m_other.m_fibers[i] = 0;
+        }
+        ASSERT(position == buffer + m_length);
+        m_fiberCount = 0;
+        ASSERT(!isRope());
+        return;
+    }
+
     // Start with the current RopeImpl.
     Vector<RopeImpl::Fiber, 32> workQueue;
     RopeImpl::Fiber currentFiber;
@@ -108,6 +134,149 @@ void JSString::resolveRope(ExecState* exec) const
     }
 }
     
+// Descends through the rope to the string fiber holding the character at 'index', skipping over
+// whole sub-ropes that end before it, so the cost depends on the depth of the rope rather than on
+// the number of fibers in it. On return 'index' is relative to the start of the returned fiber.
+static StringImpl* fiberContainingIndex(RopeImpl::Fiber* fibers, unsigned fiberCount, unsigned& index)
+{
+    while (true) {
+        RopeImpl::Fiber fiber = 0;
+        for (unsigned i = 0; i < fiberCount; ++i) {
+            fiber = fibers[i];
+            unsigned length = fiber->length();
+            if (index < length)
+                break;
+            index -= length;
+        }
+        ASSERT(fiber && index < fiber->length());
+        if (!RopeImpl::isRope(fiber))
+            return static_cast<StringImpl*>(fiber);
+        RopeImpl* rope = static_cast<RopeImpl*>(fiber);
+        fibers = rope->fibers();
+        fiberCount = rope->fiberCount();
+    }
+}
+
+UChar JSString::characterAtInRope(unsigned index)
+{
+    ASSERT(isRope());
+    ASSERT(index < m_length);
+    StringImpl* fiber = fiberContainingIndex(m_other.m_fibers.data(), m_fiberCount, index);
+    return fiber->characters()[index];
+}
+
+// Returns true if 'pattern' occurs in the run of fibers beginning at fibers[fiberIndex], starting
+// 'offset' characters into that fiber. Used for matches that straddle a fiber boundary.
+static bool matchesAcrossFibers(const Vector<StringImpl*, 32>& fibers, size_t fiberIndex, unsigned offset, const UChar* pattern, unsigned patternLength)
+{
+    for (unsigned i = 0; i < patternLength; ++i) {
+        while (offset == fibers[fiberIndex]->length()) {
+            if (++fiberIndex == fibers.size())
+                return false;
+            offset = 0;
+        }
+        if (fibers[fiberIndex]->characters()[offset++] != pattern[i])
+            return false;
+    }
+    return true;
+}
+
+// Searching each fiber in place is much cheaper than flattening when the rope is searched
+// once and then dropped, as happens when script builds up a string and then scans it with
+// indexOf(). Matches straddling a fiber boundary are checked character by character, which
+// is quadratic in the pattern length, so long patterns resolve the rope instead.
+size_t JSString::findInRope(ExecState* exec, const UString& pattern, unsigned start)
+{
+    ASSERT(isRope());
+    ASSERT(start <= m_length);
+
+    unsigned patternLength = pattern.length();
+    if (patternLength > maxPatternLengthForRopeSearch) {
+        resolveRope(exec);
+        return m_value.find(pattern, start);
+    }
+    if (!patternLength)
+        return start;
+    if (patternLength > m_length - start)
+        return notFound;
+
+    Vector<StringImpl*, 32> fibers;
+    appendFibers(fibers);
+
+    const UChar* patternCharacters = pattern.characters();
+    unsigned fiberStart = 0;
+    for (size_t i = 0; i < fibers.size(); ++i) {
+        StringImpl* fiber = fibers[i];
+        unsigned fiberLength = fiber->length();
+        unsigned fiberEnd = fiberStart + fiberLength;
+        if (fiberEnd <= start) {
+            fiberStart = fiberEnd;
+            continue;
+        }
+
+        // Any match lying wholly inside this fiber comes before one that starts here but runs on into the next.
+        unsigned searchStart = start > fiberStart ? start - fiberStart : 0;
+        size_t position = fiber->find(pattern.impl(), searchStart);
+        if (position != notFound)
+            return fiberStart + position;
+
+        unsigned straddleStart = fiberLength >= patternLength ? fiberLength - patternLength + 1 : 0;
+        for (unsigned offset = std::max(straddleStart, searchStart); offset < fiberLength; ++offset) {
+            if (matchesAcrossFibers(fibers, i, offset, patternCharacters, patternLength))
+                return fiberStart + offset;
+        }
+        fiberStart = fiberEnd;
+    }
+    return notFound;
+}
+
+void JSString::appendFibers(Vector<StringImpl*, 32>& fibers)
+{
+    if (!isRope()) {
+        fibers.append(m_value.impl());
+        return;
+    }
+    RopeIterator end;
+    for (RopeIterator it(m_other.m_fibers.data(), m_fiberCount); it != end; ++it)
+        fibers.append(*it);
+}
+
+// Compares two strings of the same length a run of characters at a time, where a run ends at
+// whichever of the two strings next crosses a fiber boundary.
+bool JSString::equalSlowCase(JSString* s1, JSString* s2)
+{
+    ASSERT(s1->m_length == s2->m_length);
+    ASSERT(s1->isRope() || s2->isRope());
+
+    Vector<StringImpl*, 32> fibers1;
+    Vector<StringImpl*, 32> fibers2;
+    s1->appendFibers(fibers1);
+    s2->appendFibers(fibers2);
+
+    size_t index1 = 0;
+    size_t index2 = 0;
+    unsigned offset1 = 0;
+    unsigned offset2 = 0;
+    unsigned remaining = s1->m_length;
+    while (remaining) {
+        while (offset1 == fibers1[index1]->length()) {
+            ++index1;
+            offset1 = 0;
+        }
+        while (offset2 == fibers2[index2]->length()) {
+            ++index2;
+            offset2 = 0;
+        }
+        unsigned runLength = std::min(fibers1[index1]->length() - offset1, fibers2[index2]->length() - offset2);
+        if (memcmp(fibers1[index1]->characters() + offset1, fibers2[index2]->characters() + offset2, runLength * sizeof(UChar)))
+            return false;
+        offset1 += runLength;
+        offset2 += runLength;
+        remaining -= runLength;
+    }
+    return true;
+}
+
 // This function construsts a substring out of a rope without flattening by reusing the existing fibers.
 // This can reduce memory usage substantially. Since traversing ropes is slow the function will revert 
 // back to flattening if the rope turns out to be long.
@@ -118,6 +287,16 @@ JSString* JSString::substringFromRope(ExecState* exec, unsigned substringStart,
     
     JSGlobalData* globalData = &exec->globalData();
 
+    // Substrings lying inside a single fiber are the common case and need no walk over the
+    // fibers that precede them.
+    unsigned offsetInFiber = substringStart;
+    StringImpl* firstFiber = fiberContainingIndex(m_other.m_fibers.data(), m_fiberCount, offsetInFiber);
+    if (offsetInFiber + substringLength <= firstFiber->length()) {
+        if (!offsetInFiber && substringLength == firstFiber->length())
+            return jsString(globalData, UString(firstFiber));
+        return jsSubstring(globalData, UString(firstFiber), offsetInFiber, substringLength);
+    }
+
     UString substringFibers[3];
     
     unsigned fiberCount = 0;
@@ -217,13 +396,10 @@ JSValue JSString::replaceCharacter(ExecState* exec, UChar character, const UStri
 JSString* JSString::getIndexSlowCase(ExecState* exec, unsigned i)
 {
     ASSERT(isRope());
-    resolveRope(exec);
-    // Return a safe no-value result, this should never be used, since the excetion will be thrown.
-    if (exec->exception())
-        return jsString(exec, "");
-    ASSERT(!isRope());
-    ASSERT(i < m_value.length());
-    return jsSingleCharacterSubstring(exec, m_value, i);
+    // Pick the character out of its fiber rather than flattening the whole rope to read it.
+    unsigned offsetInFiber = i;
+    StringImpl* fiber = fiberContainingIndex(m_other.m_fibers.data(), m_fiberCount, offsetInFiber);
+    return jsSingleCharacterSubstring(exec, UString(fiber), offsetInFiber);
 }
 
 JSValue JSString::toPrimitive(ExecState*, PreferredPrimitiveType) const
@@ -347,6 +347,31 @@ namespace JSC {
         JSString* getIndex(ExecState*, unsigned);
         JSString* getIndexSlowCase(ExecState*, unsigned);
 
+        // These work on ropes without resolving them.
+        UChar characterAt(unsigned i)
+        {
+            ASSERT(i < m_length);
+            if (isRope())
+                return characterAtInRope(i);
+            return m_value.characters()[i];
+        }
+        size_t find(ExecState* exec, const UString& pattern, unsigned start)
+        {
+            if (isRope())
+                return findInRope(exec, pattern, start);
+            return m_value.find(pattern, start);
+        }
+        static bool equal(JSString* s1, JSString* s2)
+        {
+            if (s1 == s2)
+                return true;
+            if (s1->m_length != s2->m_length)
+                return false;
+            if (!s1->isRope() && !s2->isRope())
+                return s1->m_value == s2->m_value;
+            return equalSlowCase(s1, s2);
+        }
+
         JSValue replaceCharacter(ExecState*, UChar, const UString& replacement);
 
         static Structure* createStructure(JSGlobalData& globalData, JSValue proto) { return Structure::create(globalData, proto, TypeInfo(StringType, OverridesGetOwnPropertySlot | NeedsThisConversion), AnonymousSlotCount, 0); }
@@ -360,6 +385,10 @@ namespace JSC {
 
         void resolveRope(ExecState*) const;
         JSString* substringFromRope(ExecState*, unsigned offset, unsigned length);
+        UChar characterAtInRope(unsigned);
+        size_t findInRope(ExecState*, const UString& pattern, unsigned start);
+        static bool equalSlowCase(JSString*, JSString*);
+        void appendFibers(Vector<StringImpl*, 32>&);
 
         void appendStringInConstruct(unsigned& index, const UString& string)
         {
@@ -179,8 +179,8 @@ public:
     // Copy this PropertyTable, ensuring the copy has at least the capacity provided.
     PassOwnPtr<PropertyTable> copy(JSGlobalData&, JSCell* owner, unsigned newCapacity);
 
-#ifndef NDEBUG
     size_t sizeInMemory();
+#ifndef NDEBUG
     void checkConsistency();
 #endif
 
@@ -459,7 +459,6 @@ inline PassOwnPtr<PropertyTable> PropertyTable::copy(JSGlobalData& globalData, J
     return new PropertyTable(globalData, owner, newCapacity, *this);
 }
 
-#ifndef NDEBUG
 inline size_t PropertyTable::sizeInMemory()
 {
     size_t result = sizeof(PropertyTable) + dataSize();
@@ -467,7 +466,6 @@ inline size_t PropertyTable::sizeInMemory()
         result += (m_deletedOffsets->capacity() * sizeof(unsigned));
     return result;
 }
-#endif
 
 inline void PropertyTable::reinsert(const ValueType& entry)
 {
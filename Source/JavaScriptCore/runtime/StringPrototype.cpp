@@ -481,23 +481,36 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncToString(ExecState* exec)
     return throwVMTypeError(exec);
 }
 
+// Converts the position argument of charAt() and charCodeAt(), returning false if it is out of range.
+static inline bool characterIndex(ExecState* exec, JSValue position, unsigned length, unsigned& index)
+{
+    if (position.isUInt32()) {
+        index = position.asUInt32();
+        return index < length;
+    }
+    double dpos = position.toInteger(exec);
+    if (!(dpos >= 0 && dpos < length))
+        return false;
+    index = static_cast<unsigned>(dpos);
+    return true;
+}
+
 EncodedJSValue JSC_HOST_CALL stringProtoFuncCharAt(ExecState* exec)
 {
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
-    UString s = thisValue.toThisString(exec);
-    unsigned len = s.length();
-    JSValue a0 = exec->argument(0);
-    if (a0.isUInt32()) {
-        uint32_t i = a0.asUInt32();
-        if (i < len)
-            return JSValue::encode(jsSingleCharacterSubstring(exec, s, i));
+    unsigned i;
+    if (thisValue.isString()) {
+        // Don't resolve a rope just to read one character out of it.
+        JSString* jsString = asString(thisValue);
+        if (characterIndex(exec, exec->argument(0), jsString->length(), i))
+            return JSValue::encode(jsString->getIndex(exec, i));
         return JSValue::encode(jsEmptyString(exec));
     }
-    double dpos = a0.toInteger(exec);
-    if (dpos >= 0 && dpos < len)
-        return JSValue::encode(jsSingleCharacterSubstring(exec, s, static_cast<unsigned>(dpos)));
+    UString s = thisValue.toThisString(exec);
+    if (characterIndex(exec, exec->argument(0), s.length(), i))
+        return JSValue::encode(jsSingleCharacterSubstring(exec, s, i));
     return JSValue::encode(jsEmptyString(exec));
 }
 
@@ -506,18 +519,16 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncCharCodeAt(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
-    UString s = thisValue.toThisString(exec);
-    unsigned len = s.length();
-    JSValue a0 = exec->argument(0);
-    if (a0.isUInt32()) {
-        uint32_t i = a0.asUInt32();
-        if (i < len)
-            return JSValue::encode(jsNumber(s.characters()[i]));
+    unsigned i;
+    if (thisValue.isString()) {
+        JSString* jsString = asString(thisValue);
+        if (characterIndex(exec, exec->argument(0), jsString->length(), i))
+            return JSValue::encode(jsNumber(jsString->characterAt(i)));
         return JSValue::encode(jsNaN());
     }
-    double dpos = a0.toInteger(exec);
-    if (dpos >= 0 && dpos < len)
-        return JSValue::encode(jsNumber(s[static_cast<int>(dpos)]));
+    UString s = thisValue.toThisString(exec);
+    if (characterIndex(exec, exec->argument(0), s.length(), i))
+        return JSValue::encode(jsNumber(s.characters()[i]));
     return JSValue::encode(jsNaN());
 }
 
@@ -540,8 +551,17 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncIndexOf(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
-    UString s = thisValue.toThisString(exec);
-    int len = s.length();
+    // Ropes are searched fiber by fiber rather than resolved.
+    JSString* jsString = 0;
+    UString s;
+    int len;
+    if (thisValue.isString()) {
+        jsString = asString(thisValue);
+        len = jsString->length();
+    } else {
+        s = thisValue.toThisString(exec);
+        len = s.length();
+    }
 
     JSValue a0 = exec->argument(0);
     JSValue a1 = exec->argument(1);
@@ -560,7 +580,7 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncIndexOf(ExecState* exec)
         pos = static_cast<int>(dpos);
     }
 
-    size_t result = s.find(u2, pos);
+    size_t result = jsString ? jsString->find(exec, u2, pos) : s.find(u2, pos);
     if (result == notFound)
         return JSValue::encode(jsNumber(-1));
     return JSValue::encode(jsNumber(result));
@@ -63,6 +63,8 @@ namespace JSC {
 
 #if DUMP_STRUCTURE_ID_STATISTICS
 static HashSet<Structure*>& liveStructureSet = *(new HashSet<Structure*>);
+static unsigned numberOfDiscardedPropertyMaps;
+static size_t totalDiscardedPropertyMapsSize;
 #endif
 
 bool StructureTransitionTable::contains(StringImpl* rep, unsigned attributes) const
@@ -136,7 +138,9 @@ void Structure::dumpStatistics()
     unsigned numberUsingSingleSlot = 0;
     unsigned numberSingletons = 0;
     unsigned numberWithPropertyMaps = 0;
-    unsigned totalPropertyMapsSize = 0;
+    unsigned numberWithDiscardablePropertyMaps = 0;
+    size_t totalPropertyMapsSize = 0;
+    size_t totalDiscardablePropertyMapsSize = 0;
 
     HashSet<Structure*>::const_iterator end = liveStructureSet.end();
     for (HashSet<Structure*>::const_iterator it = liveStructureSet.begin(); it != end; ++it) {
@@ -155,20 +159,32 @@ void Structure::dumpStatistics()
         }
 
         if (structure->m_propertyTable) {
+            size_t propertyMapSize = structure->m_propertyTable->sizeInMemory();
             ++numberWithPropertyMaps;
-            totalPropertyMapsSize += structure->m_propertyTable->sizeInMemory();
+            totalPropertyMapsSize += propertyMapSize;
+            if (structure->canDiscardPropertyTable()) {
+                ++numberWithDiscardablePropertyMaps;
+                totalDiscardablePropertyMapsSize += propertyMapSize;
+            }
         }
     }
 
-    printf("Number of live Structures: %d\n", liveStructureSet.size());
-    printf("Number of Structures using the single item optimization for transition map: %d\n", numberUsingSingleSlot);
-    printf("Number of Structures that are leaf nodes: %d\n", numberLeaf);
-    printf("Number of Structures that singletons: %d\n", numberSingletons);
-    printf("Number of Structures with PropertyMaps: %d\n", numberWithPropertyMaps);
-
-    printf("Size of a single Structures: %d\n", static_cast<unsigned>(sizeof(Structure)));
-    printf("Size of sum of all property maps: %d\n", totalPropertyMapsSize);
-    printf("Size of average of all property maps: %f\n", static_cast<double>(totalPropertyMapsSize) / static_cast<double>(liveStructureSet.size()));
+    unsigned numberOfStructures = liveStructureSet.size();
+    printf("Number of live Structures: %u\n", numberOfStructures);
+    printf("Number of Structures using the single item optimization for transition map: %u\n", numberUsingSingleSlot);
+    printf("Number of Structures that are leaf nodes: %u\n", numberLeaf);
+    printf("Number of Structures that singletons: %u\n", numberSingletons);
+    printf("Number of Structures with PropertyMaps: %u\n", numberWithPropertyMaps);
+
+    printf("Size of a single Structures: %u\n", static_cast<unsigned>(sizeof(Structure)));
+    printf("Size of sum of all property maps: %u\n", static_cast<unsigned>(totalPropertyMapsSize));
+    printf("Size of average of all property maps: %f\n", static_cast<double>(totalPropertyMapsSize) / static_cast<double>(numberOfStructures));
+    printf("Size of average Structure including its property map: %f\n", static_cast<double>(numberOfStructures * sizeof(Structure) + totalPropertyMapsSize) / static_cast<double>(numberOfStructures));
+    printf("Number of PropertyMaps the next collection can discard: %u\n", numberWithDiscardablePropertyMaps);
+    printf("Size of sum of discardable property maps: %u\n", static_cast<unsigned>(totalDiscardablePropertyMapsSize));
+    printf("Number of PropertyMaps discarded by the collector: %u\n", numberOfDiscardedPropertyMaps);
+    printf("Size of sum of discarded property maps: %u\n", static_cast<unsigned>(totalDiscardedPropertyMapsSize));
+    printf("Size of average discarded property map: %f\n", numberOfDiscardedPropertyMaps ? static_cast<double>(totalDiscardedPropertyMapsSize) / numberOfDiscardedPropertyMaps : 0.0);
 #else
     printf("Dumping Structure statistics is not enabled.\n");
 #endif
@@ -192,6 +208,10 @@ Structure::Structure(JSGlobalData& globalData, JSValue prototype, const TypeInfo
 {
     ASSERT(m_prototype);
     ASSERT(m_prototype.isObject() || m_prototype.isNull());
+
+#if DUMP_STRUCTURE_ID_STATISTICS
+    liveStructureSet.add(this);
+#endif
 }
 
 const ClassInfo Structure::s_info = { "Structure", 0, 0, 0 };
@@ -215,6 +235,10 @@ Structure::Structure(JSGlobalData& globalData)
     ASSERT(m_prototype);
     ASSERT(m_prototype.isNull());
     ASSERT(!globalData.structureStructure);
+
+#if DUMP_STRUCTURE_ID_STATISTICS
+    liveStructureSet.add(this);
+#endif
 }
 
 Structure::Structure(JSGlobalData& globalData, const Structure* previous)
@@ -235,38 +259,41 @@ Structure::Structure(JSGlobalData& globalData, const Structure* previous)
 {
     ASSERT(m_prototype);
     ASSERT(m_prototype.isObject() || m_prototype.isNull());
+
+#if DUMP_STRUCTURE_ID_STATISTICS
+    liveStructureSet.add(this);
+#endif
 }
 
 Structure::~Structure()
 {
+#if DUMP_STRUCTURE_ID_STATISTICS
+    liveStructureSet.remove(this);
+#endif
 }
 
 void Structure::materializePropertyMap(JSGlobalData& globalData)
 {
     ASSERT(!m_propertyTable);
+    ASSERT(m_previous);
 
     Vector<Structure*, 8> structures;
-    structures.append(this);
-
     Structure* structure = this;
 
-    // Search for the last Structure with a property table.
-    while ((structure = structure->previousID())) {
-        if (structure->m_isPinnedPropertyTable) {
-            ASSERT(structure->m_propertyTable);
-            ASSERT(!structure->m_previous);
-
-            m_propertyTable = structure->m_propertyTable->copy(globalData, 0, m_offset + 1);
-            break;
-        }
-
+    // Search for the nearest Structure with a property table, stopping at the
+    // root of the transition chain. Tables discarded by the collector from
+    // structures in the middle of the chain are skipped over.
+    do {
         structures.append(structure);
-    }
+        structure = structure->previousID();
+    } while (structure->m_previous && !structure->m_propertyTable);
 
-    if (!m_propertyTable)
+    if (structure->m_propertyTable)
+        m_propertyTable = structure->m_propertyTable->copy(globalData, this, m_offset + 1);
+    else
         createPropertyMap(m_offset + 1);
 
-    for (ptrdiff_t i = structures.size() - 2; i >= 0; --i) {
+    for (ptrdiff_t i = structures.size() - 1; i >= 0; --i) {
         structure = structures[i];
         PropertyMapEntry entry(globalData, this, structure->m_nameInPrevious.get(), m_anonymousSlotCount + structure->m_offset, structure->m_attributesInPrevious, structure->m_specificValueInPrevious.get());
         m_propertyTable->add(entry);
@@ -778,6 +805,13 @@ void Structure::markChildren(MarkStack& markStack)
         markStack.append(&m_specificValueInPrevious);
     if (m_enumerationCache)
         markStack.append(&m_enumerationCache);
+    if (m_propertyTable && canDiscardPropertyTable()) {
+#if DUMP_STRUCTURE_ID_STATISTICS
+        ++numberOfDiscardedPropertyMaps;
+        totalDiscardedPropertyMapsSize += m_propertyTable->sizeInMemory();
+#endif
+        m_propertyTable.clear();
+    }
     if (m_propertyTable) {
         PropertyTable::iterator end = m_propertyTable->end();
         for (PropertyTable::iterator ptr = m_propertyTable->begin(); ptr != end; ++ptr) {
@@ -140,6 +140,11 @@ namespace JSC {
             return OBJECT_OFFSETOF(Structure, m_prototype);
         }
 
+        static ptrdiff_t classInfoOffset()
+        {
+            return OBJECT_OFFSETOF(Structure, m_classInfo);
+        }
+
         static ptrdiff_t typeInfoFlagsOffset()
         {
             return OBJECT_OFFSETOF(Structure, m_typeInfo) + TypeInfo::flagsOffset();
@@ -193,6 +198,14 @@ namespace JSC {
                 materializePropertyMap(globalData);
         }
 
+        // A structure that has transitioned away gave its property table to the
+        // transition; any table it has now was rebuilt by a lookup and can be
+        // rebuilt again from the transition chain.
+        bool canDiscardPropertyTable() const
+        {
+            return m_previous && !m_isPinnedPropertyTable && !m_transitionTable.isEmpty();
+        }
+
         signed char transitionCount() const
         {
             // Since the number of transitions is always the same as m_offset, we keep the size of Structure down by not storing both.
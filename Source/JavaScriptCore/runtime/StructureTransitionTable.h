@@ -104,6 +104,20 @@ public:
     inline bool contains(StringImpl* rep, unsigned attributes) const;
     inline Structure* get(StringImpl* rep, unsigned attributes) const;
 
+    bool isEmpty() const
+    {
+        if (isUsingSingleSlot())
+            return !singleTransition();
+        return map()->isEmpty();
+    }
+
+    size_t size() const
+    {
+        if (isUsingSingleSlot())
+            return singleTransition() ? 1 : 0;
+        return map()->size();
+    }
+
 private:
     bool isUsingSingleSlot() const
     {
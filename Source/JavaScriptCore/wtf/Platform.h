@@ -1161,6 +1161,12 @@
     #ifndef ENABLE_JIT_OPTIMIZE_METHOD_CALLS
     #define ENABLE_JIT_OPTIMIZE_METHOD_CALLS 1
     #endif
+    /* Typed array element access needs byte, halfword and single precision loads
+       and stores that only the x86 assemblers provide so far. This is JSC only:
+       builds that use V8, like Android's, do not get it. */
+    #if !defined(ENABLE_JIT_OPTIMIZE_TYPED_ARRAY_ACCESS) && CPU(X86_64) && USE(JSVALUE64)
+    #define ENABLE_JIT_OPTIMIZE_TYPED_ARRAY_ACCESS 1
+    #endif
 #endif
 
 #if CPU(X86) && COMPILER(MSVC)
@@ -1224,6 +1230,12 @@
 #define ENABLE_WEB_ARCHIVE 0
 #endif
 
+/* Counters of the work that WebCore's caches and background threads save.
+   Many sit on hot paths, so only builds that report them should keep them. */
+#if !defined(ENABLE_PERFORMANCE_STATISTICS)
+#define ENABLE_PERFORMANCE_STATISTICS 0
+#endif
+
 /* Use the QXmlStreamReader implementation for XMLDocumentParser */
 /* Use the QXmlQuery implementation for XSLTProcessor */
 #if PLATFORM(QT)
@@ -52,6 +52,7 @@ LOCAL_SRC_FILES := \
 	css/CSSPageRule.cpp \
 	css/CSSParser.cpp \
 	css/CSSParserValues.cpp \
+	css/CSSPreparser.cpp \
 	css/CSSPrimitiveValue.cpp \
 	css/CSSPrimitiveValueCache.cpp \
 	css/CSSProperty.cpp \
@@ -188,7 +189,7 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	dom/ScriptExecutionContext.cpp \
 	dom/ScriptRunner.cpp \
 	dom/SelectElement.cpp \
-	dom/SelectorNodeList.cpp \
+	dom/SelectorQuery.cpp \
 	dom/ShadowRoot.cpp \
 	dom/SpaceSplitString.cpp \
 	dom/StaticHashSetNodeList.cpp \
@@ -392,6 +393,8 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	html/canvas/WebGLObject.cpp \
 	html/canvas/WebGLVertexArrayObjectOES.cpp \
 	\
+	html/parser/BackgroundHTMLParser.cpp \
+	html/parser/CompactHTMLToken.cpp \
 	html/parser/HTMLConstructionSite.cpp \
 	html/parser/HTMLDocumentParser.cpp \
 	html/parser/HTMLElementStack.cpp \
@@ -399,13 +402,16 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	html/parser/HTMLEntitySearch.cpp \
 	html/parser/HTMLFormattingElementList.cpp \
 	html/parser/HTMLMetaCharsetParser.cpp \
+	html/parser/HTMLNameCache.cpp \
 	html/parser/HTMLParserIdioms.cpp \
 	html/parser/HTMLParserScheduler.cpp \
 	html/parser/HTMLPreloadScanner.cpp \
 	html/parser/HTMLScriptRunner.cpp \
+	html/parser/HTMLSimpleFragmentParser.cpp \
 	html/parser/HTMLSourceTracker.cpp \
 	html/parser/HTMLTokenizer.cpp \
 	html/parser/HTMLTreeBuilder.cpp \
+	html/parser/HTMLTreeBuilderSimulator.cpp \
 	html/parser/HTMLViewSourceParser.cpp \
 	html/parser/TextDocumentParser.cpp \
 	html/parser/TextViewSourceParser.cpp \
@@ -511,6 +517,7 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	page/PageGroupLoadDeferrer.cpp \
 	page/Performance.cpp \
 	page/PerformanceNavigation.cpp \
+	page/PerformanceStatistics.cpp \
 	page/PerformanceTiming.cpp \
 	page/PluginHalter.cpp \
 	page/PrintContext.cpp \
@@ -630,6 +637,7 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	platform/graphics/SimpleFontData.cpp \
 	platform/graphics/StringTruncator.cpp \
 	platform/graphics/WidthIterator.cpp \
+	platform/graphics/WordWidthCache.cpp \
 	\
 	platform/graphics/android/BitmapAllocatorAndroid.cpp \
 	platform/graphics/android/GraphicsLayerAndroid.cpp \
@@ -997,6 +1005,7 @@ LOCAL_SRC_FILES := $(LOCAL_SRC_FILES) \
 	rendering/style/StyleFlexibleBoxData.cpp \
 	rendering/style/StyleGeneratedImage.cpp \
 	rendering/style/StyleInheritedData.cpp \
+	rendering/style/StyleInterner.cpp \
 	rendering/style/StyleMarqueeData.cpp \
 	rendering/style/StyleMultiColData.cpp \
 	rendering/style/StyleRareInheritedData.cpp \
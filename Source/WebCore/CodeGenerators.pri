@@ -18,7 +18,6 @@ SVG_NAMES = $$PWD/svg/svgtags.in
 
 XLINK_NAMES = $$PWD/svg/xlinkattrs.in
 
-TOKENIZER = $$PWD/css/tokenizer.flex
 
 DOCTYPESTRINGS_GPERF = $$PWD/html/DocTypeStrings.gperf
 
@@ -687,15 +686,6 @@ injectedScriptSource.commands = perl $$PWD/inspector/xxd.pl InjectedScriptSource
 injectedScriptSource.wkAddOutputToSources = false
 addExtraCompiler(injectedScriptSource)
 
-# GENERATOR 3: tokenizer (flex)
-tokenizer.output = $${WC_GENERATED_SOURCES_DIR}/${QMAKE_FILE_BASE}.cpp
-tokenizer.input = TOKENIZER
-tokenizer.wkScript = $$PWD/css/maketokenizer
-tokenizer.commands = flex -t < ${QMAKE_FILE_NAME} | perl $$tokenizer.wkScript > ${QMAKE_FILE_OUT}
-# tokenizer.cpp is included into CSSParser.cpp
-tokenizer.wkAddOutputToSources = false
-addExtraCompiler(tokenizer)
-
 # GENERATOR 4: CSS grammar
 cssbison.output = $${WC_GENERATED_SOURCES_DIR}/${QMAKE_FILE_BASE}.cpp
 cssbison.input = CSSBISON
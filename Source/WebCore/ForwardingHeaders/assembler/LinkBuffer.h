@@ -0,0 +1,4 @@
+#ifndef WebCore_FWD_LinkBuffer_h
+#define WebCore_FWD_LinkBuffer_h
+#include <JavaScriptCore/LinkBuffer.h>
+#endif
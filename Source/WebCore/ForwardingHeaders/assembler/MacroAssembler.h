@@ -0,0 +1,4 @@
+#ifndef WebCore_FWD_MacroAssembler_h
+#define WebCore_FWD_MacroAssembler_h
+#include <JavaScriptCore/MacroAssembler.h>
+#endif
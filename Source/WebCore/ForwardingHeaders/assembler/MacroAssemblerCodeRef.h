@@ -0,0 +1,4 @@
+#ifndef WebCore_FWD_MacroAssemblerCodeRef_h
+#define WebCore_FWD_MacroAssemblerCodeRef_h
+#include <JavaScriptCore/MacroAssemblerCodeRef.h>
+#endif
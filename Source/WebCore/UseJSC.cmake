@@ -151,6 +151,7 @@ LIST(APPEND WebCore_SOURCES
     bindings/js/ScriptFunctionCall.cpp
     bindings/js/ScriptGCEvent.cpp
     bindings/js/ScriptObject.cpp
+    bindings/js/ScriptPreparser.cpp
     bindings/js/ScriptProfile.cpp
     bindings/js/ScriptProfiler.cpp
     bindings/js/ScriptState.cpp
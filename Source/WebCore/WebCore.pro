@@ -105,6 +105,7 @@ v8 {
         bindings/v8/ScriptFunctionCall.cpp \
         bindings/v8/ScriptInstance.cpp \
         bindings/v8/ScriptObject.cpp \
+        bindings/v8/ScriptPreparser.cpp \
         bindings/v8/ScriptScope.cpp \
         bindings/v8/ScriptState.cpp \
         bindings/v8/ScriptValue.cpp \
@@ -358,6 +359,7 @@ v8 {
         bindings/js/ScriptFunctionCall.cpp \
         bindings/js/ScriptGCEvent.cpp \
         bindings/js/ScriptObject.cpp \
+        bindings/js/ScriptPreparser.cpp \
         bindings/js/ScriptProfile.cpp \
         bindings/js/ScriptState.cpp \
         bindings/js/ScriptValue.cpp \
@@ -406,6 +408,7 @@ SOURCES += \
     css/CSSPageRule.cpp \
     css/CSSParser.cpp \
     css/CSSParserValues.cpp \
+    css/CSSPreparser.cpp \
     css/CSSPrimitiveValue.cpp \
     css/CSSPrimitiveValueCache.cpp \
     css/CSSProperty.cpp \
@@ -436,6 +439,7 @@ SOURCES += \
     css/MediaQueryListListener.cpp \
     css/MediaQueryMatcher.cpp \
     css/RGBColor.cpp \
+    css/SelectorCompiler.cpp \
     css/ShadowValue.cpp \
     css/StyleBase.cpp \
     css/StyleList.cpp \
@@ -533,7 +537,7 @@ SOURCES += \
     dom/ScriptExecutionContext.cpp \
     dom/ScriptRunner.cpp \
     dom/SelectElement.cpp \
-    dom/SelectorNodeList.cpp \
+    dom/SelectorQuery.cpp \
     dom/ShadowRoot.cpp \
     dom/SpaceSplitString.cpp \
     dom/StaticNodeList.cpp \
@@ -784,7 +788,9 @@ SOURCES += \
     html/canvas/Uint16Array.cpp \
     html/canvas/Uint32Array.cpp \
     html/canvas/Uint8Array.cpp \
+    html/parser/BackgroundHTMLParser.cpp \
     html/parser/CSSPreloadScanner.cpp \
+    html/parser/CompactHTMLToken.cpp \
     html/parser/HTMLConstructionSite.cpp \
     html/parser/HTMLDocumentParser.cpp \
     html/parser/HTMLElementStack.cpp \
@@ -792,13 +798,16 @@ SOURCES += \
     html/parser/HTMLEntitySearch.cpp \
     html/parser/HTMLFormattingElementList.cpp \
     html/parser/HTMLMetaCharsetParser.cpp \
+    html/parser/HTMLNameCache.cpp \
     html/parser/HTMLParserIdioms.cpp \
     html/parser/HTMLParserScheduler.cpp \
     html/parser/HTMLPreloadScanner.cpp \
     html/parser/HTMLScriptRunner.cpp \
+    html/parser/HTMLSimpleFragmentParser.cpp \
     html/parser/HTMLSourceTracker.cpp \
     html/parser/HTMLTokenizer.cpp \
     html/parser/HTMLTreeBuilder.cpp \
+    html/parser/HTMLTreeBuilderSimulator.cpp \
     html/parser/HTMLViewSourceParser.cpp \
     html/parser/TextDocumentParser.cpp \
     html/parser/TextViewSourceParser.cpp \
@@ -934,6 +943,7 @@ SOURCES += \
     page/PageGroupLoadDeferrer.cpp \
     page/Performance.cpp \
     page/PerformanceNavigation.cpp \
+    page/PerformanceStatistics.cpp \
     page/PerformanceTiming.cpp \
     page/PluginHalter.cpp \
     page/PrintContext.cpp \
@@ -997,6 +1007,7 @@ SOURCES += \
     platform/graphics/SegmentedFontData.cpp \
     platform/graphics/SimpleFontData.cpp \
     platform/graphics/TiledBackingStore.cpp \
+    platform/graphics/WordWidthCache.cpp \
     platform/graphics/transforms/AffineTransform.cpp \
     platform/graphics/transforms/TransformationMatrix.cpp \
     platform/graphics/transforms/MatrixTransformOperation.cpp \
@@ -1173,6 +1184,7 @@ SOURCES += \
     rendering/style/StyleFlexibleBoxData.cpp \
     rendering/style/StyleGeneratedImage.cpp \
     rendering/style/StyleInheritedData.cpp \
+    rendering/style/StyleInterner.cpp \
     rendering/style/StyleMarqueeData.cpp \
     rendering/style/StyleMultiColData.cpp \
     rendering/style/StyleRareInheritedData.cpp \
@@ -1246,6 +1258,7 @@ v8 {
         bindings/v8/ScriptFunctionCall.h \
         bindings/v8/ScriptInstance.h \
         bindings/v8/ScriptObject.h \
+        bindings/v8/ScriptPreparser.h \
         bindings/v8/ScriptProfile.h \
         bindings/v8/ScriptProfiler.h \
         bindings/v8/ScriptScope.h \
@@ -1332,6 +1345,7 @@ v8 {
         bindings/js/ScriptGCEvent.h \
         bindings/js/ScriptHeapSnapshot.h \
         bindings/js/ScriptObject.h \
+        bindings/js/ScriptPreparser.h \
         bindings/js/ScriptProfile.h \
         bindings/js/ScriptProfileNode.h \
         bindings/js/ScriptProfiler.h \
@@ -1390,6 +1404,7 @@ HEADERS += \
     css/CSSPageRule.h \
     css/CSSParser.h \
     css/CSSParserValues.h \
+    css/CSSPreparser.h \
     css/CSSPrimitiveValue.h \
     css/CSSPrimitiveValueCache.h \
     css/CSSProperty.h \
@@ -1419,6 +1434,7 @@ HEADERS += \
     css/MediaQueryListListener.h \
     css/MediaQueryMatcher.h \
     css/RGBColor.h \
+    css/SelectorCompiler.h \
     css/ShadowValue.h \
     css/StyleBase.h \
     css/StyleList.h \
@@ -1509,7 +1525,7 @@ HEADERS += \
     dom/ScriptElement.h \
     dom/ScriptExecutionContext.h \
     dom/SelectElement.h \
-    dom/SelectorNodeList.h \
+    dom/SelectorQuery.h \
     dom/ShadowRoot.h \
     dom/SpaceSplitString.h \
     dom/StaticNodeList.h \
@@ -1735,7 +1751,9 @@ HEADERS += \
     html/TextDocument.h \
     html/TimeRanges.h \
     html/ValidityState.h \
+    html/parser/BackgroundHTMLParser.h \
     html/parser/CSSPreloadScanner.h \
+    html/parser/CompactHTMLToken.h \
     html/parser/HTMLConstructionSite.h \
     html/parser/HTMLDocumentParser.h \
     html/parser/HTMLElementStack.h \
@@ -1743,13 +1761,16 @@ HEADERS += \
     html/parser/HTMLEntitySearch.h \
     html/parser/HTMLEntityTable.h \
     html/parser/HTMLFormattingElementList.h \
+    html/parser/HTMLNameCache.h \
     html/parser/HTMLParserScheduler.h \
     html/parser/HTMLPreloadScanner.h \
     html/parser/HTMLScriptRunner.h \
     html/parser/HTMLScriptRunnerHost.h \
+    html/parser/HTMLSimpleFragmentParser.h \
     html/parser/HTMLToken.h \
     html/parser/HTMLTokenizer.h \
     html/parser/HTMLTreeBuilder.h \
+    html/parser/HTMLTreeBuilderSimulator.h \
     html/parser/HTMLViewSourceParser.h \
     html/parser/XSSFilter.h \
     html/shadow/MediaControlElements.h \
@@ -1878,6 +1899,7 @@ HEADERS += \
     page/PageGroup.h \
     page/PageGroupLoadDeferrer.h \
     page/Page.h \
+    page/PerformanceStatistics.h \
     page/PluginHalter.h \
     page/PluginHalterClient.h \
     page/PrintContext.h \
@@ -1975,6 +1997,7 @@ HEADERS += \
     platform/graphics/Tile.h \
     platform/graphics/TiledBackingStore.h \    
     platform/graphics/TiledBackingStoreClient.h \
+    platform/graphics/WordWidthCache.h \
     platform/graphics/transforms/Matrix3DTransformOperation.h \
     platform/graphics/transforms/MatrixTransformOperation.h \
     platform/graphics/transforms/PerspectiveTransformOperation.h \
@@ -2192,6 +2215,7 @@ HEADERS += \
     rendering/style/StyleFlexibleBoxData.h \
     rendering/style/StyleGeneratedImage.h \
     rendering/style/StyleInheritedData.h \
+    rendering/style/StyleInterner.h \
     rendering/style/StyleMarqueeData.h \
     rendering/style/StyleMultiColData.h \
     rendering/style/StyleRareInheritedData.h \
@@ -60,6 +60,8 @@ namespace WebCore {
             : ScriptSourceProvider(stringToUString(cachedScript->response().url()), cachedScript->sourceProviderCache())
             , m_cachedScript(cachedScript)
         {
+            if (m_cachedScript->adoptPreparseResults())
+                setValid();
             m_cachedScript->addClient(this);
         }
 
@@ -171,6 +171,7 @@
 #include "ScriptEventListener.cpp"
 #include "ScriptFunctionCall.cpp"
 #include "ScriptGCEvent.cpp"
+#include "ScriptPreparser.cpp"
 #include "ScriptProfiler.cpp"
 #include "ScriptState.cpp"
 #include "SerializedScriptValue.cpp"
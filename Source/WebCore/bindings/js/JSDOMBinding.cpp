@@ -43,8 +43,16 @@
 #include "JSDOMWindowCustom.h"
 #include "JSEventException.h"
 #include "JSExceptionBase.h"
+#include "JSFloat32Array.h"
+#include "JSFloat64Array.h"
+#include "JSInt16Array.h"
+#include "JSInt32Array.h"
+#include "JSInt8Array.h"
 #include "JSMainThreadExecState.h"
 #include "JSRangeException.h"
+#include "JSUint16Array.h"
+#include "JSUint32Array.h"
+#include "JSUint8Array.h"
 #include "JSXMLHttpRequestException.h"
 #include "KURL.h"
 #include "MessagePort.h"
@@ -172,6 +180,22 @@ void markDOMObjectWrapper(MarkStack& markStack, JSGlobalData& globalData, void*
     }
 }
 
+void registerTypedArrayDescriptors(JSGlobalData& globalData)
+{
+#if ENABLE(JIT_OPTIMIZE_TYPED_ARRAY_ACCESS)
+    JSFloat32Array::registerTypedArrayDescriptor(globalData);
+    JSFloat64Array::registerTypedArrayDescriptor(globalData);
+    JSInt16Array::registerTypedArrayDescriptor(globalData);
+    JSInt32Array::registerTypedArrayDescriptor(globalData);
+    JSInt8Array::registerTypedArrayDescriptor(globalData);
+    JSUint16Array::registerTypedArrayDescriptor(globalData);
+    JSUint32Array::registerTypedArrayDescriptor(globalData);
+    JSUint8Array::registerTypedArrayDescriptor(globalData);
+#else
+    UNUSED_PARAM(globalData);
+#endif
+}
+
 static void stringWrapperDestroyed(JSString*, void* context)
 {
     StringImpl* cacheKey = static_cast<StringImpl*>(context);
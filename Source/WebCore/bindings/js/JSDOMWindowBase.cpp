@@ -180,6 +180,7 @@ JSGlobalData* JSDOMWindowBase::commonJSGlobalData()
         globalData->exclusiveThread = currentThread();
 #endif
         initNormalWorldClientData(globalData);
+        registerTypedArrayDescriptors(*globalData);
     }
 
     return globalData;
@@ -0,0 +1,225 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ScriptPreparser.h"
+
+#include "CrossThreadTask.h"
+#include "JSDOMWindowBase.h"
+#include "ScriptSourceProvider.h"
+#include <parser/SourceCode.h>
+#include <parser/SourceProviderCache.h>
+#include <runtime/Completion.h>
+#include <runtime/JSGlobalData.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+
+using namespace JSC;
+
+namespace WebCore {
+
+// Reads the preparser's private copy of the script and records function
+// extents into the job's cache rather than one of its own.
+class PreparseSourceProvider : public ScriptSourceProvider {
+public:
+    static PassRefPtr<PreparseSourceProvider> create(const String& source, SourceProviderCache* cache)
+    {
+        return adoptRef(new PreparseSourceProvider(source, cache));
+    }
+
+    UString getRange(int start, int end) const { return UString(m_source.characters() + start, end - start); }
+    const UChar* data() const { return m_source.characters(); }
+    int length() const { return m_source.length(); }
+
+private:
+    PreparseSourceProvider(const String& source, SourceProviderCache* cache)
+        : ScriptSourceProvider(UString(), cache)
+        , m_source(source)
+    {
+    }
+
+    String m_source;
+};
+
+ScriptPreparseJob::ScriptPreparseJob(const String& source)
+    : m_source(source.threadsafeCopy())
+    , m_cache(adoptPtr(new SourceProviderCache))
+#if ENABLE(PERFORMANCE_STATISTICS)
+    , m_preparseTime(0)
+#endif
+    , m_succeeded(false)
+    , m_finished(false)
+    , m_adopted(false)
+{
+}
+
+ScriptPreparseJob::~ScriptPreparseJob()
+{
+#if ENABLE(PERFORMANCE_STATISTICS)
+    if (!m_adopted)
+        ScriptPreparser::instance()->didDiscard();
+#endif
+}
+
+bool ScriptPreparseJob::isFinished() const
+{
+    MutexLocker lock(m_mutex);
+    return m_finished;
+}
+
+void ScriptPreparseJob::run(JSGlobalData* globalData)
+{
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double startTime = currentTime();
+#endif
+    bool succeeded;
+    {
+        SourceCode source(PreparseSourceProvider::create(m_source, m_cache.get()));
+        succeeded = JSC::preparse(globalData, source);
+    }
+    // The identifiers in the cache belong to this thread; copy them out before handing the cache over.
+    if (succeeded)
+        m_cache->detachFromIdentifierTable();
+    else
+        m_cache->clear();
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double preparseTime = currentTime() - startTime;
+    ScriptPreparser::instance()->didPreparse(preparseTime);
+#endif
+
+    MutexLocker lock(m_mutex);
+    m_succeeded = succeeded;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    m_preparseTime = preparseTime;
+#endif
+    m_finished = true;
+}
+
+bool ScriptPreparseJob::adoptResults(SourceProviderCache* cache)
+{
+    ASSERT(isMainThread());
+    ASSERT(isFinished());
+    ASSERT(!m_adopted);
+
+    if (!m_succeeded)
+        return false;
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double startTime = currentTime();
+#endif
+    cache->adoptDetachedItems(JSDOMWindowBase::commonJSGlobalData(), *m_cache);
+    m_adopted = true;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    ScriptPreparser::instance()->didAdopt(m_preparseTime, currentTime() - startTime);
+#endif
+    return true;
+}
+
+bool ScriptPreparser::s_enabled = false;
+
+ScriptPreparser* ScriptPreparser::instance()
+{
+    DEFINE_STATIC_LOCAL(ScriptPreparser*, instance, (new ScriptPreparser));
+    return instance;
+}
+
+ScriptPreparser::ScriptPreparser()
+    : m_threadId(0)
+{
+}
+
+PassRefPtr<ScriptPreparseJob> ScriptPreparser::preparse(const String& source)
+{
+    ASSERT(isMainThread());
+    if (!m_threadId)
+        startBackgroundThread();
+
+    RefPtr<ScriptPreparseJob> job = ScriptPreparseJob::create(source);
+    m_queue.append(createCallbackTask(&ScriptPreparser::preparseOnBackgroundThread, job));
+    return job.release();
+}
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+ScriptPreparser::Statistics ScriptPreparser::statistics()
+{
+    MutexLocker lock(m_statisticsMutex);
+    return m_statistics;
+}
+#endif
+
+void ScriptPreparser::startBackgroundThread()
+{
+    m_threadId = createThread(threadEntryPoint, this, "WebCore: Script preparser");
+}
+
+void* ScriptPreparser::threadEntryPoint(void* object)
+{
+    static_cast<ScriptPreparser*>(object)->threadEntryPointImpl();
+    return 0;
+}
+
+void ScriptPreparser::threadEntryPointImpl()
+{
+    // Identifiers created while parsing go into this thread's own identifier table.
+    m_globalData = JSGlobalData::create(ThreadStackTypeSmall);
+
+    while (OwnPtr<ScriptExecutionContext::Task> task = m_queue.waitForMessage()) {
+        // We don't need a ScriptExecutionContext in the callback, so pass 0 here.
+        task->performTask(0);
+    }
+}
+
+void ScriptPreparser::preparseOnBackgroundThread(ScriptExecutionContext*, PassRefPtr<ScriptPreparseJob> prpJob)
+{
+    RefPtr<ScriptPreparseJob> job = prpJob;
+    // If the task holds the only reference, the script has already run or gone away.
+    if (job->hasOneRef())
+        return;
+    job->run(instance()->m_globalData.get());
+}
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+void ScriptPreparser::didPreparse(double preparseTime)
+{
+    MutexLocker lock(m_statisticsMutex);
+    ++m_statistics.scriptsPreparsed;
+    m_statistics.preparseTime += preparseTime;
+}
+
+void ScriptPreparser::didAdopt(double preparseTime, double adoptionTime)
+{
+    MutexLocker lock(m_statisticsMutex);
+    ++m_statistics.scriptsAdopted;
+    m_statistics.mainThreadTimeSaved += preparseTime - adoptionTime;
+}
+
+void ScriptPreparser::didDiscard()
+{
+    MutexLocker lock(m_statisticsMutex);
+    ++m_statistics.scriptsDiscarded;
+}
+#endif
+
+} // namespace WebCore
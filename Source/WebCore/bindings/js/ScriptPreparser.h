@@ -0,0 +1,150 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ScriptPreparser_h
+#define ScriptPreparser_h
+
+#include "PlatformString.h"
+#include "ScriptExecutionContext.h"
+#include <wtf/MessageQueue.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Threading.h>
+
+namespace JSC {
+class JSGlobalData;
+class SourceProviderCache;
+}
+
+namespace WebCore {
+
+// A syntax check of one external script, run on the preparser thread. The
+// preparse fills a private source provider cache with the extent of every
+// sizeable function in the script; once it has finished, the main thread moves
+// those entries into the CachedScript's cache so that the parse done by
+// JSC::evaluate() can skip over the function bodies.
+class ScriptPreparseJob : public ThreadSafeRefCounted<ScriptPreparseJob> {
+public:
+    static PassRefPtr<ScriptPreparseJob> create(const String& source)
+    {
+        return adoptRef(new ScriptPreparseJob(source));
+    }
+
+    ~ScriptPreparseJob();
+
+    bool isFinished() const;
+
+    // Main thread only. Returns true if the script has no syntax errors, in
+    // which case the function extents have been moved into the given cache.
+    bool adoptResults(JSC::SourceProviderCache*);
+
+private:
+    friend class ScriptPreparser;
+
+    ScriptPreparseJob(const String& source);
+
+    void run(JSC::JSGlobalData*);
+
+    String m_source;
+    OwnPtr<JSC::SourceProviderCache> m_cache;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double m_preparseTime;
+#endif
+    bool m_succeeded;
+    bool m_finished;
+    bool m_adopted;
+    mutable Mutex m_mutex;
+};
+
+// Owns the thread that preparses external scripts as soon as they finish
+// loading, so that less parsing is left for the main thread when they run.
+class ScriptPreparser {
+public:
+    static ScriptPreparser* instance();
+
+    static void setEnabled(bool enabled) { s_enabled = enabled; }
+    static bool isEnabled() { return s_enabled; }
+
+    // Smaller scripts parse quickly enough that the copy and hand-off cost more than they save.
+    static const unsigned minimumSourceLength = 16 * 1024;
+
+    PassRefPtr<ScriptPreparseJob> preparse(const String& source);
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    struct Statistics {
+        Statistics()
+            : scriptsPreparsed(0)
+            , scriptsAdopted(0)
+            , scriptsDiscarded(0)
+            , preparseTime(0)
+            , mainThreadTimeSaved(0)
+        {
+        }
+
+        unsigned scriptsPreparsed;
+        unsigned scriptsAdopted;
+        unsigned scriptsDiscarded;
+        // Seconds spent parsing on the preparser thread.
+        double preparseTime;
+        // Preparse time of the adopted scripts, less the time the main thread spent adopting them.
+        double mainThreadTimeSaved;
+    };
+
+    Statistics statistics();
+#endif
+
+private:
+    friend class ScriptPreparseJob;
+
+    ScriptPreparser();
+
+    void startBackgroundThread();
+    static void* threadEntryPoint(void* object);
+    void threadEntryPointImpl();
+    static void preparseOnBackgroundThread(ScriptExecutionContext*, PassRefPtr<ScriptPreparseJob>);
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    void didPreparse(double preparseTime);
+    void didAdopt(double preparseTime, double adoptionTime);
+    void didDiscard();
+#endif
+
+    static bool s_enabled;
+
+    ThreadIdentifier m_threadId;
+    MessageQueue<ScriptExecutionContext::Task> m_queue;
+    // Only touched on the preparser thread.
+    RefPtr<JSC::JSGlobalData> m_globalData;
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    Statistics m_statistics;
+    Mutex m_statisticsMutex;
+#endif
+};
+
+} // namespace WebCore
+
+#endif // ScriptPreparser_h
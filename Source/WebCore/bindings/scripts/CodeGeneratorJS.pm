@@ -601,6 +601,19 @@ my %usesToJSNewlyCreated = (
     "TouchList" => 1
 );
 
+# Typed array wrappers cache their element storage so that JIT code can reach it
+# through the descriptors registered with the JSGlobalData.
+my %typedArrayTypes = (
+    "Float32Array" => "TypedArrayFloat32",
+    "Float64Array" => "TypedArrayFloat64",
+    "Int16Array" => "TypedArrayInt16",
+    "Int32Array" => "TypedArrayInt32",
+    "Int8Array" => "TypedArrayInt8",
+    "Uint16Array" => "TypedArrayUint16",
+    "Uint32Array" => "TypedArrayUint32",
+    "Uint8Array" => "TypedArrayUint8"
+);
+
 sub GenerateHeader
 {
     my $object = shift;
@@ -866,6 +879,21 @@ sub GenerateHeader
         push(@headerContent, "        return static_cast<$implClassName*>(Base::impl());\n");
         push(@headerContent, "    }\n");
     }
+
+    if ($typedArrayTypes{$interfaceName}) {
+        push(@headerContent, "\n#if ENABLE(JIT_OPTIMIZE_TYPED_ARRAY_ACCESS)\n");
+        push(@headerContent, "    static ptrdiff_t storageOffset() { return OBJECT_OFFSETOF($className, m_storage); }\n");
+        push(@headerContent, "    static ptrdiff_t storageLengthOffset() { return OBJECT_OFFSETOF($className, m_storageLength); }\n");
+        push(@headerContent, "    static void registerTypedArrayDescriptor(JSC::JSGlobalData& globalData)\n");
+        push(@headerContent, "    {\n");
+        push(@headerContent, "        globalData.registerTypedArrayDescriptor(JSC::$typedArrayTypes{$interfaceName}, JSC::TypedArrayDescriptor(&s_info, storageOffset(), storageLengthOffset()));\n");
+        push(@headerContent, "    }\n");
+        push(@headerContent, "private:\n");
+        push(@headerContent, "    // Typed arrays never change size or storage, so these can be read by JIT code.\n");
+        push(@headerContent, "    void* m_storage;\n");
+        push(@headerContent, "    unsigned m_storageLength;\n");
+        push(@headerContent, "#endif\n");
+    }
     
     # anonymous slots
     if ($numCachedAttributes) {
@@ -1424,6 +1452,12 @@ sub GenerateImplementation
     }
     push(@implContent, "{\n");
     push(@implContent, "    ASSERT(inherits(&s_info));\n");
+    if ($typedArrayTypes{$interfaceName}) {
+        push(@implContent, "#if ENABLE(JIT_OPTIMIZE_TYPED_ARRAY_ACCESS)\n");
+        push(@implContent, "    m_storage = impl()->baseAddress();\n");
+        push(@implContent, "    m_storageLength = impl()->length();\n");
+        push(@implContent, "#endif\n");
+    }
     if ($numCachedAttributes > 0) {
         push(@implContent, "    for (unsigned i = Base::AnonymousSlotCount; i < AnonymousSlotCount; i++)\n");
         push(@implContent, "        putAnonymousValue(globalObject->globalData(), i, JSValue());\n");
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ScriptPreparser.h"
+
+#include "CrossThreadTask.h"
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+#include <wtf/text/CString.h>
+
+namespace WebCore {
+
+ScriptPreparseJob::ScriptPreparseJob(const String& source)
+    : m_source(source.crossThreadString())
+#if ENABLE(PERFORMANCE_STATISTICS)
+    , m_preparseTime(0)
+#endif
+    , m_finished(false)
+    , m_adopted(false)
+{
+}
+
+ScriptPreparseJob::~ScriptPreparseJob()
+{
+#if ENABLE(PERFORMANCE_STATISTICS)
+    if (!m_adopted)
+        ScriptPreparser::instance()->didDiscard();
+#endif
+}
+
+bool ScriptPreparseJob::isFinished() const
+{
+    MutexLocker lock(m_mutex);
+    return m_finished;
+}
+
+void ScriptPreparseJob::run()
+{
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double startTime = currentTime();
+#endif
+    // The positions in the preparse data count characters, whatever the encoding of the input.
+    CString source = m_source.utf8();
+    OwnPtr<v8::ScriptData> scriptData = adoptPtr(v8::ScriptData::PreCompile(source.data(), source.length()));
+    if (scriptData && scriptData->HasError())
+        scriptData.clear();
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double preparseTime = currentTime() - startTime;
+    ScriptPreparser::instance()->didPreparse(preparseTime);
+#endif
+
+    MutexLocker lock(m_mutex);
+    m_scriptData = scriptData.release();
+#if ENABLE(PERFORMANCE_STATISTICS)
+    m_preparseTime = preparseTime;
+#endif
+    m_finished = true;
+}
+
+PassOwnPtr<v8::ScriptData> ScriptPreparseJob::takeScriptData()
+{
+    ASSERT(isMainThread());
+    ASSERT(isFinished());
+    ASSERT(!m_adopted);
+
+    if (!m_scriptData)
+        return 0;
+
+    m_adopted = true;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    ScriptPreparser::instance()->didAdopt(m_preparseTime);
+#endif
+    return m_scriptData.release();
+}
+
+bool ScriptPreparser::s_enabled = false;
+
+ScriptPreparser* ScriptPreparser::instance()
+{
+    DEFINE_STATIC_LOCAL(ScriptPreparser*, instance, (new ScriptPreparser));
+    return instance;
+}
+
+ScriptPreparser::ScriptPreparser()
+    : m_threadId(0)
+{
+}
+
+PassRefPtr<ScriptPreparseJob> ScriptPreparser::preparse(const String& source)
+{
+    ASSERT(isMainThread());
+    if (!m_threadId)
+        startBackgroundThread();
+
+    RefPtr<ScriptPreparseJob> job = ScriptPreparseJob::create(source);
+    m_queue.append(createCallbackTask(&ScriptPreparser::preparseOnBackgroundThread, job));
+    return job.release();
+}
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+ScriptPreparser::Statistics ScriptPreparser::statistics()
+{
+    MutexLocker lock(m_statisticsMutex);
+    return m_statistics;
+}
+#endif
+
+void ScriptPreparser::startBackgroundThread()
+{
+    m_threadId = createThread(threadEntryPoint, this, "WebCore: Script preparser");
+}
+
+void* ScriptPreparser::threadEntryPoint(void* object)
+{
+    static_cast<ScriptPreparser*>(object)->threadEntryPointImpl();
+    return 0;
+}
+
+void ScriptPreparser::threadEntryPointImpl()
+{
+    v8::Isolate* isolate = v8::Isolate::New();
+    isolate->Enter();
+    v8::V8::Initialize();
+
+    while (OwnPtr<ScriptExecutionContext::Task> task = m_queue.waitForMessage()) {
+        // We don't need a ScriptExecutionContext in the callback, so pass 0 here.
+        task->performTask(0);
+    }
+
+    isolate->Exit();
+    isolate->Dispose();
+}
+
+void ScriptPreparser::preparseOnBackgroundThread(ScriptExecutionContext*, PassRefPtr<ScriptPreparseJob> prpJob)
+{
+    RefPtr<ScriptPreparseJob> job = prpJob;
+    // If the task holds the only reference, the script has already run or gone away.
+    if (job->hasOneRef())
+        return;
+    job->run();
+}
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+void ScriptPreparser::didPreparse(double preparseTime)
+{
+    MutexLocker lock(m_statisticsMutex);
+    ++m_statistics.scriptsPreparsed;
+    m_statistics.preparseTime += preparseTime;
+}
+
+void ScriptPreparser::didAdopt(double preparseTime)
+{
+    MutexLocker lock(m_statisticsMutex);
+    ++m_statistics.scriptsAdopted;
+    m_statistics.mainThreadTimeSaved += preparseTime;
+}
+
+void ScriptPreparser::didDiscard()
+{
+    MutexLocker lock(m_statisticsMutex);
+    ++m_statistics.scriptsDiscarded;
+}
+#endif
+
+} // namespace WebCore
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ScriptPreparser_h
+#define ScriptPreparser_h
+
+#include "PlatformString.h"
+#include "ScriptExecutionContext.h"
+#include <v8.h>
+#include <wtf/MessageQueue.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Threading.h>
+
+namespace WebCore {
+
+// A preparse of one external script, run on the preparser thread. V8's
+// preparser records the extent of every function in the script; once it has
+// finished, the main thread hands that data to V8Proxy::compileScript() in
+// place of the preparse it would otherwise run itself, so that the compile
+// can skip over the function bodies.
+class ScriptPreparseJob : public ThreadSafeRefCounted<ScriptPreparseJob> {
+public:
+    static PassRefPtr<ScriptPreparseJob> create(const String& source)
+    {
+        return adoptRef(new ScriptPreparseJob(source));
+    }
+
+    ~ScriptPreparseJob();
+
+    bool isFinished() const;
+
+    // Main thread only. Returns 0 if the script has syntax errors, which the
+    // main thread compile then reports.
+    PassOwnPtr<v8::ScriptData> takeScriptData();
+
+private:
+    friend class ScriptPreparser;
+
+    ScriptPreparseJob(const String& source);
+
+    void run();
+
+    String m_source;
+    OwnPtr<v8::ScriptData> m_scriptData;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double m_preparseTime;
+#endif
+    bool m_finished;
+    bool m_adopted;
+    mutable Mutex m_mutex;
+};
+
+// Owns the thread that preparses external scripts as soon as they finish
+// loading, so that less parsing is left for the main thread when they run.
+// The thread preparses in an isolate of its own; the preparser does not
+// touch the heap, but it does use the current isolate's stack guard and
+// caches.
+class ScriptPreparser {
+public:
+    static ScriptPreparser* instance();
+
+    static void setEnabled(bool enabled) { s_enabled = enabled; }
+    static bool isEnabled() { return s_enabled; }
+
+    // Smaller scripts parse quickly enough that the copy and hand-off cost more than they save.
+    static const unsigned minimumSourceLength = 16 * 1024;
+
+    PassRefPtr<ScriptPreparseJob> preparse(const String& source);
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    struct Statistics {
+        Statistics()
+            : scriptsPreparsed(0)
+            , scriptsAdopted(0)
+            , scriptsDiscarded(0)
+            , preparseTime(0)
+            , mainThreadTimeSaved(0)
+        {
+        }
+
+        unsigned scriptsPreparsed;
+        unsigned scriptsAdopted;
+        unsigned scriptsDiscarded;
+        // Seconds spent preparsing on the preparser thread.
+        double preparseTime;
+        // Preparse time of the adopted scripts, which the main thread would otherwise have spent.
+        double mainThreadTimeSaved;
+    };
+
+    Statistics statistics();
+#endif
+
+private:
+    friend class ScriptPreparseJob;
+
+    ScriptPreparser();
+
+    void startBackgroundThread();
+    static void* threadEntryPoint(void* object);
+    void threadEntryPointImpl();
+    static void preparseOnBackgroundThread(ScriptExecutionContext*, PassRefPtr<ScriptPreparseJob>);
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    void didPreparse(double preparseTime);
+    void didAdopt(double preparseTime);
+    void didDiscard();
+#endif
+
+    static bool s_enabled;
+
+    ThreadIdentifier m_threadId;
+    MessageQueue<ScriptExecutionContext::Task> m_queue;
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    Statistics m_statistics;
+    Mutex m_statisticsMutex;
+#endif
+};
+
+} // namespace WebCore
+
+#endif // ScriptPreparser_h
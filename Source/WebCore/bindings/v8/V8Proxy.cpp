@@ -322,7 +322,9 @@ PassOwnPtr<v8::ScriptData> V8Proxy::precompileScript(v8::Handle<v8::String> code
     if (cachedMetadata)
         return v8::ScriptData::New(cachedMetadata->data(), cachedMetadata->size());
 
-    OwnPtr<v8::ScriptData> scriptData(v8::ScriptData::PreCompile(code));
+    OwnPtr<v8::ScriptData> scriptData = cachedScript->takePreparseResults();
+    if (!scriptData)
+        scriptData = adoptPtr(v8::ScriptData::PreCompile(code));
     cachedScript->setCachedMetadata(dataTypeID, scriptData->Data(), scriptData->Length());
 
     return scriptData.release();
@@ -192,6 +192,15 @@
 #define WTF_USE_JSC !WTF_USE_V8
 #endif
 
+/* The CSS selector compiler generates its code with the JavaScriptCore assembler and only
+   targets x86-64. This is JSC only: builds that use V8, like Android's, do not get it. */
+#if !defined(ENABLE_CSS_SELECTOR_JIT) && USE(JSC) && ENABLE(JIT) && CPU(X86_64)
+#define ENABLE_CSS_SELECTOR_JIT 1
+#endif
+#if ENABLE(CSS_SELECTOR_JIT) && (!USE(JSC) || !CPU(X86_64))
+#error "The CSS selector compiler needs the JavaScriptCore assembler on x86-64"
+#endif
+
 #if USE(CG)
 #ifndef CGFLOAT_DEFINED
 #ifdef __LP64__
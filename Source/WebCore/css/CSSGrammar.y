@@ -159,6 +159,7 @@ static int cssyylex(YYSTYPE* yylval, void* parser)
 %token ATKEYWORD
 
 %token IMPORTANT_SYM
+%token UNPARSED_DECLARATIONS
 %token MEDIA_ONLY
 %token MEDIA_NOT
 %token MEDIA_AND
@@ -809,6 +810,7 @@ before_rule_opening_brace:
     /* empty */ {
         CSSParser* p = static_cast<CSSParser*>(parser);
         p->markSelectorListEnd();
+        p->skipDeclarationBlockIfLazy();
     }
   ;
 
@@ -817,6 +819,10 @@ ruleset:
         CSSParser* p = static_cast<CSSParser*>(parser);
         $$ = p->createStyleRule($1);
     }
+  | selector_list before_rule_opening_brace '{' UNPARSED_DECLARATIONS closing_brace {
+        CSSParser* p = static_cast<CSSParser*>(parser);
+        $$ = p->createStyleRule($1);
+    }
   ;
 
 selector_list:
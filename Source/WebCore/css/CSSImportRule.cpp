@@ -76,7 +76,10 @@ void CSSImportRule::setCSSStyleSheet(const String& href, const KURL& baseURL, co
 #endif
 
     String sheetText = sheet->sheetText(enforceMIMEType, &validMIMEType);
-    m_styleSheet->parseString(sheetText, strict);
+    if (const Vector<CSSBlockExtent>* blocks = sheet->preparsedBlocks())
+        m_styleSheet->parsePreparsedString(sheetText, strict, *blocks);
+    else
+        m_styleSheet->parseString(sheetText, strict);
 
     if (!parent || !parent->document() || !parent->document()->securityOrigin()->canRequest(baseURL))
         crossOriginCSS = true;
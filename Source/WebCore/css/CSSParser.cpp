@@ -73,6 +73,7 @@
 #include "WebKitCSSKeyframesRule.h"
 #include "WebKitCSSTransformValue.h"
 #include <limits.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/HexNumber.h>
 #include <wtf/dtoa.h>
 #include <wtf/text/StringBuffer.h>
@@ -154,11 +155,16 @@ CSSParser::CSSParser(bool strictParsing)
     , m_ruleRangeMap(0)
     , m_currentRuleData(0)
     , m_data(0)
-    , yy_start(1)
+    , m_parsingMode(NormalMode)
     , m_lineNumber(0)
     , m_lastSelectorLineNumber(0)
     , m_allowImportRules(true)
     , m_allowNamespaceDeclarations(true)
+    , m_parseDeclarationsLazily(false)
+    , m_skipNextDeclarationBlock(false)
+    , m_hasUnparsedDeclarations(false)
+    , m_preparsedBlocks(0)
+    , m_nextPreparsedBlock(0)
 {
 #if YYDEBUG > 0
     cssyydebug = 1;
@@ -217,13 +223,22 @@ void CSSParser::setupParser(const char* prefix, const String& string, const char
     m_data[length - 1] = 0;
     m_data[length - 2] = 0;
 
-    yy_hold_char = 0;
     yyleng = 0;
-    yytext = yy_c_buf_p = m_data;
-    yy_hold_char = *yy_c_buf_p;
+    yytext = m_currentCharacter = m_data;
+    m_parsingMode = NormalMode;
     resetRuleBodyMarks();
 }
 
+#if ENABLE(PERFORMANCE_STATISTICS)
+CSSParser::LazyParsingStatistics CSSParser::s_lazyParsingStatistics;
+
+void CSSParser::didParseSkippedDeclarationBlock(double parseTime)
+{
+    ++s_lazyParsingStatistics.declarationBlocksParsed;
+    s_lazyParsingStatistics.declarationBlockParseTime += parseTime;
+}
+#endif
+
 void CSSParser::parseSheet(CSSStyleSheet* sheet, const String& string, int startLineNumber, StyleRuleRangeMap* ruleRangeMap)
 {
     setStyleSheet(sheet);
@@ -234,12 +249,33 @@ void CSSParser::parseSheet(CSSStyleSheet* sheet, const String& string, int start
         m_currentRuleData->styleSourceData = CSSStyleSourceData::create();
     }
 
+    // Relative URLs in a sheet without a URL of its own resolve against the
+    // document's base URL, which may have changed by the time a declaration
+    // block is parsed, so only sheets with a URL are parsed lazily.
+    m_parseDeclarationsLazily = !ruleRangeMap && string.length() >= minimumLazySheetLength && !sheet->finalURL().isNull();
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double startTime = m_parseDeclarationsLazily ? currentTime() : 0;
+#endif
+    if (m_parseDeclarationsLazily)
+        m_sheetText = string;
+
+    m_nextPreparsedBlock = 0;
+
     m_lineNumber = startLineNumber;
     setupParser("", string, "");
     cssyyparse(this);
     m_ruleRangeMap = 0;
     m_currentRuleData = 0;
     m_rule = 0;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    if (m_parseDeclarationsLazily) {
+        ++s_lazyParsingStatistics.sheetsParsedLazily;
+        s_lazyParsingStatistics.sheetParseTime += currentTime() - startTime;
+    }
+#endif
+    m_parseDeclarationsLazily = false;
+    m_sheetText = String();
+    m_preparsedBlocks = 0;
 }
 
 PassRefPtr<CSSRule> CSSParser::parseRule(CSSStyleSheet* sheet, const String& string)
@@ -5922,6 +5958,9 @@ int CSSParser::lex(void* yylvalWithoutType)
     YYSTYPE* yylval = static_cast<YYSTYPE*>(yylvalWithoutType);
     int length;
 
+    if (m_skipNextDeclarationBlock)
+        return skipDeclarationBlock();
+
     lex();
 
     UChar* t = text(&length);
@@ -6135,14 +6174,6 @@ UChar* CSSParser::text(int *length)
     return start;
 }
 
-void CSSParser::countLines()
-{
-    for (UChar* current = yytext; current < yytext + yyleng; ++current) {
-        if (*current == '\n')
-            ++m_lineNumber;
-    }
-}
-
 CSSParserSelector* CSSParser::createFloatingSelector()
 {
     CSSParserSelector* selector = new CSSParserSelector;
@@ -6324,7 +6355,10 @@ CSSRule* CSSParser::createStyleRule(Vector<OwnPtr<CSSParserSelector> >* selector
         rule->adoptSelectorVector(*selectors);
         if (m_hasFontFaceOnlyValues)
             deleteFontFaceOnlyValues();
-        rule->setDeclaration(CSSMutableStyleDeclaration::create(rule.get(), m_parsedProperties, m_numParsedProperties));
+        if (m_hasUnparsedDeclarations)
+            rule->setUnparsedDeclarations(m_sheetText, m_unparsedDeclarationRange.start, m_unparsedDeclarationRange.end - m_unparsedDeclarationRange.start);
+        else
+            rule->setDeclaration(CSSMutableStyleDeclaration::create(rule.get(), m_parsedProperties, m_numParsedProperties));
         result = rule.get();
         m_parsedStyleObjects.append(rule.release());
         if (m_ruleRangeMap) {
@@ -6337,6 +6371,7 @@ CSSRule* CSSParser::createStyleRule(Vector<OwnPtr<CSSParserSelector> >* selector
             m_inStyleRuleOrDeclaration = false;
         }
     }
+    m_hasUnparsedDeclarations = false;
     resetSelectorListMarks();
     resetRuleBodyMarks();
     clearProperties();
@@ -6517,6 +6552,127 @@ void CSSParser::markSelectorListEnd()
     m_selectorListRange.end = listEnd - m_data;
 }
 
+void CSSParser::skipDeclarationBlockIfLazy()
+{
+    // Called when the parser has read the "{" after a style rule's selectors.
+    // In a lazy parse, the next token is then the whole declaration block,
+    // which CSSStyleRule parses the first time the rule matches an element or
+    // its style is asked for. Most rules in a large style sheet never match.
+    if (m_parseDeclarationsLazily && yyTok == '{')
+        m_skipNextDeclarationBlock = true;
+}
+
+int CSSParser::skipDeclarationBlock()
+{
+    m_skipNextDeclarationBlock = false;
+
+    // The block ends at the "}" that balances the opening one, or at the end
+    // of the sheet, which is where the grammar's closing_brace ends it too.
+    UChar* blockStart = m_currentCharacter;
+    UChar* blockEnd;
+    if (!jumpToPreparsedBlockEnd(blockStart, blockEnd)) {
+        int depth = 0;
+        while (true) {
+            blockEnd = m_currentCharacter;
+            int token = lex();
+            if (token == END_TOKEN || (token == '}' && !depth--))
+                break;
+            if (token == '{')
+                ++depth;
+        }
+    }
+
+    // Leave the "}" to be read as the next token.
+    m_currentCharacter = blockEnd;
+    yytext = blockStart;
+    yyleng = blockEnd - blockStart;
+    yyTok = UNPARSED_DECLARATIONS;
+
+    m_hasUnparsedDeclarations = true;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    ++s_lazyParsingStatistics.declarationBlocksSkipped;
+#endif
+    m_unparsedDeclarationRange = SourceRange(blockStart - m_data, blockEnd - m_data);
+    return yyTok;
+}
+
+bool CSSParser::jumpToPreparsedBlockEnd(UChar* blockStart, UChar*& blockEnd)
+{
+    if (!m_preparsedBlocks)
+        return false;
+
+    // Blocks are skipped in the order they start in, so the one wanted is never behind the last one found.
+    const Vector<CSSBlockExtent>& blocks = *m_preparsedBlocks;
+    unsigned start = blockStart - m_data;
+    while (m_nextPreparsedBlock < blocks.size() && blocks[m_nextPreparsedBlock].start < start)
+        ++m_nextPreparsedBlock;
+    if (m_nextPreparsedBlock == blocks.size() || blocks[m_nextPreparsedBlock].start != start)
+        return false;
+
+    const CSSBlockExtent& block = blocks[m_nextPreparsedBlock++];
+    blockEnd = m_data + block.end;
+    m_lineNumber += block.lineCount;
+    return true;
+}
+
+static bool blockStartsBefore(const CSSBlockExtent& a, const CSSBlockExtent& b)
+{
+    return a.start < b.start;
+}
+
+void CSSParser::findBlocks(const String& string, Vector<CSSBlockExtent>& blocks)
+{
+    // The scanner reads up to two characters past the end, like it does in the buffer setupParser() makes.
+    Vector<UChar> buffer;
+    buffer.reserveInitialCapacity(string.length() + 2);
+    buffer.append(string.characters(), string.length());
+    buffer.append(0);
+    buffer.append(0);
+
+    UChar* data = buffer.data();
+    UChar* current = data;
+    UChar* tokenStart;
+    ParsingMode mode = NormalMode;
+    int lineNumber = 0;
+    // Blocks that have not ended yet, innermost last. Their lineCount holds the line number at their start.
+    Vector<CSSBlockExtent> openBlocks;
+
+    // Ends each block where skipDeclarationBlock() would if the block were a declaration block.
+    while (true) {
+        UChar* scanStart = current;
+        int lineNumberAtScanStart = lineNumber;
+        int token = scanToken(current, tokenStart, mode, lineNumber);
+        if (token == '{') {
+            CSSBlockExtent block;
+            block.start = current - data;
+            block.lineCount = lineNumber;
+            openBlocks.append(block);
+            continue;
+        }
+        if (token != END_TOKEN && (token != '}' || openBlocks.isEmpty()))
+            continue;
+
+        // A parser that tokenized its way to the end of a block is left in the
+        // scanner's mode, which jumping there would lose, so such blocks are left out.
+        while (!openBlocks.isEmpty()) {
+            CSSBlockExtent block = openBlocks.last();
+            openBlocks.removeLast();
+            if (mode == NormalMode) {
+                block.end = scanStart - data;
+                block.lineCount = lineNumberAtScanStart - block.lineCount;
+                blocks.append(block);
+            }
+            if (token != END_TOKEN)
+                break;
+        }
+        if (token == END_TOKEN)
+            break;
+    }
+
+    // Inner blocks end first.
+    sort(blocks.begin(), blocks.end(), blockStartsBefore);
+}
+
 void CSSParser::markRuleBodyStart()
 {
     unsigned offset = yytext - m_data;
@@ -6794,33 +6950,885 @@ bool isValidNthToken(const CSSParserString& token)
     return equalIgnoringCase(token, "odd") || equalIgnoringCase(token, "even");
 }
 
-#define YY_DECL int CSSParser::lex()
-#define yyconst const
-typedef int yy_state_type;
-typedef unsigned YY_CHAR;
-// The following line makes sure we treat non-Latin-1 Unicode characters correctly.
-#define YY_SC_TO_UI(c) (c > 0xff ? 0xff : c)
-#define YY_DO_BEFORE_ACTION \
-        yytext = yy_bp; \
-        yyleng = (int) (yy_cp - yy_bp); \
-        yy_hold_char = *yy_cp; \
-        *yy_cp = 0; \
-        yy_c_buf_p = yy_cp;
-#define YY_BREAK break;
-#define ECHO
-#define YY_RULE_SETUP
-#define INITIAL 0
-#define YY_STATE_EOF(state) (YY_END_OF_BUFFER + state + 1)
-#define yyterminate() yyTok = END_TOKEN; return yyTok
-#define YY_FATAL_ERROR(a)
-// The following line is needed to build the tokenizer with a condition stack.
-// The macro is used in the tokenizer grammar with lines containing
-// BEGIN(mediaqueries) and BEGIN(initial). yy_start acts as index to
-// tokenizer transition table, and 'mediaqueries' and 'initial' are
-// offset multipliers that specify which transitions are active
-// in the tokenizer during in each condition (tokenizer state).
-#define BEGIN yy_start = 1 + 2 *
-
-#include "tokenizer.cpp"
+// The tokenizer. It implements the token definitions of the old flex scanner by
+// hand: at every position it returns the longest token that any rule can match,
+// and when two rules match the same length it prefers the one that comes first
+// in the list below, which is the order of the flex rules.
+//
+//   WHITESPACE, SGML_CD, INCLUDES, DASHMATCH, BEGINSWITH, ENDSWITH, CONTAINS,
+//   MEDIA_NOT, MEDIA_ONLY, MEDIA_AND, STRING, IDENT, NTH, HEX, IDSEL,
+//   the @-rule symbols, ATKEYWORD, IMPORTANT_SYM, the dimensions, DIMEN,
+//   INVALIDDIMEN, PERCENTAGE, INTEGER, FLOATTOKEN, ANYFUNCTION, NOTFUNCTION,
+//   URI, CALCFUNCTION, MINFUNCTION, MAXFUNCTION, FUNCTION, UNICODERANGE,
+//   single characters.
+//
+// Tokens point into m_data and are never copied or terminated. Characters
+// outside ASCII can only appear in identifiers, strings and URLs, so all the
+// classification is done with a table lookup on the ASCII range.
+
+enum CharacterType {
+    CharacterOther,
+    CharacterNull,
+    CharacterWhiteSpace,
+    CharacterIdentifierStart,
+    CharacterCaselessU,
+    CharacterNumber,
+    CharacterDot,
+    CharacterDash,
+    CharacterPlus,
+    CharacterQuote,
+    CharacterBackSlash,
+    CharacterHash,
+    CharacterAt,
+    CharacterExclamationMark,
+    CharacterLess,
+    CharacterSlash,
+    CharacterMatchOperator,
+    CharacterEndMediaQuery
+};
+
+static const unsigned char typesOfASCIICharacters[128] = {
+/*   0 - Null               */ CharacterNull,
+/*   1 - Start of Heading   */ CharacterOther,
+/*   2 - Start of Text      */ CharacterOther,
+/*   3 - End of Text        */ CharacterOther,
+/*   4 - End of Transm.     */ CharacterOther,
+/*   5 - Enquiry            */ CharacterOther,
+/*   6 - Acknowledgment     */ CharacterOther,
+/*   7 - Bell               */ CharacterOther,
+/*   8 - Back Space         */ CharacterOther,
+/*   9 - Horizontal Tab     */ CharacterWhiteSpace,
+/*  10 - Line Feed          */ CharacterWhiteSpace,
+/*  11 - Vertical Tab       */ CharacterOther,
+/*  12 - Form Feed          */ CharacterWhiteSpace,
+/*  13 - Carriage Return    */ CharacterWhiteSpace,
+/*  14 - Shift Out          */ CharacterOther,
+/*  15 - Shift In           */ CharacterOther,
+/*  16 - Data Line Escape   */ CharacterOther,
+/*  17 - Device Control 1   */ CharacterOther,
+/*  18 - Device Control 2   */ CharacterOther,
+/*  19 - Device Control 3   */ CharacterOther,
+/*  20 - Device Control 4   */ CharacterOther,
+/*  21 - Negative Ack.      */ CharacterOther,
+/*  22 - Synchronous Idle   */ CharacterOther,
+/*  23 - End of Transmit    */ CharacterOther,
+/*  24 - Cancel             */ CharacterOther,
+/*  25 - End of Medium      */ CharacterOther,
+/*  26 - Substitute         */ CharacterOther,
+/*  27 - Escape             */ CharacterOther,
+/*  28 - File Separator     */ CharacterOther,
+/*  29 - Group Separator    */ CharacterOther,
+/*  30 - Record Separator   */ CharacterOther,
+/*  31 - Unit Separator     */ CharacterOther,
+/*  32 - Space              */ CharacterWhiteSpace,
+/*  33 - !                  */ CharacterExclamationMark,
+/*  34 - "                  */ CharacterQuote,
+/*  35 - #                  */ CharacterHash,
+/*  36 - $                  */ CharacterMatchOperator,
+/*  37 - %                  */ CharacterOther,
+/*  38 - &                  */ CharacterOther,
+/*  39 - '                  */ CharacterQuote,
+/*  40 - (                  */ CharacterOther,
+/*  41 - )                  */ CharacterOther,
+/*  42 - *                  */ CharacterMatchOperator,
+/*  43 - +                  */ CharacterPlus,
+/*  44 - ,                  */ CharacterOther,
+/*  45 - -                  */ CharacterDash,
+/*  46 - .                  */ CharacterDot,
+/*  47 - /                  */ CharacterSlash,
+/*  48 - 0                  */ CharacterNumber,
+/*  49 - 1                  */ CharacterNumber,
+/*  50 - 2                  */ CharacterNumber,
+/*  51 - 3                  */ CharacterNumber,
+/*  52 - 4                  */ CharacterNumber,
+/*  53 - 5                  */ CharacterNumber,
+/*  54 - 6                  */ CharacterNumber,
+/*  55 - 7                  */ CharacterNumber,
+/*  56 - 8                  */ CharacterNumber,
+/*  57 - 9                  */ CharacterNumber,
+/*  58 - :                  */ CharacterOther,
+/*  59 - ;                  */ CharacterEndMediaQuery,
+/*  60 - <                  */ CharacterLess,
+/*  61 - =                  */ CharacterOther,
+/*  62 - >                  */ CharacterOther,
+/*  63 - ?                  */ CharacterOther,
+/*  64 - @                  */ CharacterAt,
+/*  65 - A                  */ CharacterIdentifierStart,
+/*  66 - B                  */ CharacterIdentifierStart,
+/*  67 - C                  */ CharacterIdentifierStart,
+/*  68 - D                  */ CharacterIdentifierStart,
+/*  69 - E                  */ CharacterIdentifierStart,
+/*  70 - F                  */ CharacterIdentifierStart,
+/*  71 - G                  */ CharacterIdentifierStart,
+/*  72 - H                  */ CharacterIdentifierStart,
+/*  73 - I                  */ CharacterIdentifierStart,
+/*  74 - J                  */ CharacterIdentifierStart,
+/*  75 - K                  */ CharacterIdentifierStart,
+/*  76 - L                  */ CharacterIdentifierStart,
+/*  77 - M                  */ CharacterIdentifierStart,
+/*  78 - N                  */ CharacterIdentifierStart,
+/*  79 - O                  */ CharacterIdentifierStart,
+/*  80 - P                  */ CharacterIdentifierStart,
+/*  81 - Q                  */ CharacterIdentifierStart,
+/*  82 - R                  */ CharacterIdentifierStart,
+/*  83 - S                  */ CharacterIdentifierStart,
+/*  84 - T                  */ CharacterIdentifierStart,
+/*  85 - U                  */ CharacterCaselessU,
+/*  86 - V                  */ CharacterIdentifierStart,
+/*  87 - W                  */ CharacterIdentifierStart,
+/*  88 - X                  */ CharacterIdentifierStart,
+/*  89 - Y                  */ CharacterIdentifierStart,
+/*  90 - Z                  */ CharacterIdentifierStart,
+/*  91 - [                  */ CharacterOther,
+/*  92 - \                  */ CharacterBackSlash,
+/*  93 - ]                  */ CharacterOther,
+/*  94 - ^                  */ CharacterMatchOperator,
+/*  95 - _                  */ CharacterIdentifierStart,
+/*  96 - `                  */ CharacterOther,
+/*  97 - a                  */ CharacterIdentifierStart,
+/*  98 - b                  */ CharacterIdentifierStart,
+/*  99 - c                  */ CharacterIdentifierStart,
+/* 100 - d                  */ CharacterIdentifierStart,
+/* 101 - e                  */ CharacterIdentifierStart,
+/* 102 - f                  */ CharacterIdentifierStart,
+/* 103 - g                  */ CharacterIdentifierStart,
+/* 104 - h                  */ CharacterIdentifierStart,
+/* 105 - i                  */ CharacterIdentifierStart,
+/* 106 - j                  */ CharacterIdentifierStart,
+/* 107 - k                  */ CharacterIdentifierStart,
+/* 108 - l                  */ CharacterIdentifierStart,
+/* 109 - m                  */ CharacterIdentifierStart,
+/* 110 - n                  */ CharacterIdentifierStart,
+/* 111 - o                  */ CharacterIdentifierStart,
+/* 112 - p                  */ CharacterIdentifierStart,
+/* 113 - q                  */ CharacterIdentifierStart,
+/* 114 - r                  */ CharacterIdentifierStart,
+/* 115 - s                  */ CharacterIdentifierStart,
+/* 116 - t                  */ CharacterIdentifierStart,
+/* 117 - u                  */ CharacterCaselessU,
+/* 118 - v                  */ CharacterIdentifierStart,
+/* 119 - w                  */ CharacterIdentifierStart,
+/* 120 - x                  */ CharacterIdentifierStart,
+/* 121 - y                  */ CharacterIdentifierStart,
+/* 122 - z                  */ CharacterIdentifierStart,
+/* 123 - {                  */ CharacterEndMediaQuery,
+/* 124 - |                  */ CharacterMatchOperator,
+/* 125 - }                  */ CharacterOther,
+/* 126 - ~                  */ CharacterMatchOperator,
+/* 127 - Delete             */ CharacterOther,
+};
+
+static inline CharacterType characterType(UChar c)
+{
+    // Everything above ASCII is {nonascii}.
+    return c < 128 ? static_cast<CharacterType>(typesOfASCIICharacters[c]) : CharacterIdentifierStart;
+}
+
+// [ \t\r\n\f]
+static inline bool isCSSWhiteSpace(UChar c)
+{
+    return c < 128 && typesOfASCIICharacters[c] == CharacterWhiteSpace;
+}
+
+// [_a-zA-Z]|{nonascii}
+static inline bool isNameStartCharacter(UChar c)
+{
+    CharacterType type = characterType(c);
+    return type == CharacterIdentifierStart || type == CharacterCaselessU;
+}
+
+// [_a-zA-Z0-9-]|{nonascii}
+static inline bool isNameCharacter(UChar c)
+{
+    CharacterType type = characterType(c);
+    return type == CharacterIdentifierStart || type == CharacterCaselessU || type == CharacterNumber || type == CharacterDash;
+}
+
+// [!#$%&*-~]|{nonascii}
+static inline bool isURLCharacter(UChar c)
+{
+    return (c >= '*' && c <= '~') || c == '!' || (c >= '#' && c <= '&') || c >= 128;
+}
+
+// [\t !#$%&(-~]|{nonascii}, plus the quote character of the other kind.
+static inline bool isStringCharacter(UChar c, UChar quote)
+{
+    return (c >= ' ' && c <= '~' && c != quote) || c == '\t' || c >= 128;
+}
+
+// Compares the characters at p with a lowercase ASCII string, ignoring case.
+static inline bool equalToLowerCaseIdentifier(const UChar* p, int length, const char* identifier)
+{
+    for (int i = 0; i < length; ++i) {
+        if (toASCIILower(p[i]) != identifier[i])
+            return false;
+    }
+    return !identifier[length];
+}
+
+// {escape}, with p on the backslash. Returns the end of the escape, or 0.
+static inline UChar* scanEscape(UChar* p)
+{
+    ASSERT(*p == '\\');
+    ++p;
+    if (isASCIIHexDigit(*p)) {
+        UChar* hexEnd = p + 6;
+        do
+            ++p;
+        while (p < hexEnd && isASCIIHexDigit(*p));
+        if (isCSSWhiteSpace(*p))
+            ++p;
+        return p;
+    }
+    if ((*p >= ' ' && *p <= '~') || *p >= 128)
+        return p + 1;
+    return 0;
+}
+
+// {nmchar}*
+static inline UChar* scanNameCharacters(UChar* p)
+{
+    while (true) {
+        if (isNameCharacter(*p))
+            ++p;
+        else if (*p == '\\') {
+            UChar* escapeEnd = scanEscape(p);
+            if (!escapeEnd)
+                return p;
+            p = escapeEnd;
+        } else
+            return p;
+    }
+}
+
+// {ident}. Returns the end of the identifier, or 0.
+static UChar* scanIdentifier(UChar* p)
+{
+    if (*p == '-')
+        ++p;
+    if (isNameStartCharacter(*p))
+        ++p;
+    else if (*p != '\\' || !(p = scanEscape(p)))
+        return 0;
+    return scanNameCharacters(p);
+}
+
+// {num}, with p on a digit, or on a dot followed by a digit.
+static inline UChar* scanNumber(UChar* p, bool& isInteger)
+{
+    while (isASCIIDigit(*p))
+        ++p;
+    isInteger = true;
+    if (*p == '.' && isASCIIDigit(p[1])) {
+        isInteger = false;
+        p += 2;
+        while (isASCIIDigit(*p))
+            ++p;
+    }
+    return p;
+}
+
+// {nth}. Returns the end of the expression, or 0.
+static UChar* scanNth(UChar* p)
+{
+    if (*p == '+' || *p == '-')
+        ++p;
+    while (isASCIIDigit(*p))
+        ++p;
+    if (toASCIILower(*p) != 'n')
+        return 0;
+    UChar* end = ++p;
+
+    // ([\t\r\n ]*[\+-][\t\r\n ]*{intnum})?
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+        ++p;
+    if (*p != '+' && *p != '-')
+        return end;
+    ++p;
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+        ++p;
+    if (!isASCIIDigit(*p))
+        return end;
+    while (isASCIIDigit(*p))
+        ++p;
+    return p;
+}
+
+// {range} or {h}{1,6}-{h}{1,6}, with p after the "U+". Returns the end of the range, or 0.
+static UChar* scanUnicodeRange(UChar* p)
+{
+    UChar* start = p;
+    while (p < start + 6 && isASCIIHexDigit(*p))
+        ++p;
+    if (p > start && *p == '-' && isASCIIHexDigit(p[1])) {
+        UChar* secondStart = ++p;
+        while (p < secondStart + 6 && isASCIIHexDigit(*p))
+            ++p;
+        return p;
+    }
+    while (p < start + 6 && *p == '?')
+        ++p;
+    return p > start ? p : 0;
+}
+
+// The rest of "url("{w}")" after a string or {url}, or 0 if it does not follow.
+static inline UChar* scanURIEnd(UChar* p)
+{
+    while (isCSSWhiteSpace(*p))
+        ++p;
+    return *p == ')' ? p + 1 : 0;
+}
+
+// {string}, with p on the opening quote. Returns the end of the longest string,
+// or 0 if the string is not terminated. Inside a URI, a string only counts if
+// the rest of the URI follows it, and the end of the URI is returned instead.
+//
+// A backslash can either start an escape or stand for itself, so a quote right
+// after one both ends a string and continues it; the string continues until a
+// character that no rule allows, and the last place it could have ended wins.
+static UChar* scanString(UChar* p, bool inURI)
+{
+    UChar quote = *p++;
+    UChar* end = 0;
+    unsigned hexDigits = 0;
+    bool afterBackslash = false;
+    while (true) {
+        UChar c = *p;
+        if (afterBackslash) {
+            afterBackslash = false;
+            if (c == quote) {
+                if (UChar* tokenEnd = inURI ? scanURIEnd(p + 1) : p + 1)
+                    end = tokenEnd;
+                ++p;
+                continue;
+            }
+            if (isASCIIHexDigit(c)) {
+                hexDigits = 1;
+                ++p;
+                continue;
+            }
+            // \\{nl}
+            if (c == '\n' || c == '\f') {
+                ++p;
+                continue;
+            }
+            if (c == '\r') {
+                if (*++p == '\n')
+                    ++p;
+                continue;
+            }
+        } else if (hexDigits) {
+            if (isASCIIHexDigit(c)) {
+                hexDigits = hexDigits < 6 ? hexDigits + 1 : 0;
+                ++p;
+                continue;
+            }
+            hexDigits = 0;
+            // The whitespace that may follow a {unicode} escape.
+            if (isCSSWhiteSpace(c)) {
+                ++p;
+                continue;
+            }
+        }
+        if (c == quote) {
+            UChar* tokenEnd = inURI ? scanURIEnd(p + 1) : p + 1;
+            return tokenEnd ? tokenEnd : end;
+        }
+        if (c == '\\')
+            afterBackslash = true;
+        else if (!isStringCharacter(c, quote))
+            return end;
+        ++p;
+    }
+}
+
+// "url("{w}{string}{w}")" or "url("{w}{url}{w}")", with p after the "url(".
+// Returns the end of the URI, or 0. Backslashes are handled as in scanString().
+static UChar* scanURI(UChar* p)
+{
+    while (isCSSWhiteSpace(*p))
+        ++p;
+    if (*p == '"' || *p == '\'')
+        return scanString(p, true);
+
+    UChar* end = 0;
+    unsigned hexDigits = 0;
+    bool afterBackslash = false;
+    while (true) {
+        UChar c = *p;
+        if (afterBackslash) {
+            afterBackslash = false;
+            if (isASCIIHexDigit(c)) {
+                hexDigits = 1;
+                ++p;
+                continue;
+            }
+            if (c == ')') {
+                end = p + 1;
+                ++p;
+                continue;
+            }
+            if (c == '\\') {
+                afterBackslash = true;
+                ++p;
+                continue;
+            }
+            if ((c >= ' ' && c <= '~') || c >= 128) {
+                ++p;
+                continue;
+            }
+        } else if (hexDigits) {
+            if (isASCIIHexDigit(c)) {
+                hexDigits = hexDigits < 6 ? hexDigits + 1 : 0;
+                ++p;
+                continue;
+            }
+            hexDigits = 0;
+            if (isCSSWhiteSpace(c)) {
+                ++p;
+                continue;
+            }
+        }
+        if (!isURLCharacter(c)) {
+            UChar* tokenEnd = scanURIEnd(p);
+            return tokenEnd ? tokenEnd : end;
+        }
+        afterBackslash = c == '\\';
+        ++p;
+    }
+}
+
+// The token for a dimension, given the identifier that follows the number.
+static inline int dimensionToken(const UChar* unit, int length)
+{
+    switch (length) {
+    case 1:
+        if (toASCIILower(*unit) == 's')
+            return SECS;
+        break;
+    case 2:
+        switch (toASCIILower(*unit)) {
+        case 'c':
+            if (toASCIILower(unit[1]) == 'm')
+                return CMS;
+            break;
+        case 'e':
+            if (toASCIILower(unit[1]) == 'm')
+                return EMS;
+            if (toASCIILower(unit[1]) == 'x')
+                return EXS;
+            break;
+        case 'h':
+            if (toASCIILower(unit[1]) == 'z')
+                return HERTZ;
+            break;
+        case 'i':
+            if (toASCIILower(unit[1]) == 'n')
+                return INS;
+            break;
+        case 'm':
+            if (toASCIILower(unit[1]) == 'm')
+                return MMS;
+            if (toASCIILower(unit[1]) == 's')
+                return MSECS;
+            break;
+        case 'p':
+            if (toASCIILower(unit[1]) == 'x')
+                return PXS;
+            if (toASCIILower(unit[1]) == 't')
+                return PTS;
+            if (toASCIILower(unit[1]) == 'c')
+                return PCS;
+            break;
+        }
+        break;
+    case 3:
+        if (equalToLowerCaseIdentifier(unit, 3, "rem"))
+            return REMS;
+        if (equalToLowerCaseIdentifier(unit, 3, "deg"))
+            return DEGS;
+        if (equalToLowerCaseIdentifier(unit, 3, "rad"))
+            return RADS;
+        if (equalToLowerCaseIdentifier(unit, 3, "khz"))
+            return KHERTZ;
+        break;
+    case 4:
+        if (equalToLowerCaseIdentifier(unit, 4, "grad"))
+            return GRADS;
+        if (equalToLowerCaseIdentifier(unit, 4, "turn"))
+            return TURNS;
+        break;
+    case 5:
+        if (equalToLowerCaseIdentifier(unit, 5, "__qem"))
+            return QEMS;
+        break;
+    }
+    return DIMEN;
+}
+
+// The token for "@" followed by an identifier, without the "@".
+static inline int atRuleToken(const UChar* name, int length)
+{
+    switch (toASCIILower(*name)) {
+    case '-':
+        if (length < 12 || !equalToLowerCaseIdentifier(name, 8, "-webkit-"))
+            break;
+        name += 8;
+        length -= 8;
+        if (equalToLowerCaseIdentifier(name, length, "rule"))
+            return WEBKIT_RULE_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "decls"))
+            return WEBKIT_DECLS_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "value"))
+            return WEBKIT_VALUE_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "mediaquery"))
+            return WEBKIT_MEDIAQUERY_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "selector"))
+            return WEBKIT_SELECTOR_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "keyframes"))
+            return WEBKIT_KEYFRAMES_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "keyframe-rule"))
+            return WEBKIT_KEYFRAME_RULE_SYM;
+        break;
+    case 'b':
+        if (length < 10 || !equalToLowerCaseIdentifier(name, 7, "bottom-"))
+            break;
+        name += 7;
+        length -= 7;
+        if (equalToLowerCaseIdentifier(name, length, "left"))
+            return BOTTOMLEFT_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "left-corner"))
+            return BOTTOMLEFTCORNER_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "center"))
+            return BOTTOMCENTER_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "right"))
+            return BOTTOMRIGHT_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "right-corner"))
+            return BOTTOMRIGHTCORNER_SYM;
+        break;
+    case 'c':
+        if (equalToLowerCaseIdentifier(name, length, "charset"))
+            return CHARSET_SYM;
+        break;
+    case 'f':
+        if (equalToLowerCaseIdentifier(name, length, "font-face"))
+            return FONT_FACE_SYM;
+        break;
+    case 'i':
+        if (equalToLowerCaseIdentifier(name, length, "import"))
+            return IMPORT_SYM;
+        break;
+    case 'l':
+        if (equalToLowerCaseIdentifier(name, length, "left-top"))
+            return LEFTTOP_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "left-middle"))
+            return LEFTMIDDLE_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "left-bottom"))
+            return LEFTBOTTOM_SYM;
+        break;
+    case 'm':
+        if (equalToLowerCaseIdentifier(name, length, "media"))
+            return MEDIA_SYM;
+        break;
+    case 'n':
+        if (equalToLowerCaseIdentifier(name, length, "namespace"))
+            return NAMESPACE_SYM;
+        break;
+    case 'p':
+        if (equalToLowerCaseIdentifier(name, length, "page"))
+            return PAGE_SYM;
+        break;
+    case 'r':
+        if (equalToLowerCaseIdentifier(name, length, "right-top"))
+            return RIGHTTOP_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "right-middle"))
+            return RIGHTMIDDLE_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "right-bottom"))
+            return RIGHTBOTTOM_SYM;
+        break;
+    case 't':
+        if (length < 7 || !equalToLowerCaseIdentifier(name, 4, "top-"))
+            break;
+        name += 4;
+        length -= 4;
+        if (equalToLowerCaseIdentifier(name, length, "left"))
+            return TOPLEFT_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "left-corner"))
+            return TOPLEFTCORNER_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "center"))
+            return TOPCENTER_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "right"))
+            return TOPRIGHT_SYM;
+        if (equalToLowerCaseIdentifier(name, length, "right-corner"))
+            return TOPRIGHTCORNER_SYM;
+        break;
+    }
+    return ATKEYWORD;
+}
+
+// The token for an identifier followed by "(", including the "(".
+static inline int functionToken(const UChar* name, int length)
+{
+    switch (length) {
+    case 4:
+        if (equalToLowerCaseIdentifier(name, 4, "not("))
+            return NOTFUNCTION;
+        break;
+    case 12:
+        if (equalToLowerCaseIdentifier(name, 12, "-webkit-any("))
+            return ANYFUNCTION;
+        if (equalToLowerCaseIdentifier(name, 12, "-webkit-min("))
+            return MINFUNCTION;
+        if (equalToLowerCaseIdentifier(name, 12, "-webkit-max("))
+            return MAXFUNCTION;
+        break;
+    case 13:
+        if (equalToLowerCaseIdentifier(name, 13, "-webkit-calc("))
+            return CALCFUNCTION;
+        break;
+    }
+    return FUNCTION;
+}
+
+// The token for an identifier inside a media query.
+static inline int mediaQueryToken(const UChar* name, int length)
+{
+    switch (length) {
+    case 3:
+        if (equalToLowerCaseIdentifier(name, 3, "not"))
+            return MEDIA_NOT;
+        if (equalToLowerCaseIdentifier(name, 3, "and"))
+            return MEDIA_AND;
+        break;
+    case 4:
+        if (equalToLowerCaseIdentifier(name, 4, "only"))
+            return MEDIA_ONLY;
+        break;
+    }
+    return IDENT;
+}
+
+static inline int countNewlines(const UChar* start, const UChar* end)
+{
+    int count = 0;
+    for (const UChar* current = start; current < end; ++current) {
+        if (*current == '\n')
+            ++count;
+    }
+    return count;
+}
+
+int CSSParser::scanToken(UChar*& currentCharacter, UChar*& tokenStart, ParsingMode& mode, int& lineNumber)
+{
+    UChar* current = currentCharacter;
+    UChar* end;
+    int token;
+
+    while (true) {
+        tokenStart = current;
+        UChar c = *current;
+        token = c;
+        end = current + 1;
+
+        switch (characterType(c)) {
+        case CharacterNull:
+            // The end of the buffer. Stay on it, so that any further call returns the end too.
+            token = END_TOKEN;
+            end = current;
+            break;
+
+        case CharacterWhiteSpace:
+            while (isCSSWhiteSpace(*end))
+                ++end;
+            token = WHITESPACE;
+            lineNumber += countNewlines(tokenStart, end);
+            break;
+
+        case CharacterSlash:
+            if (*end != '*')
+                break;
+            // \/\*[^*]*\*+([^/*][^*]*\*+)*\/
+            // An unterminated comment is not a comment, but a "/" followed by a "*".
+            for (UChar* p = end + 1; *p; ++p) {
+                if (*p == '*' && p[1] == '/') {
+                    end = p + 2;
+                    break;
+                }
+            }
+            if (end == current + 1)
+                break;
+            lineNumber += countNewlines(tokenStart, end);
+            current = end;
+            continue;
+
+        case CharacterLess:
+            if (*end == '!' && end[1] == '-' && end[2] == '-') {
+                token = SGML_CD;
+                end += 3;
+            }
+            break;
+
+        case CharacterMatchOperator:
+            if (*end != '=')
+                break;
+            switch (c) {
+            case '~':
+                token = INCLUDES;
+                break;
+            case '|':
+                token = DASHMATCH;
+                break;
+            case '^':
+                token = BEGINSWITH;
+                break;
+            case '$':
+                token = ENDSWITH;
+                break;
+            case '*':
+                token = CONTAINS;
+                break;
+            }
+            ++end;
+            break;
+
+        case CharacterQuote:
+            if (UChar* stringEnd = scanString(current, false)) {
+                token = STRING;
+                end = stringEnd;
+            }
+            break;
+
+        case CharacterDash:
+            if (*end == '-' && end[1] == '>') {
+                token = SGML_CD;
+                end += 2;
+                break;
+            }
+            // Fall through.
+        case CharacterIdentifierStart:
+        case CharacterCaselessU:
+        case CharacterBackSlash:
+            if (UChar* identifierEnd = scanIdentifier(current)) {
+                end = identifierEnd;
+                if (*end == '(') {
+                    ++end;
+                    token = functionToken(current, end - current);
+                    if (token == FUNCTION && end - current == 4 && equalToLowerCaseIdentifier(current, 4, "url(")) {
+                        if (UChar* uriEnd = scanURI(end)) {
+                            token = URI;
+                            end = uriEnd;
+                        }
+                    }
+                } else
+                    token = mode == MediaQueryMode ? mediaQueryToken(current, end - current) : IDENT;
+            }
+            if (c == '-' || toASCIILower(c) == 'n') {
+                UChar* nthEnd = scanNth(current);
+                if (nthEnd && nthEnd > end) {
+                    token = NTH;
+                    end = nthEnd;
+                }
+            } else if (toASCIILower(c) == 'u' && current[1] == '+') {
+                UChar* rangeEnd = scanUnicodeRange(current + 2);
+                if (rangeEnd && rangeEnd > end) {
+                    token = UNICODERANGE;
+                    end = rangeEnd;
+                }
+            }
+            break;
+
+        case CharacterPlus:
+            if (UChar* nthEnd = scanNth(current)) {
+                token = NTH;
+                end = nthEnd;
+            }
+            break;
+
+        case CharacterDot:
+            if (!isASCIIDigit(*end))
+                break;
+            // Fall through.
+        case CharacterNumber: {
+            bool isInteger;
+            end = scanNumber(current, isInteger);
+            token = isInteger ? INTEGER : FLOATTOKEN;
+            if (UChar* unitEnd = scanIdentifier(end)) {
+                if (*unitEnd == '+') {
+                    token = INVALIDDIMEN;
+                    end = unitEnd + 1;
+                } else {
+                    token = dimensionToken(end, unitEnd - end);
+                    end = unitEnd;
+                }
+            } else if (*end == '%') {
+                while (*end == '%')
+                    ++end;
+                token = PERCENTAGE;
+            }
+            if (c != '.') {
+                UChar* nthEnd = scanNth(current);
+                if (nthEnd && nthEnd >= end) {
+                    token = NTH;
+                    end = nthEnd;
+                }
+            }
+            break;
+        }
+
+        case CharacterHash: {
+            UChar* hexEnd = end;
+            while (isASCIIHexDigit(*hexEnd))
+                ++hexEnd;
+            UChar* identifierEnd = scanIdentifier(end);
+            if (identifierEnd && identifierEnd > hexEnd) {
+                token = IDSEL;
+                end = identifierEnd;
+            } else if (hexEnd > end) {
+                token = HEX;
+                end = hexEnd;
+            }
+            break;
+        }
+
+        case CharacterAt:
+            if (UChar* identifierEnd = scanIdentifier(end)) {
+                token = atRuleToken(end, identifierEnd - end);
+                end = identifierEnd;
+                if (token == IMPORT_SYM || token == MEDIA_SYM || token == WEBKIT_MEDIAQUERY_SYM)
+                    mode = MediaQueryMode;
+            }
+            break;
+
+        case CharacterExclamationMark: {
+            UChar* p = end;
+            while (isCSSWhiteSpace(*p))
+                ++p;
+            if (equalToLowerCaseIdentifier(p, 9, "important")) {
+                token = IMPORTANT_SYM;
+                end = p + 9;
+            }
+            break;
+        }
+
+        case CharacterEndMediaQuery:
+            mode = NormalMode;
+            break;
+
+        case CharacterOther:
+            break;
+        }
+        break;
+    }
+
+    currentCharacter = end;
+    return token;
+}
+
+int CSSParser::lex()
+{
+    yyTok = scanToken(m_currentCharacter, yytext, m_parsingMode, m_lineNumber);
+    yyleng = m_currentCharacter - yytext;
+    return yyTok;
+}
 
 }
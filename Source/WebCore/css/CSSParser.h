@@ -55,12 +55,54 @@ namespace WebCore {
     class WebKitCSSKeyframeRule;
     class WebKitCSSKeyframesRule;
 
+    // A block that opens with "{", as found by CSSParser::findBlocks().
+    struct CSSBlockExtent {
+        // Just after the "{".
+        unsigned start;
+        // Where the scan that reaches the balancing "}" starts, or the end of the sheet.
+        unsigned end;
+        // The number of lines the parser counts between the two.
+        unsigned lineCount;
+    };
+
     class CSSParser {
     public:
         CSSParser(bool strictParsing = true);
         ~CSSParser();
 
         void parseSheet(CSSStyleSheet*, const String&, int startLineNumber = 0, StyleRuleRangeMap* ruleRangeMap = 0);
+        // Style sheets with a URL of their own that are at least this long leave the
+        // declaration blocks of their style rules unparsed until they are needed.
+        static const unsigned minimumLazySheetLength = 16 * 1024;
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+        struct LazyParsingStatistics {
+            LazyParsingStatistics()
+                : sheetsParsedLazily(0)
+                , declarationBlocksSkipped(0)
+                , declarationBlocksParsed(0)
+                , sheetParseTime(0)
+                , declarationBlockParseTime(0)
+            {
+            }
+
+            unsigned sheetsParsedLazily;
+            unsigned declarationBlocksSkipped;
+            // Skipped blocks that were parsed later because their declarations were needed.
+            unsigned declarationBlocksParsed;
+            // Seconds spent in parseSheet() on the lazily parsed sheets, and in parsing their blocks later.
+            double sheetParseTime;
+            double declarationBlockParseTime;
+        };
+        static LazyParsingStatistics lazyParsingStatistics() { return s_lazyParsingStatistics; }
+        static void didParseSkippedDeclarationBlock(double parseTime);
+#endif
+
+        // The blocks of the text given to the next parseSheet(), which it then
+        // jumps over rather than tokenizes when it leaves declarations unparsed.
+        void setPreparsedBlocks(const Vector<CSSBlockExtent>* blocks) { m_preparsedBlocks = blocks; }
+        // Uses nothing but the tokenizer and creates no strings, so it can run on any thread.
+        static void findBlocks(const String&, Vector<CSSBlockExtent>&);
         PassRefPtr<CSSRule> parseRule(CSSStyleSheet*, const String&);
         PassRefPtr<CSSRule> parseKeyframeRule(CSSStyleSheet*, const String&);
         static bool parseValue(CSSMutableStyleDeclaration*, int propId, const String&, bool important, bool strict);
@@ -269,10 +311,10 @@ namespace WebCore {
         void resetSelectorListMarks() { m_selectorListRange.start = m_selectorListRange.end = 0; }
         void resetRuleBodyMarks() { m_ruleBodyRange.start = m_ruleBodyRange.end = 0; }
         void resetPropertyMarks() { m_propertyRange.start = m_propertyRange.end = UINT_MAX; }
+        void skipDeclarationBlockIfLazy();
         int lex(void* yylval);
         int token() { return yyTok; }
         UChar* text(int* length);
-        void countLines();
         int lex();
 
     private:
@@ -282,6 +324,8 @@ namespace WebCore {
 
         void setupParser(const char* prefix, const String&, const char* suffix);
 
+        int skipDeclarationBlock();
+
         bool inShorthand() const { return m_inParseShorthand; }
 
         void checkForOrphanedUnits();
@@ -305,21 +349,42 @@ namespace WebCore {
         bool parseSize(int propId, bool important);
         SizeParameterType parseSizeParameter(CSSValueList* parsedValues, CSSParserValue* value, SizeParameterType prevParamType);
 
+        enum ParsingMode {
+            NormalMode,
+            // Between @import, @media or @-webkit-mediaquery and the next "{" or ";".
+            MediaQueryMode
+        };
+
+        // Scans the token at current and moves past it. Touches no state but
+        // its arguments, so that findBlocks() can share it with lex().
+        static int scanToken(UChar*& current, UChar*& tokenStart, ParsingMode&, int& lineNumber);
+        bool jumpToPreparsedBlockEnd(UChar* blockStart, UChar*& blockEnd);
+
         UChar* m_data;
         UChar* yytext;
-        UChar* yy_c_buf_p;
-        UChar yy_hold_char;
-        int yy_last_accepting_state;
-        UChar* yy_last_accepting_cpos;
+        UChar* m_currentCharacter;
         int yyleng;
         int yyTok;
-        int yy_start;
+        ParsingMode m_parsingMode;
         int m_lineNumber;
         int m_lastSelectorLineNumber;
 
         bool m_allowImportRules;
         bool m_allowNamespaceDeclarations;
 
+        // Set by parseSheet() for large style sheets, whose style rules are
+        // created with their declaration blocks left unparsed.
+        bool m_parseDeclarationsLazily;
+        bool m_skipNextDeclarationBlock;
+        bool m_hasUnparsedDeclarations;
+#if ENABLE(PERFORMANCE_STATISTICS)
+        static LazyParsingStatistics s_lazyParsingStatistics;
+#endif
+        String m_sheetText;
+        SourceRange m_unparsedDeclarationRange;
+        const Vector<CSSBlockExtent>* m_preparsedBlocks;
+        size_t m_nextPreparsedBlock;
+
         Vector<RefPtr<StyleBase> > m_parsedStyleObjects;
         Vector<RefPtr<CSSRuleList> > m_parsedRuleLists;
         HashSet<CSSParserSelector*> m_floatingSelectors;
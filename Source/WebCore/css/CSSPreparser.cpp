@@ -0,0 +1,201 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CSSPreparser.h"
+
+#include "CachedCSSStyleSheet.h"
+#include "CrossThreadTask.h"
+#include "TextResourceDecoder.h"
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+
+namespace WebCore {
+
+CSSPreparseJob::CSSPreparseJob(CachedCSSStyleSheet* client, PassRefPtr<TextResourceDecoder> decoder, const char* data, size_t length)
+    : m_client(client)
+#if ENABLE(PERFORMANCE_STATISTICS)
+    , m_adopted(false)
+    , m_copyTime(0)
+#endif
+    , m_decoder(decoder)
+#if ENABLE(PERFORMANCE_STATISTICS)
+    , m_decodeTime(0)
+#endif
+{
+    m_data.append(data, length);
+}
+
+CSSPreparseJob::~CSSPreparseJob()
+{
+#if ENABLE(PERFORMANCE_STATISTICS)
+    if (!m_adopted)
+        CSSPreparser::instance()->didDiscard();
+#endif
+}
+
+void CSSPreparseJob::run()
+{
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double startTime = currentTime();
+#endif
+    String sheetText = m_decoder->decode(m_data.data(), m_data.size());
+    sheetText += m_decoder->flush();
+    m_data.clear();
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double scanStartTime = currentTime();
+    m_decodeTime = scanStartTime - startTime;
+#endif
+
+    CSSParser::findBlocks(sheetText, m_blocks);
+    m_sheetText = sheetText;
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    CSSPreparser::instance()->didPreparse(m_decodeTime, currentTime() - scanStartTime);
+#endif
+}
+
+PassRefPtr<TextResourceDecoder> CSSPreparseJob::releaseDecoder()
+{
+    ASSERT(isMainThread());
+    return m_decoder.release();
+}
+
+String CSSPreparseJob::releaseSheetText()
+{
+    ASSERT(isMainThread());
+    // Leave nothing that shares the text's buffer for the preparser thread to release.
+    String sheetText = m_sheetText;
+    m_sheetText = String();
+    return sheetText;
+}
+
+bool CSSPreparser::s_enabled = false;
+
+CSSPreparser* CSSPreparser::instance()
+{
+    DEFINE_STATIC_LOCAL(CSSPreparser*, instance, (new CSSPreparser));
+    return instance;
+}
+
+CSSPreparser::CSSPreparser()
+    : m_threadId(0)
+{
+}
+
+PassRefPtr<CSSPreparseJob> CSSPreparser::preparse(CachedCSSStyleSheet* client, const TextResourceDecoder* decoder, const char* data, size_t length)
+{
+    ASSERT(isMainThread());
+    if (!m_threadId)
+        startBackgroundThread();
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double startTime = currentTime();
+#endif
+    RefPtr<CSSPreparseJob> job = CSSPreparseJob::create(client, decoder->clone(), data, length);
+#if ENABLE(PERFORMANCE_STATISTICS)
+    job->m_copyTime = currentTime() - startTime;
+#endif
+    m_queue.append(createCallbackTask(&CSSPreparser::preparseOnBackgroundThread, job));
+    return job.release();
+}
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+CSSPreparser::Statistics CSSPreparser::statistics()
+{
+    MutexLocker lock(m_statisticsMutex);
+    return m_statistics;
+}
+#endif
+
+void CSSPreparser::startBackgroundThread()
+{
+    m_threadId = createThread(threadEntryPoint, this, "WebCore: CSS preparser");
+}
+
+void* CSSPreparser::threadEntryPoint(void* object)
+{
+    static_cast<CSSPreparser*>(object)->threadEntryPointImpl();
+    return 0;
+}
+
+void CSSPreparser::threadEntryPointImpl()
+{
+    while (OwnPtr<ScriptExecutionContext::Task> task = m_queue.waitForMessage()) {
+        // We don't need a ScriptExecutionContext in the callback, so pass 0 here.
+        task->performTask(0);
+    }
+}
+
+void CSSPreparser::preparseOnBackgroundThread(ScriptExecutionContext*, PassRefPtr<CSSPreparseJob> prpJob)
+{
+    RefPtr<CSSPreparseJob> job = prpJob;
+    // If the task holds the only reference, the style sheet has gone away or started over.
+    if (job->hasOneRef())
+        return;
+    job->run();
+    // The main thread takes over this reference.
+    callOnMainThread(didFinishOnMainThread, job.release().leakRef());
+}
+
+void CSSPreparser::didFinishOnMainThread(void* context)
+{
+    RefPtr<CSSPreparseJob> job = adoptRef(static_cast<CSSPreparseJob*>(context));
+    CachedCSSStyleSheet* client = job->m_client;
+    if (!client)
+        return;
+
+    job->m_client = 0;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    job->m_adopted = true;
+    instance()->didAdopt(job->m_decodeTime, job->m_copyTime);
+#endif
+    client->didFinishPreparse();
+}
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+void CSSPreparser::didPreparse(double decodeTime, double scanTime)
+{
+    MutexLocker lock(m_statisticsMutex);
+    ++m_statistics.sheetsPreparsed;
+    m_statistics.decodeTime += decodeTime;
+    m_statistics.scanTime += scanTime;
+}
+
+void CSSPreparser::didAdopt(double decodeTime, double copyTime)
+{
+    MutexLocker lock(m_statisticsMutex);
+    ++m_statistics.sheetsAdopted;
+    m_statistics.mainThreadTimeSaved += decodeTime - copyTime;
+}
+
+void CSSPreparser::didDiscard()
+{
+    MutexLocker lock(m_statisticsMutex);
+    ++m_statistics.sheetsDiscarded;
+}
+#endif
+
+} // namespace WebCore
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CSSPreparser_h
+#define CSSPreparser_h
+
+#include "CSSParser.h"
+#include "PlatformString.h"
+#include "ScriptExecutionContext.h"
+#include "TextResourceDecoder.h"
+#include <wtf/MessageQueue.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+class CachedCSSStyleSheet;
+
+// Decodes one style sheet and finds its blocks on the preparser thread. The
+// parse that creates the rules stays on the main thread, since selectors,
+// property values and the strings they atomize all belong to it; what the
+// preparser thread hands over is plain text and offsets, which the main
+// thread parse uses to skip over declaration blocks without tokenizing them.
+class CSSPreparseJob : public ThreadSafeRefCounted<CSSPreparseJob> {
+public:
+    static PassRefPtr<CSSPreparseJob> create(CachedCSSStyleSheet* client, PassRefPtr<TextResourceDecoder> decoder, const char* data, size_t length)
+    {
+        return adoptRef(new CSSPreparseJob(client, decoder, data, length));
+    }
+
+    ~CSSPreparseJob();
+
+    // Main thread only. The style sheet is no longer told when the job finishes.
+    void cancel() { m_client = 0; }
+
+    // Main thread only, once the client has been told that the job finished.
+    PassRefPtr<TextResourceDecoder> releaseDecoder();
+    String releaseSheetText();
+    const Vector<CSSBlockExtent>& blocks() const { return m_blocks; }
+
+private:
+    friend class CSSPreparser;
+
+    CSSPreparseJob(CachedCSSStyleSheet*, PassRefPtr<TextResourceDecoder>, const char* data, size_t length);
+
+    void run();
+
+    // Only touched on the main thread.
+    CachedCSSStyleSheet* m_client;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    bool m_adopted;
+    double m_copyTime;
+#endif
+
+    // Only touched on the preparser thread until the job has finished.
+    RefPtr<TextResourceDecoder> m_decoder;
+    Vector<char> m_data;
+    String m_sheetText;
+    Vector<CSSBlockExtent> m_blocks;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double m_decodeTime;
+#endif
+};
+
+// Owns the thread that decodes and scans large style sheets as soon as they
+// finish loading, rather than leaving all of it to the main thread when the
+// sheet is parsed.
+class CSSPreparser {
+public:
+    static CSSPreparser* instance();
+
+    static void setEnabled(bool enabled) { s_enabled = enabled; }
+    static bool isEnabled() { return s_enabled; }
+
+    // Copies the data. The client's didFinishPreparse() is called on the main thread once the job finishes.
+    PassRefPtr<CSSPreparseJob> preparse(CachedCSSStyleSheet*, const TextResourceDecoder*, const char* data, size_t length);
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    struct Statistics {
+        Statistics()
+            : sheetsPreparsed(0)
+            , sheetsAdopted(0)
+            , sheetsDiscarded(0)
+            , decodeTime(0)
+            , scanTime(0)
+            , mainThreadTimeSaved(0)
+        {
+        }
+
+        unsigned sheetsPreparsed;
+        unsigned sheetsAdopted;
+        unsigned sheetsDiscarded;
+        // Seconds spent on the preparser thread.
+        double decodeTime;
+        double scanTime;
+        // Decode time of the adopted sheets, less the time the main thread
+        // spent copying their data. Declaration blocks the main thread skipped
+        // without tokenizing them come on top of this.
+        double mainThreadTimeSaved;
+    };
+
+    Statistics statistics();
+#endif
+
+private:
+    friend class CSSPreparseJob;
+
+    CSSPreparser();
+
+    void startBackgroundThread();
+    static void* threadEntryPoint(void* object);
+    void threadEntryPointImpl();
+    static void preparseOnBackgroundThread(ScriptExecutionContext*, PassRefPtr<CSSPreparseJob>);
+    static void didFinishOnMainThread(void* job);
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    void didPreparse(double decodeTime, double scanTime);
+    void didAdopt(double decodeTime, double copyTime);
+    void didDiscard();
+#endif
+
+    static bool s_enabled;
+
+    ThreadIdentifier m_threadId;
+    MessageQueue<ScriptExecutionContext::Task> m_queue;
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    Statistics m_statistics;
+    Mutex m_statisticsMutex;
+#endif
+};
+
+} // namespace WebCore
+
+#endif // CSSPreparser_h
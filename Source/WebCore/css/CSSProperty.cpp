@@ -282,4 +282,113 @@ int CSSProperty::resolveDirectionAwareProperty(int propertyID, TextDirection dir
     }
 }
 
+bool CSSProperty::isInheritedProperty(int propertyID)
+{
+    switch (static_cast<CSSPropertyID>(propertyID)) {
+    case CSSPropertyBorderCollapse:
+    case CSSPropertyBorderSpacing:
+    case CSSPropertyCaptionSide:
+    case CSSPropertyColor:
+    case CSSPropertyCursor:
+    case CSSPropertyDirection:
+    case CSSPropertyEmptyCells:
+    case CSSPropertyFont:
+    case CSSPropertyFontFamily:
+    case CSSPropertyFontSize:
+    case CSSPropertyFontStretch:
+    case CSSPropertyFontStyle:
+    case CSSPropertyFontVariant:
+    case CSSPropertyFontWeight:
+    case CSSPropertyLetterSpacing:
+    case CSSPropertyLineHeight:
+    case CSSPropertyListStyle:
+    case CSSPropertyListStyleImage:
+    case CSSPropertyListStylePosition:
+    case CSSPropertyListStyleType:
+    case CSSPropertyOrphans:
+    case CSSPropertyPointerEvents:
+    case CSSPropertyQuotes:
+    case CSSPropertyResize:
+    case CSSPropertySpeak:
+    case CSSPropertyTextAlign:
+    case CSSPropertyTextIndent:
+    case CSSPropertyTextRendering:
+    case CSSPropertyTextShadow:
+    case CSSPropertyTextTransform:
+    case CSSPropertyVisibility:
+    case CSSPropertyWhiteSpace:
+    case CSSPropertyWidows:
+    case CSSPropertyWordBreak:
+    case CSSPropertyWordSpacing:
+    case CSSPropertyWordWrap:
+    // zoom is not inherited, but it sets the effective zoom, which is.
+    case CSSPropertyZoom:
+    case CSSPropertyWebkitBorderHorizontalSpacing:
+    case CSSPropertyWebkitBorderVerticalSpacing:
+    case CSSPropertyWebkitBoxDirection:
+    case CSSPropertyWebkitColorCorrection:
+    case CSSPropertyWebkitFontSizeDelta:
+    case CSSPropertyWebkitFontSmoothing:
+    case CSSPropertyWebkitHighlight:
+    case CSSPropertyWebkitHyphenateCharacter:
+    case CSSPropertyWebkitHyphenateLimitAfter:
+    case CSSPropertyWebkitHyphenateLimitBefore:
+    case CSSPropertyWebkitHyphens:
+    case CSSPropertyWebkitLineBoxContain:
+    case CSSPropertyWebkitLineBreak:
+    case CSSPropertyWebkitLocale:
+    case CSSPropertyWebkitNbspMode:
+    case CSSPropertyWebkitRtlOrdering:
+    case CSSPropertyWebkitTextDecorationsInEffect:
+    case CSSPropertyWebkitTextEmphasis:
+    case CSSPropertyWebkitTextEmphasisColor:
+    case CSSPropertyWebkitTextEmphasisPosition:
+    case CSSPropertyWebkitTextEmphasisStyle:
+    case CSSPropertyWebkitTextFillColor:
+    case CSSPropertyWebkitTextOrientation:
+    case CSSPropertyWebkitTextSecurity:
+    case CSSPropertyWebkitTextSizeAdjust:
+    case CSSPropertyWebkitTextStroke:
+    case CSSPropertyWebkitTextStrokeColor:
+    case CSSPropertyWebkitTextStrokeWidth:
+    case CSSPropertyWebkitUserModify:
+    case CSSPropertyWebkitUserSelect:
+    case CSSPropertyWebkitWritingMode:
+#ifdef ANDROID_CSS_TAP_HIGHLIGHT_COLOR
+    case CSSPropertyWebkitTapHighlightColor:
+#endif
+#if ENABLE(SVG)
+    case CSSPropertyClipRule:
+    case CSSPropertyColorInterpolation:
+    case CSSPropertyColorInterpolationFilters:
+    case CSSPropertyColorRendering:
+    case CSSPropertyFill:
+    case CSSPropertyFillOpacity:
+    case CSSPropertyFillRule:
+    case CSSPropertyGlyphOrientationHorizontal:
+    case CSSPropertyGlyphOrientationVertical:
+    case CSSPropertyImageRendering:
+    case CSSPropertyKerning:
+    case CSSPropertyMarker:
+    case CSSPropertyMarkerEnd:
+    case CSSPropertyMarkerMid:
+    case CSSPropertyMarkerStart:
+    case CSSPropertyShapeRendering:
+    case CSSPropertyStroke:
+    case CSSPropertyStrokeDasharray:
+    case CSSPropertyStrokeDashoffset:
+    case CSSPropertyStrokeLinecap:
+    case CSSPropertyStrokeLinejoin:
+    case CSSPropertyStrokeMiterlimit:
+    case CSSPropertyStrokeOpacity:
+    case CSSPropertyStrokeWidth:
+    case CSSPropertyTextAnchor:
+    case CSSPropertyWritingMode:
+#endif
+        return true;
+    default:
+        return false;
+    }
+}
+
 } // namespace WebCore
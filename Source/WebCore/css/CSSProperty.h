@@ -62,6 +62,8 @@ public:
     String cssText() const;
 
     static int resolveDirectionAwareProperty(int propertyID, TextDirection, WritingMode);
+    // Whether RenderStyle keeps the computed value in data that children inherit.
+    static bool isInheritedProperty(int propertyID);
 
     friend bool operator==(const CSSProperty&, const CSSProperty&);
 
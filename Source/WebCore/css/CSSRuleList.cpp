@@ -24,6 +24,7 @@
 
 #include "CSSMutableStyleDeclaration.h"
 #include "CSSRule.h"
+#include "CSSStyleRule.h"
 #include "StyleList.h"
 #include "WebKitCSSKeyframeRule.h"
 
@@ -83,6 +84,7 @@ void CSSRuleList::deleteRule(unsigned index)
             style->setParent(0);
     }
 
+    CSSStyleRule::parseDeclarationsBeforeDetaching(m_lstCSSRules[index].get());
     m_lstCSSRules[index]->setParent(0);
     m_lstCSSRules.remove(index);
 }
@@ -22,18 +22,23 @@
 #include "config.h"
 #include "CSSStyleRule.h"
 
+#include "CSSMediaRule.h"
 #include "CSSMutableStyleDeclaration.h"
 #include "CSSParser.h"
+#include "CSSRuleList.h"
 #include "CSSSelector.h"
 #include "CSSStyleSheet.h"
 #include "Document.h"
 #include "StyleSheet.h"
+#include <wtf/CurrentTime.h>
 
 namespace WebCore {
 
 CSSStyleRule::CSSStyleRule(CSSStyleSheet* parent, int sourceLine)
     : CSSRule(parent)
     , m_sourceLine(sourceLine)
+    , m_unparsedDeclarationsStart(0)
+    , m_unparsedDeclarationsLength(0)
 {
 }
 
@@ -57,7 +62,7 @@ String CSSStyleRule::selectorText() const
 void CSSStyleRule::setSelectorText(const String& selectorText)
 {
     Document* doc = 0;
-    StyleSheet* ownerStyleSheet = m_style->stylesheet();
+    StyleSheet* ownerStyleSheet = style()->stylesheet();
     if (ownerStyleSheet) {
         if (ownerStyleSheet->isCSSStyleSheet())
             doc = static_cast<CSSStyleSheet*>(ownerStyleSheet)->document();
@@ -89,7 +94,7 @@ String CSSStyleRule::cssText() const
     String result = selectorText();
 
     result += " { ";
-    result += m_style->cssText();
+    result += style()->cssText();
     result += "}";
 
     return result;
@@ -103,13 +108,70 @@ bool CSSStyleRule::parseString(const String& /*string*/, bool /*strict*/)
 
 void CSSStyleRule::setDeclaration(PassRefPtr<CSSMutableStyleDeclaration> style)
 {
+    m_unparsedDeclarations = String();
     m_style = style;
 }
 
+void CSSStyleRule::setUnparsedDeclarations(const String& sheetText, unsigned start, unsigned length)
+{
+    ASSERT(!sheetText.isNull());
+    ASSERT(start + length <= sheetText.length());
+    m_style = 0;
+    m_unparsedDeclarations = sheetText;
+    m_unparsedDeclarationsStart = start;
+    m_unparsedDeclarationsLength = length;
+}
+
+void CSSStyleRule::parseDeclarations() const
+{
+    ASSERT(!m_unparsedDeclarations.isNull());
+    String declarations = m_unparsedDeclarations.substring(m_unparsedDeclarationsStart, m_unparsedDeclarationsLength);
+    m_unparsedDeclarations = String();
+
+    m_style = CSSMutableStyleDeclaration::create(const_cast<CSSStyleRule*>(this));
+
+    // Relative URLs resolve against the style sheet, and parsing depends on its mode.
+    // parseDeclarationsBeforeDetaching() parses the block of every rule that can be
+    // reached after its style sheet is gone, so this only happens to rules that nothing
+    // can use anymore.
+    ASSERT(parentStyleSheet());
+    if (!parentStyleSheet())
+        return;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double startTime = currentTime();
+#endif
+    CSSParser p(useStrictParsing());
+    p.parseDeclaration(m_style.get(), declarations);
+#if ENABLE(PERFORMANCE_STATISTICS)
+    CSSParser::didParseSkippedDeclarationBlock(currentTime() - startTime);
+#endif
+}
+
+static void parseReferencedDeclarations(StyleBase* rule, bool referenced)
+{
+    referenced = referenced || !rule->hasOneRef();
+    if (rule->isStyleRule()) {
+        if (referenced)
+            static_cast<CSSStyleRule*>(rule)->style();
+    } else if (rule->isMediaRule()) {
+        CSSRuleList* rules = static_cast<CSSMediaRule*>(rule)->cssRules();
+        if (!rules)
+            return;
+        referenced = referenced || !rules->hasOneRef();
+        for (unsigned i = 0; i < rules->length(); ++i)
+            parseReferencedDeclarations(rules->item(i), referenced);
+    }
+}
+
+void CSSStyleRule::parseDeclarationsBeforeDetaching(StyleBase* rule)
+{
+    parseReferencedDeclarations(rule, false);
+}
+
 void CSSStyleRule::addSubresourceStyleURLs(ListHashSet<KURL>& urls)
 {
-    if (m_style)
-        m_style->addSubresourceStyleURLs(urls);
+    if (CSSMutableStyleDeclaration* style = this->style())
+        style->addSubresourceStyleURLs(urls);
 }
 
 } // namespace WebCore
@@ -43,7 +43,12 @@ public:
     virtual String selectorText() const;
     void setSelectorText(const String&);
 
-    CSSMutableStyleDeclaration* style() const { return m_style.get(); }
+    CSSMutableStyleDeclaration* style() const
+    {
+        if (!m_unparsedDeclarations.isNull())
+            parseDeclarations();
+        return m_style.get();
+    }
 
     virtual String cssText() const;
 
@@ -52,9 +57,16 @@ public:
 
     void adoptSelectorVector(Vector<OwnPtr<CSSParserSelector> >& selectors) { m_selectorList.adoptSelectorVector(selectors); }
     void setDeclaration(PassRefPtr<CSSMutableStyleDeclaration>);
+    // The declaration block is the given range of the style sheet's text, and
+    // is parsed the first time the declaration is asked for.
+    void setUnparsedDeclarations(const String& sheetText, unsigned start, unsigned length);
+    // Called before a rule is detached from its style sheet. Parses the declaration blocks of the
+    // style rules, the rule itself or the ones in it, that are referenced from elsewhere and so can
+    // outlive the style sheet their relative URLs resolve against.
+    static void parseDeclarationsBeforeDetaching(StyleBase* rule);
 
     const CSSSelectorList& selectorList() const { return m_selectorList; }
-    CSSMutableStyleDeclaration* declaration() { return m_style.get(); }
+    CSSMutableStyleDeclaration* declaration() { return style(); }
 
     virtual void addSubresourceStyleURLs(ListHashSet<KURL>& urls);
 
@@ -69,9 +81,15 @@ private:
     // Inherited from CSSRule
     virtual unsigned short type() const { return STYLE_RULE; }
 
-    RefPtr<CSSMutableStyleDeclaration> m_style;
+    void parseDeclarations() const;
+
+    mutable RefPtr<CSSMutableStyleDeclaration> m_style;
     CSSSelectorList m_selectorList;
     int m_sourceLine;
+
+    mutable String m_unparsedDeclarations;
+    unsigned m_unparsedDeclarationsStart;
+    unsigned m_unparsedDeclarationsLength;
 };
 
 } // namespace WebCore
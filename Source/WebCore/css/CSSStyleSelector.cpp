@@ -67,6 +67,7 @@
 #include "Matrix3DTransformOperation.h"
 #include "MatrixTransformOperation.h"
 #include "MediaList.h"
+#include "MediaQuery.h"
 #include "MediaQueryEvaluator.h"
 #include "NodeRenderStyle.h"
 #include "Page.h"
@@ -82,6 +83,7 @@
 #include "RotateTransformOperation.h"
 #include "ScaleTransformOperation.h"
 #include "SelectionController.h"
+#include "SelectorCompiler.h"
 #include "Settings.h"
 #include "ShadowData.h"
 #include "ShadowValue.h"
@@ -89,6 +91,7 @@
 #include "StyleCachedImage.h"
 #include "StylePendingImage.h"
 #include "StyleGeneratedImage.h"
+#include "StyleInterner.h"
 #include "StyleSheetList.h"
 #include "Text.h"
 #include "TransformationMatrix.h"
@@ -99,6 +102,7 @@
 #include "WebKitCSSTransformValue.h"
 #include "XMLNames.h"
 #include <wtf/StdLibExtras.h>
+#include <wtf/StringHasher.h>
 #include <wtf/Vector.h>
 
 #if USE(PLATFORM_STRATEGIES)
@@ -288,9 +292,11 @@ if (id == propID) { \
 
 class RuleData {
 public:
-    RuleData(CSSStyleRule*, CSSSelector*, unsigned position);
+    RuleData(CSSStyleRule*, CSSSelector*, unsigned position, unsigned mediaQueryIndex = 0);
 
     unsigned position() const { return m_position; }
+    // Nonzero for a rule in an @media block whose query depends on the viewport, see CSSStyleSelector::addMediaQueryRules().
+    unsigned mediaQueryIndex() const { return m_mediaQueryIndex; }
     CSSStyleRule* rule() const { return m_rule; }
     CSSSelector* selector() const { return m_selector; }
     
@@ -298,6 +304,12 @@ public:
     bool hasMultipartSelector() const { return m_hasMultipartSelector; }
     bool hasTopSelectorMatchingHTMLBasedOnRuleHash() const { return m_hasTopSelectorMatchingHTMLBasedOnRuleHash; }
     unsigned specificity() const { return m_specificity; }
+
+#if ENABLE(CSS_SELECTOR_JIT)
+    // Compiles the selector the first time it is asked for.
+    bool hasCompiledSelector() const { return m_compiledSelector.compileIfNeeded(m_selector); }
+    SelectorCompiler::MatchResult matchCompiledSelector(const Element* element) const { return m_compiledSelector.match(element); }
+#endif
     
     // Try to balance between memory usage (there can be lots of RuleData objects) and good filtering performance.
     static const unsigned maximumIdentifierCount = 4;
@@ -310,12 +322,16 @@ private:
     CSSStyleRule* m_rule;
     CSSSelector* m_selector;
     unsigned m_specificity;
+    unsigned m_mediaQueryIndex;
     unsigned m_position : 29;
     bool m_hasFastCheckableSelector : 1;
     bool m_hasMultipartSelector : 1;
     bool m_hasTopSelectorMatchingHTMLBasedOnRuleHash : 1;
     // Use plain array instead of a Vector to minimize memory overhead.
     unsigned m_descendantSelectorIdentifierHashes[maximumIdentifierCount];
+#if ENABLE(CSS_SELECTOR_JIT)
+    mutable SelectorCompiler::CompiledSelector m_compiledSelector;
+#endif
 };
 
 class RuleSet {
@@ -353,6 +369,8 @@ public:
     Vector<RuleData> m_universalRules;
     Vector<RuleData> m_pageRules;
     unsigned m_ruleCount;
+    // Given to the rules being added from an @media block, see RuleData::mediaQueryIndex().
+    unsigned m_mediaQueryIndex;
     bool m_autoShrinkToFitEnabled;
 };
 
@@ -363,6 +381,7 @@ static RuleSet* defaultViewSourceStyle;
 static CSSStyleSheet* simpleDefaultStyleSheet;
     
 static RuleSet* siblingRulesInDefaultStyle;
+static CSSStyleSelector::SelectorFeaturePositionMap* attributePositionsInDefaultStyle;
 
 RenderStyle* CSSStyleSelector::s_styleNotYetAvailable;
 
@@ -383,6 +402,10 @@ static inline void collectSiblingRulesInDefaultStyle()
     ASSERT(features.idsInRules.isEmpty());
     delete siblingRulesInDefaultStyle;
     siblingRulesInDefaultStyle = features.siblingRules.leakPtr();
+    // The MathML sheet also uses attributes left of combinators, as in "mtable[rowalign=top] mtd".
+    if (!attributePositionsInDefaultStyle)
+        attributePositionsInDefaultStyle = new CSSStyleSelector::SelectorFeaturePositionMap;
+    attributePositionsInDefaultStyle->swap(features.attributePositions);
 }
 
 static inline void assertNoSiblingRulesInDefaultStyle()
@@ -435,6 +458,7 @@ CSSStyleSelector::CSSStyleSelector(Document* document, StyleSheetList* styleShee
     , m_element(0)
     , m_styledElement(0)
     , m_elementLinkState(NotInsideLink)
+    , m_hasExplicitlyInheritedProperties(false)
     , m_fontSelector(CSSFontSelector::create(document))
     , m_applyProperty(CSSStyleApplyProperty::sharedCSSStyleApplyProperty())
 {
@@ -757,6 +781,8 @@ void CSSStyleSelector::matchRulesForList(const Vector<RuleData>* rules, int& fir
     unsigned size = rules->size();
     for (unsigned i = 0; i < size; ++i) {
         const RuleData& ruleData = rules->at(i);
+        if (ruleData.mediaQueryIndex() && !mediaQueryRulesMatch(ruleData.mediaQueryIndex()))
+            continue;
         if (canUseFastReject && fastRejectSelector(ruleData))
             continue;
         if (checkSelector(ruleData)) {
@@ -1258,6 +1284,10 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* e, RenderStyl
 
     initElement(e);
     initForStyleResolve(e, defaultParent);
+#if ENABLE(PERFORMANCE_STATISTICS)
+    if (!matchVisitedPseudoClass)
+        ++m_styleInvalidationStatistics.elementsRecalculated;
+#endif
     if (allowSharing) {
         RenderStyle* sharedStyle = locateSharedStyle();
         if (sharedStyle)
@@ -1375,15 +1405,14 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* e, RenderStyl
     }
 #endif
 
-    int firstUARule = -1, lastUARule = -1;
-    int firstUserRule = -1, lastUserRule = -1;
-    int firstAuthorRule = -1, lastAuthorRule = -1;
-    matchUARules(firstUARule, lastUARule);
+    MatchRanges ranges;
+    bool hasInlineStyle = false;
+    matchUARules(ranges.firstUARule, ranges.lastUARule);
 
     if (!resolveForRootDefault) {
         // 4. Now we check user sheet rules.
         if (m_matchAuthorAndUserStyles)
-            matchRules(m_userStyle.get(), firstUserRule, lastUserRule, false);
+            matchRules(m_userStyle.get(), ranges.firstUserRule, ranges.lastUserRule, false);
 
         // 5. Now check author rules, beginning first with presentational attributes
         // mapped from HTML.
@@ -1395,9 +1424,9 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* e, RenderStyl
                 for (unsigned i = 0; i < map->length(); i++) {
                     Attribute* attr = map->attributeItem(i);
                     if (attr->isMappedAttribute() && attr->decl()) {
-                        lastAuthorRule = m_matchedDecls.size();
-                        if (firstAuthorRule == -1)
-                            firstAuthorRule = lastAuthorRule;
+                        ranges.lastAuthorRule = m_matchedDecls.size();
+                        if (ranges.firstAuthorRule == -1)
+                            ranges.firstAuthorRule = ranges.lastAuthorRule;
                         addMatchedDeclaration(attr->decl());
                     }
                 }
@@ -1411,9 +1440,9 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* e, RenderStyl
                 m_styledElement->additionalAttributeStyleDecls(m_additionalAttributeStyleDecls);
                 if (!m_additionalAttributeStyleDecls.isEmpty()) {
                     unsigned additionalDeclsSize = m_additionalAttributeStyleDecls.size();
-                    if (firstAuthorRule == -1)
-                        firstAuthorRule = m_matchedDecls.size();
-                    lastAuthorRule = m_matchedDecls.size() + additionalDeclsSize - 1;
+                    if (ranges.firstAuthorRule == -1)
+                        ranges.firstAuthorRule = m_matchedDecls.size();
+                    ranges.lastAuthorRule = m_matchedDecls.size() + additionalDeclsSize - 1;
                     for (unsigned i = 0; i < additionalDeclsSize; i++)
                         addMatchedDeclaration(m_additionalAttributeStyleDecls[i]);
                 }
@@ -1428,34 +1457,110 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* e, RenderStyl
     
         // 6. Check the rules in author sheets next.
         if (m_matchAuthorAndUserStyles)
-            matchRules(m_authorStyle.get(), firstAuthorRule, lastAuthorRule, false);
+            matchRules(m_authorStyle.get(), ranges.firstAuthorRule, ranges.lastAuthorRule, false);
 
         // 7. Now check our inline style attribute.
         if (m_matchAuthorAndUserStyles && m_styledElement) {
             CSSMutableStyleDeclaration* inlineDecl = m_styledElement->inlineStyleDecl();
             if (inlineDecl) {
-                lastAuthorRule = m_matchedDecls.size();
-                if (firstAuthorRule == -1)
-                    firstAuthorRule = lastAuthorRule;
+                ranges.lastAuthorRule = m_matchedDecls.size();
+                if (ranges.firstAuthorRule == -1)
+                    ranges.firstAuthorRule = ranges.lastAuthorRule;
                 addMatchedDeclaration(inlineDecl);
+                hasInlineStyle = true;
             }
         }
     }
 
     // Reset the value back before applying properties, so that -webkit-link knows what color to use.
     m_checker.m_matchVisitedPseudoClass = matchVisitedPseudoClass;
-    
+
+    // Inline style can be changed in place, and links and :visited get a second style, so
+    // neither is worth caching. Lengths in rem units are relative to the root element's style,
+    // so cached styles can't outlive it.
+    bool isRootElement = e == e->document()->documentElement();
+    if (isRootElement)
+        m_matchedPropertiesCache.clear();
+    unsigned cacheHash = 0;
+    if (!resolveForRootDefault && !matchVisitedPseudoClass && !visitedStyle && !hasInlineStyle && !isRootElement
+        && m_parentStyle != style() && !e->isLink() && m_style->insideLink() == NotInsideLink && !m_matchedDecls.isEmpty())
+        cacheHash = computeMatchedDeclarationsHash();
+
+    bool appliedFromCache = false;
+    if (const MatchedPropertiesCacheItem* cacheItem = cacheHash ? findFromMatchedPropertiesCache(cacheHash, ranges) : 0) {
+        RenderStyle* cachedStyle = cacheItem->renderStyle.get();
+        if (!m_parentStyle->inheritedNotEqual(cacheItem->parentRenderStyle.get())) {
+            // Same declarations applied to the same inherited values give the same style.
+            m_style->copyNonInheritedFrom(cachedStyle);
+            m_style->inheritFrom(cachedStyle);
+#if ENABLE(PERFORMANCE_STATISTICS)
+            ++m_matchedPropertiesCacheStatistics.hits;
+#endif
+            appliedFromCache = true;
+        } else {
+            // Only the inherited values can differ, unless the non-inherited ones were computed from something that changed.
+            applyMatchedDeclarations(ranges, resolveForRootDefault, true);
+            if (m_style->fontDescription() == cachedStyle->fontDescription()
+                && m_style->effectiveZoom() == cachedStyle->effectiveZoom()
+                && m_style->color() == cachedStyle->color()
+                && m_style->direction() == cachedStyle->direction()
+                && m_style->writingMode() == cachedStyle->writingMode()) {
+                m_style->copyNonInheritedFrom(cachedStyle);
+#if ENABLE(PERFORMANCE_STATISTICS)
+                ++m_matchedPropertiesCacheStatistics.inheritedOnlyHits;
+#endif
+                appliedFromCache = true;
+            }
+        }
+    }
+
+    if (!appliedFromCache) {
+        m_hasExplicitlyInheritedProperties = false;
+        applyMatchedDeclarations(ranges, resolveForRootDefault, false);
+    }
+
+    // Start loading images referenced by this style.
+    loadPendingImages();
+
+    // The cached style must not depend on the element, so add it before it is adjusted.
+    if (cacheHash && !appliedFromCache && isCacheableInMatchedPropertiesCache())
+        addToMatchedPropertiesCache(cacheHash, ranges);
+
+    // Clean up our style object's display and text decorations (among other fixups).
+    adjustRenderStyle(style(), m_parentStyle, e);
+
+    // If we have first-letter pseudo style, do not share this style
+    if (m_style->hasPseudoStyle(FIRST_LETTER))
+        m_style->setUnique();
+
+    if (visitedStyle) {
+        // Add the visited style off the main style.
+        m_style->addCachedPseudoStyle(visitedStyle.release());
+    }
+
+    // Share data with styles that were resolved to the same values separately.
+    StyleInterner::instance()->intern(m_style.get());
+
+    if (!matchVisitedPseudoClass)
+        initElement(0); // Clear out for the next resolve.
+
+    // Now return the style.
+    return m_style.release();
+}
+
+void CSSStyleSelector::applyMatchedDeclarations(const MatchRanges& ranges, bool resolveForRootDefault, bool inheritedOnly)
+{
     // Now we have all of the matched rules in the appropriate order.  Walk the rules and apply
     // high-priority properties first, i.e., those properties that other properties depend on.
     // The order is (1) high-priority not important, (2) high-priority important, (3) normal not important
     // and (4) normal important.
     m_lineHeightValue = 0;
-    applyDeclarations<true>(false, 0, m_matchedDecls.size() - 1);
+    applyDeclarations<true>(false, 0, m_matchedDecls.size() - 1, inheritedOnly);
     if (!resolveForRootDefault) {
-        applyDeclarations<true>(true, firstAuthorRule, lastAuthorRule);
-        applyDeclarations<true>(true, firstUserRule, lastUserRule);
+        applyDeclarations<true>(true, ranges.firstAuthorRule, ranges.lastAuthorRule, inheritedOnly);
+        applyDeclarations<true>(true, ranges.firstUserRule, ranges.lastUserRule, inheritedOnly);
     }
-    applyDeclarations<true>(true, firstUARule, lastUARule);
+    applyDeclarations<true>(true, ranges.firstUARule, ranges.lastUARule, inheritedOnly);
     
     // If our font got dirtied, go ahead and update it now.
     if (m_fontDirty)
@@ -1466,45 +1571,93 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* e, RenderStyl
         applyProperty(CSSPropertyLineHeight, m_lineHeightValue);
 
     // Now do the normal priority UA properties.
-    applyDeclarations<false>(false, firstUARule, lastUARule);
+    applyDeclarations<false>(false, ranges.firstUARule, ranges.lastUARule, inheritedOnly);
     
     // Cache our border and background so that we can examine them later.
-    cacheBorderAndBackground();
+    if (!inheritedOnly)
+        cacheBorderAndBackground();
     
     // Now do the author and user normal priority properties and all the !important properties.
     if (!resolveForRootDefault) {
-        applyDeclarations<false>(false, lastUARule + 1, m_matchedDecls.size() - 1);
-        applyDeclarations<false>(true, firstAuthorRule, lastAuthorRule);
-        applyDeclarations<false>(true, firstUserRule, lastUserRule);
+        applyDeclarations<false>(false, ranges.lastUARule + 1, m_matchedDecls.size() - 1, inheritedOnly);
+        applyDeclarations<false>(true, ranges.firstAuthorRule, ranges.lastAuthorRule, inheritedOnly);
+        applyDeclarations<false>(true, ranges.firstUserRule, ranges.lastUserRule, inheritedOnly);
     }
-    applyDeclarations<false>(true, firstUARule, lastUARule);
+    applyDeclarations<false>(true, ranges.firstUARule, ranges.lastUARule, inheritedOnly);
 
     ASSERT(!m_fontDirty);
     // If our font got dirtied by one of the non-essential font props, 
     // go ahead and update it a second time.
     if (m_fontDirty)
         updateFont();
-    
-    // Clean up our style object's display and text decorations (among other fixups).
-    adjustRenderStyle(style(), m_parentStyle, e);
+}
 
-    // Start loading images referenced by this style.
-    loadPendingImages();
+// Throwing the whole cache away once it is full is cheaper than keeping track of which entries are still useful.
+static const unsigned maximumMatchedPropertiesCacheSize = 512;
 
-    // If we have first-letter pseudo style, do not share this style
-    if (m_style->hasPseudoStyle(FIRST_LETTER))
-        m_style->setUnique();
+unsigned CSSStyleSelector::computeMatchedDeclarationsHash() const
+{
+    return StringHasher::hashMemory(m_matchedDecls.data(), m_matchedDecls.size() * sizeof(CSSMutableStyleDeclaration*));
+}
 
-    if (visitedStyle) {
-        // Add the visited style off the main style.
-        m_style->addCachedPseudoStyle(visitedStyle.release());
+const CSSStyleSelector::MatchedPropertiesCacheItem* CSSStyleSelector::findFromMatchedPropertiesCache(unsigned hash, const MatchRanges& ranges)
+{
+    ASSERT(hash);
+#if ENABLE(PERFORMANCE_STATISTICS)
+    ++m_matchedPropertiesCacheStatistics.lookups;
+#endif
+
+    MatchedPropertiesCache::iterator it = m_matchedPropertiesCache.find(hash);
+    if (it == m_matchedPropertiesCache.end())
+        return 0;
+    const MatchedPropertiesCacheItem& cacheItem = it->second;
+
+    size_t size = m_matchedDecls.size();
+    if (size != cacheItem.declarations.size() || ranges != cacheItem.ranges)
+        return 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (m_matchedDecls[i] != cacheItem.declarations[i].get())
+            return 0;
     }
+    return &cacheItem;
+}
 
-    if (!matchVisitedPseudoClass)
-        initElement(0); // Clear out for the next resolve.
+void CSSStyleSelector::addToMatchedPropertiesCache(unsigned hash, const MatchRanges& ranges)
+{
+    ASSERT(hash);
+    if (m_matchedPropertiesCache.size() >= maximumMatchedPropertiesCacheSize)
+        m_matchedPropertiesCache.clear();
 
-    // Now return the style.
-    return m_style.release();
+    MatchedPropertiesCacheItem cacheItem;
+    // Holding on to the declarations keeps their addresses from being reused by different ones.
+    cacheItem.declarations.reserveInitialCapacity(m_matchedDecls.size());
+    for (size_t i = 0; i < m_matchedDecls.size(); ++i)
+        cacheItem.declarations.append(m_matchedDecls[i]);
+    cacheItem.ranges = ranges;
+    // Clone both styles, since they will go on to be adjusted or changed in place.
+    cacheItem.renderStyle = RenderStyle::clone(m_style.get());
+    cacheItem.parentRenderStyle = RenderStyle::clone(m_parentStyle);
+    m_matchedPropertiesCache.set(hash, cacheItem);
+#if ENABLE(PERFORMANCE_STATISTICS)
+    ++m_matchedPropertiesCacheStatistics.additions;
+#endif
+}
+
+bool CSSStyleSelector::isCacheableInMatchedPropertiesCache() const
+{
+    // Unique styles depend on the element they were resolved for, through attr() or an SVG cursor.
+    if (m_style->unique())
+        return false;
+    // adjustRenderStyle() reads the border and background that were cached while applying these.
+    if (m_style->hasAppearance())
+        return false;
+    // zoom multiplies the inherited effective zoom, so it can't be reapplied on its own.
+    if (m_style->zoom() != RenderStyle::initialZoom())
+        return false;
+    // The value was copied from the parent's non-inherited data, which the cache doesn't look at.
+    if (m_hasExplicitlyInheritedProperties)
+        return false;
+    return true;
 }
 
 PassRefPtr<RenderStyle> CSSStyleSelector::styleForKeyframe(const RenderStyle* elementStyle, const WebKitCSSKeyframeRule* keyframeRule, KeyframeValue& keyframe)
@@ -2042,6 +2195,27 @@ PassRefPtr<CSSRuleList> CSSStyleSelector::pseudoStyleRulesForElement(Element* e,
     return m_ruleList.release();
 }
 
+#if ENABLE(CSS_SELECTOR_JIT)
+// The compiled code does not see the style being resolved, so do up front what the
+// SelectorChecker does when it checks the attribute selectors of the element itself.
+static inline void noteAttributeSelectorsForElement(const CSSSelector* selector, Element* element, RenderStyle* elementStyle, HashSet<AtomicStringImpl*>& selectorAttrs)
+{
+    if (!elementStyle)
+        return;
+    for (; selector; selector = selector->tagHistory()) {
+        if (selector->hasAttribute() && selector->m_match != CSSSelector::Id && selector->m_match != CSSSelector::Class) {
+            const QualifiedName& attr = selector->attribute();
+            if (!element->isStyledElement() || (!static_cast<StyledElement*>(element)->isMappedAttribute(attr) && attr != typeAttr && attr != readonlyAttr)) {
+                elementStyle->setAffectedByAttributeSelectors();
+                selectorAttrs.add(attr.localName().impl());
+            }
+        }
+        if (selector->relation() != CSSSelector::SubSelector)
+            break;
+    }
+}
+#endif
+
 inline bool CSSStyleSelector::checkSelector(const RuleData& ruleData)
 {
     m_dynamicPseudo = NOPSEUDO;
@@ -2055,9 +2229,28 @@ inline bool CSSStyleSelector::checkSelector(const RuleData& ruleData)
         // This is limited to HTML only so we don't need to check the namespace.
         if (ruleData.hasTopSelectorMatchingHTMLBasedOnRuleHash() && !ruleData.hasMultipartSelector() && m_element->isHTMLElement())
             return true;
+#if ENABLE(CSS_SELECTOR_JIT)
+        if (ruleData.hasCompiledSelector()) {
+            SelectorCompiler::MatchResult result = ruleData.matchCompiledSelector(m_element);
+            if (result != SelectorCompiler::CannotMatchNatively)
+                return result == SelectorCompiler::Matches;
+        }
+#endif
         return SelectorChecker::fastCheckSelector(ruleData.selector(), m_element);
     }
 
+#if ENABLE(CSS_SELECTOR_JIT)
+    if (!m_element->isSVGElement() && ruleData.hasCompiledSelector()) {
+        // Compiled selectors have no pseudo elements.
+        if (m_checker.m_pseudoStyle != NOPSEUDO)
+            return false;
+        noteAttributeSelectorsForElement(ruleData.selector(), m_element, style(), m_selectorAttrs);
+        SelectorCompiler::MatchResult result = ruleData.matchCompiledSelector(m_element);
+        if (result != SelectorCompiler::CannotMatchNatively)
+            return result == SelectorCompiler::Matches;
+    }
+#endif
+
     // Slow path.
     SelectorMatch match = m_checker.checkSelector(ruleData.selector(), m_element, &m_selectorAttrs, m_dynamicPseudo, false, false, style(), m_parentNode ? m_parentNode->renderStyle() : 0);
     if (match != SelectorMatches)
@@ -2368,6 +2561,70 @@ static bool htmlAttributeHasCaseInsensitiveValue(const QualifiedName& attr)
     return isPossibleHTMLAttr && htmlCaseInsensitiveAttributesSet->contains(attr.localName().impl());
 }
 
+bool CSSStyleSelector::SelectorChecker::checkAttributeValue(const Element* e, const CSSSelector* sel, bool documentIsHTML)
+{
+    const AtomicString& value = e->getAttribute(sel->attribute());
+    if (value.isNull())
+        return false; // attribute is not set
+
+    bool caseSensitive = !documentIsHTML || !htmlAttributeHasCaseInsensitiveValue(sel->attribute());
+
+    switch (sel->m_match) {
+    case CSSSelector::Exact:
+        if (caseSensitive ? sel->value() != value : !equalIgnoringCase(sel->value(), value))
+            return false;
+        break;
+    case CSSSelector::List:
+    {
+        // Ignore empty selectors or selectors containing spaces
+        if (sel->value().contains(' ') || sel->value().isEmpty())
+            return false;
+
+        unsigned startSearchAt = 0;
+        while (true) {
+            size_t foundPos = value.find(sel->value(), startSearchAt, caseSensitive);
+            if (foundPos == notFound)
+                return false;
+            if (foundPos == 0 || value[foundPos - 1] == ' ') {
+                unsigned endStr = foundPos + sel->value().length();
+                if (endStr == value.length() || value[endStr] == ' ')
+                    break; // We found a match.
+            }
+            
+            // No match. Keep looking.
+            startSearchAt = foundPos + 1;
+        }
+        break;
+    }
+    case CSSSelector::Contain:
+        if (!value.contains(sel->value(), caseSensitive) || sel->value().isEmpty())
+            return false;
+        break;
+    case CSSSelector::Begin:
+        if (!value.startsWith(sel->value(), caseSensitive) || sel->value().isEmpty())
+            return false;
+        break;
+    case CSSSelector::End:
+        if (!value.endsWith(sel->value(), caseSensitive) || sel->value().isEmpty())
+            return false;
+        break;
+    case CSSSelector::Hyphen:
+        if (value.length() < sel->value().length())
+            return false;
+        if (!value.startsWith(sel->value(), caseSensitive))
+            return false;
+        // It they start the same, check for exact match or following '-':
+        if (value.length() != sel->value().length() && value[sel->value().length()] != '-')
+            return false;
+        break;
+    case CSSSelector::PseudoClass:
+    case CSSSelector::PseudoElement:
+    default:
+        break;
+    }
+    return true;
+}
+
 bool CSSStyleSelector::SelectorChecker::checkOneSelector(CSSSelector* sel, Element* e, HashSet<AtomicStringImpl*>* selectorAttrs, PseudoId& dynamicPseudo, bool isSubSelector, bool encounteredLink, RenderStyle* elementStyle, RenderStyle* elementParentStyle) const
 {
     ASSERT(e);
@@ -2393,65 +2650,8 @@ bool CSSStyleSelector::SelectorChecker::checkOneSelector(CSSSelector* sel, Eleme
                 selectorAttrs->add(attr.localName().impl());
         }
 
-        const AtomicString& value = e->getAttribute(attr);
-        if (value.isNull())
-            return false; // attribute is not set
-
-        bool caseSensitive = !m_documentIsHTML || !htmlAttributeHasCaseInsensitiveValue(attr);
-
-        switch (sel->m_match) {
-        case CSSSelector::Exact:
-            if (caseSensitive ? sel->value() != value : !equalIgnoringCase(sel->value(), value))
-                return false;
-            break;
-        case CSSSelector::List:
-        {
-            // Ignore empty selectors or selectors containing spaces
-            if (sel->value().contains(' ') || sel->value().isEmpty())
-                return false;
-
-            unsigned startSearchAt = 0;
-            while (true) {
-                size_t foundPos = value.find(sel->value(), startSearchAt, caseSensitive);
-                if (foundPos == notFound)
-                    return false;
-                if (foundPos == 0 || value[foundPos - 1] == ' ') {
-                    unsigned endStr = foundPos + sel->value().length();
-                    if (endStr == value.length() || value[endStr] == ' ')
-                        break; // We found a match.
-                }
-                
-                // No match. Keep looking.
-                startSearchAt = foundPos + 1;
-            }
-            break;
-        }
-        case CSSSelector::Contain:
-            if (!value.contains(sel->value(), caseSensitive) || sel->value().isEmpty())
-                return false;
-            break;
-        case CSSSelector::Begin:
-            if (!value.startsWith(sel->value(), caseSensitive) || sel->value().isEmpty())
-                return false;
-            break;
-        case CSSSelector::End:
-            if (!value.endsWith(sel->value(), caseSensitive) || sel->value().isEmpty())
-                return false;
-            break;
-        case CSSSelector::Hyphen:
-            if (value.length() < sel->value().length())
-                return false;
-            if (!value.startsWith(sel->value(), caseSensitive))
-                return false;
-            // It they start the same, check for exact match or following '-':
-            if (value.length() != sel->value().length() && value[sel->value().length()] != '-')
-                return false;
-            break;
-        case CSSSelector::PseudoClass:
-        case CSSSelector::PseudoElement:
-        default:
-            break;
-        }
+        if (!checkAttributeValue(e, sel, m_documentIsHTML))
+            return false;
     }
     
     if (sel->m_match == CSSSelector::PseudoClass) {
@@ -3045,10 +3245,11 @@ static inline bool isSelectorMatchingHTMLBasedOnRuleHash(const CSSSelector* sele
     return selector->tag() == starAtom;
 }
 
-RuleData::RuleData(CSSStyleRule* rule, CSSSelector* selector, unsigned position)
+RuleData::RuleData(CSSStyleRule* rule, CSSSelector* selector, unsigned position, unsigned mediaQueryIndex)
     : m_rule(rule)
     , m_selector(selector)
     , m_specificity(selector->specificity())
+    , m_mediaQueryIndex(mediaQueryIndex)
     , m_position(position)
     , m_hasFastCheckableSelector(isFastCheckableSelector(selector))
     , m_hasMultipartSelector(selector->tagHistory())
@@ -3102,6 +3303,7 @@ inline void RuleData::collectDescendantSelectorIdentifierHashes()
 
 RuleSet::RuleSet()
     : m_ruleCount(0)
+    , m_mediaQueryIndex(0)
     , m_autoShrinkToFitEnabled(true)
 {
 }
@@ -3124,7 +3326,7 @@ void RuleSet::addToRuleSet(AtomicStringImpl* key, AtomRuleMap& map,
         rules = new Vector<RuleData>;
         map.set(key, rules);
     }
-    rules->append(RuleData(rule, sel, m_ruleCount++));
+    rules->append(RuleData(rule, sel, m_ruleCount++, m_mediaQueryIndex));
 }
 
 void RuleSet::addRule(CSSStyleRule* rule, CSSSelector* sel)
@@ -3157,6 +3359,33 @@ void RuleSet::addPageRule(CSSStyleRule* rule, CSSSelector* sel)
     m_pageRules.append(RuleData(rule, sel, m_pageRules.size()));
 }
 
+static bool canIndexMediaRule(CSSMediaRule* mediaRule)
+{
+    MediaList* mediaList = mediaRule->media();
+    if (!mediaList)
+        return false;
+
+    bool isViewportDependent = false;
+    const Vector<MediaQuery*>& queries = mediaList->mediaQueries();
+    for (size_t i = 0; i < queries.size() && !isViewportDependent; ++i) {
+        const Vector<OwnPtr<MediaQueryExp> >* expressions = queries[i]->expressions();
+        for (size_t j = 0; j < expressions->size() && !isViewportDependent; ++j)
+            isViewportDependent = expressions->at(j)->isViewportDependent();
+    }
+    if (!isViewportDependent)
+        return false;
+
+    // Only style rules can be turned on and off, so blocks with font faces, keyframes or pages are
+    // still evaluated up front, and a change to the viewport rebuilds the style selector.
+    CSSRuleList* rules = mediaRule->cssRules();
+    for (unsigned i = 0; i < rules->length(); ++i) {
+        CSSRule* rule = rules->item(i);
+        if (!rule->isStyleRule() || rule->isPageRule())
+            return false;
+    }
+    return true;
+}
+
 void RuleSet::addRulesFromSheet(CSSStyleSheet* sheet, const MediaQueryEvaluator& medium, CSSStyleSelector* styleSelector)
 {
     if (!sheet)
@@ -3182,7 +3411,14 @@ void RuleSet::addRulesFromSheet(CSSStyleSheet* sheet, const MediaQueryEvaluator&
             CSSMediaRule* r = static_cast<CSSMediaRule*>(item);
             CSSRuleList* rules = r->cssRules();
 
-            if ((!r->media() || medium.eval(r->media(), styleSelector)) && rules) {
+            if (styleSelector && rules && canIndexMediaRule(r)) {
+                // Index the rules whether they match now or not, so that a change to the viewport
+                // only needs to turn them on or off rather than build a new style selector.
+                m_mediaQueryIndex = styleSelector->addMediaQueryRules(r->media());
+                for (unsigned j = 0; j < rules->length(); j++)
+                    addStyleRule(static_cast<CSSStyleRule*>(rules->item(j)));
+                m_mediaQueryIndex = 0;
+            } else if ((!r->media() || medium.eval(r->media(), styleSelector)) && rules) {
                 // Traverse child elements of the @media rule.
                 for (unsigned j = 0; j < rules->length(); j++) {
                     CSSRule *childItem = rules->item(j);
@@ -3221,10 +3457,22 @@ void RuleSet::addStyleRule(CSSStyleRule* rule)
     }
 }
     
-static inline void collectFeaturesFromSelector(CSSStyleSelector::Features& features, const CSSSelector* selector)
+static inline void addFeaturePosition(CSSStyleSelector::SelectorFeaturePositionMap& map, AtomicStringImpl* name, unsigned position)
+{
+    pair<CSSStyleSelector::SelectorFeaturePositionMap::iterator, bool> result = map.add(name, position);
+    if (!result.second)
+        result.first->second |= position;
+}
+
+static inline void collectFeaturesFromSelector(CSSStyleSelector::Features& features, const CSSSelector* selector, unsigned position)
 {
-    if (selector->m_match == CSSSelector::Id && !selector->value().isEmpty())
+    if (selector->m_match == CSSSelector::Id && !selector->value().isEmpty()) {
         features.idsInRules.add(selector->value().impl());
+        addFeaturePosition(features.idPositions, selector->value().impl(), position);
+    } else if (selector->m_match == CSSSelector::Class && !selector->value().isEmpty())
+        addFeaturePosition(features.classPositions, selector->value().impl(), position);
+    else if (selector->hasAttribute())
+        addFeaturePosition(features.attributePositions, selector->attribute().localName().impl(), position);
     switch (selector->pseudoType()) {
     case CSSSelector::PseudoFirstLine:
         features.usesFirstLineRules = true;
@@ -3248,17 +3496,33 @@ static void collectFeaturesFromList(CSSStyleSelector::Features& features, const
     for (unsigned i = 0; i < size; ++i) {
         const RuleData& ruleData = rules[i];
         bool foundSiblingSelector = false;
+        unsigned position = CSSStyleSelector::SubjectPosition;
         for (CSSSelector* selector = ruleData.selector(); selector; selector = selector->tagHistory()) {
-            collectFeaturesFromSelector(features, selector);
+            collectFeaturesFromSelector(features, selector, position);
 
             if (CSSSelectorList* selectorList = selector->selectorList()) {
                 for (CSSSelector* subSelector = selectorList->first(); subSelector; subSelector = CSSSelectorList::next(subSelector)) {
                     if (selector->isSiblingSelector())
                         foundSiblingSelector = true;
-                    collectFeaturesFromSelector(features, subSelector);
+                    collectFeaturesFromSelector(features, subSelector, position);
                 }
             } else if (selector->isSiblingSelector())
                 foundSiblingSelector = true;
+
+            // Everything to the left of a combinator matches an ancestor or an earlier sibling of what is to its right.
+            switch (selector->relation()) {
+            case CSSSelector::Descendant:
+            case CSSSelector::Child:
+            case CSSSelector::ShadowDescendant:
+                position = (position & ~CSSStyleSelector::SubjectPosition) | CSSStyleSelector::AncestorPosition;
+                break;
+            case CSSSelector::DirectAdjacent:
+            case CSSSelector::IndirectAdjacent:
+                position = (position & ~CSSStyleSelector::SubjectPosition) | CSSStyleSelector::SiblingPosition;
+                break;
+            case CSSSelector::SubSelector:
+                break;
+            }
         }
         if (foundSiblingSelector) {
             if (!features.siblingRules)
@@ -3347,7 +3611,7 @@ static Length convertToFloatLength(CSSPrimitiveValue* primitiveValue, RenderStyl
 }
 
 template <bool applyFirst>
-void CSSStyleSelector::applyDeclarations(bool isImportant, int startIndex, int endIndex)
+void CSSStyleSelector::applyDeclarations(bool isImportant, int startIndex, int endIndex, bool inheritedOnly)
 {
     if (startIndex == -1)
         return;
@@ -3359,6 +3623,8 @@ void CSSStyleSelector::applyDeclarations(bool isImportant, int startIndex, int e
             const CSSProperty& current = *it;
             if (isImportant == current.isImportant()) {
                 int property = current.id();
+                if (inheritedOnly && !CSSProperty::isInheritedProperty(property))
+                    continue;
 
                 if (applyFirst) {
                     COMPILE_ASSERT(firstCSSProperty == CSSPropertyColor, CSS_color_is_first_property);
@@ -3573,6 +3839,9 @@ void CSSStyleSelector::applyProperty(int id, CSSValue *value)
     
     CSSPropertyID property = static_cast<CSSPropertyID>(id);
 
+    if (isInherit && !CSSProperty::isInheritedProperty(id))
+        m_hasExplicitlyInheritedProperties = true;
+
     // check lookup table for implementations and use when available
     if (m_applyProperty.implements(property)) {
         if (isInherit)
@@ -5893,6 +6162,8 @@ void CSSStyleSelector::applyProperty(int id, CSSValue *value)
         return;
 #if ENABLE(WCSS)
     case CSSPropertyWapInputFormat:
+        // These are applied to the element rather than the style, so the style can't be reused.
+        m_style->setUnique();
         if (primitiveValue && m_element->hasTagName(WebCore::inputTag)) {
             String mask = primitiveValue->getStringValue();
             static_cast<HTMLInputElement*>(m_element)->setWapInputFormat(mask);
@@ -5900,6 +6171,7 @@ void CSSStyleSelector::applyProperty(int id, CSSValue *value)
         return;
 
     case CSSPropertyWapInputRequired:
+        m_style->setUnique();
         if (primitiveValue && m_element->isFormControlElement()) {
             HTMLFormControlElement* element = static_cast<HTMLFormControlElement*>(m_element);
             bool required = primitiveValue->getStringValue() == "true";
@@ -7018,6 +7290,101 @@ bool CSSStyleSelector::hasSelectorForAttribute(const AtomicString &attrname) con
     return m_selectorAttrs.contains(attrname.impl());
 }
 
+static inline unsigned featurePositions(const CSSStyleSelector::SelectorFeaturePositionMap& map, const AtomicString& name)
+{
+    if (name.isEmpty())
+        return 0;
+    CSSStyleSelector::SelectorFeaturePositionMap::const_iterator it = map.find(name.impl());
+    return it == map.end() ? 0 : it->second;
+}
+
+static const unsigned allSelectorFeaturePositions = CSSStyleSelector::SubjectPosition | CSSStyleSelector::AncestorPosition | CSSStyleSelector::SiblingPosition;
+
+void CSSStyleSelector::invalidateStyleForClassChange(StyledElement* element, const Vector<AtomicString>& oldClasses)
+{
+    // The view source sheet is the only user agent sheet with class selectors.
+    if (m_checker.m_document->usesViewSourceStyles()) {
+        invalidateStyle(element, allSelectorFeaturePositions);
+        return;
+    }
+
+    unsigned positions = 0;
+    if (element->hasClass()) {
+        const SpaceSplitString& newClasses = element->classNames();
+        for (size_t i = 0; i < newClasses.size(); ++i) {
+            if (!oldClasses.contains(newClasses[i]))
+                positions |= featurePositions(m_features.classPositions, newClasses[i]);
+        }
+        for (size_t i = 0; i < oldClasses.size(); ++i) {
+            if (!newClasses.contains(oldClasses[i]))
+                positions |= featurePositions(m_features.classPositions, oldClasses[i]);
+        }
+    } else {
+        for (size_t i = 0; i < oldClasses.size(); ++i)
+            positions |= featurePositions(m_features.classPositions, oldClasses[i]);
+    }
+    invalidateStyle(element, positions);
+}
+
+void CSSStyleSelector::invalidateStyleForIdChange(Element* element, const AtomicString& oldId)
+{
+    const AtomicString& newId = element->hasID() ? element->idForStyleResolution() : nullAtom;
+    if (oldId == newId) {
+        invalidateStyle(element, 0);
+        return;
+    }
+    invalidateStyle(element, featurePositions(m_features.idPositions, oldId) | featurePositions(m_features.idPositions, newId));
+}
+
+void CSSStyleSelector::invalidateStyleForAttributeChange(Element* element, const AtomicString& attributeName)
+{
+    unsigned positions = featurePositions(m_features.attributePositions, attributeName);
+    // An author rule may use the attribute only in the subject while a user agent rule uses it on an ancestor.
+    if (attributePositionsInDefaultStyle)
+        positions |= featurePositions(*attributePositionsInDefaultStyle, attributeName);
+    // Not in any rule we collected, so a user agent rule or an attr() function depends on it.
+    if (!positions)
+        positions = SubjectPosition | AncestorPosition;
+    invalidateStyle(element, positions);
+}
+
+void CSSStyleSelector::invalidateStyle(Element* element, unsigned positions)
+{
+#if ENABLE(PERFORMANCE_STATISTICS)
+    ++m_styleInvalidationStatistics.mutations;
+    if (!positions)
+        ++m_styleInvalidationStatistics.mutationsIgnored;
+#endif
+    if (!positions)
+        return;
+
+    // A full style change restyles the whole subtree; an inline style change restyles just the
+    // element, and its children only if something they inherit changed.
+    if (positions & AncestorPosition) {
+        element->setNeedsStyleRecalc(FullStyleChange);
+#if ENABLE(PERFORMANCE_STATISTICS)
+        ++m_styleInvalidationStatistics.subtreeInvalidations;
+#endif
+    } else if (positions & SubjectPosition) {
+        element->setNeedsStyleRecalc(InlineStyleChange);
+#if ENABLE(PERFORMANCE_STATISTICS)
+        ++m_styleInvalidationStatistics.elementInvalidations;
+#endif
+    }
+
+    if (positions & SiblingPosition) {
+        // With ".a + .b .c" the later siblings' descendants can be affected too.
+        StyleChangeType siblingChangeType = positions & AncestorPosition ? FullStyleChange : InlineStyleChange;
+        for (Node* sibling = element->nextSibling(); sibling; sibling = sibling->nextSibling()) {
+            if (sibling->isElementNode())
+                sibling->setNeedsStyleRecalc(siblingChangeType);
+        }
+#if ENABLE(PERFORMANCE_STATISTICS)
+        ++m_styleInvalidationStatistics.siblingInvalidations;
+#endif
+    }
+}
+
 void CSSStyleSelector::addViewportDependentMediaQueryResult(const MediaQueryExp* expr, bool result)
 {
     m_viewportDependentMediaQueryResults.append(new MediaQueryResult(*expr, result));
@@ -7033,6 +7400,31 @@ bool CSSStyleSelector::affectedByViewportChange() const
     return false;
 }
 
+unsigned CSSStyleSelector::addMediaQueryRules(MediaList* mediaList)
+{
+    pair<HashMap<String, unsigned>::iterator, bool> result = m_mediaQueryRulesIndices.add(mediaList->mediaText(), m_mediaQueryRules.size() + 1);
+    if (result.second) {
+        MediaQueryRules rules;
+        rules.mediaList = mediaList;
+        rules.result = m_medium->eval(mediaList);
+        m_mediaQueryRules.append(rules);
+    }
+    return result.first->second;
+}
+
+bool CSSStyleSelector::updateMediaQueryRules()
+{
+    bool changed = false;
+    for (size_t i = 0; i < m_mediaQueryRules.size(); ++i) {
+        bool result = m_medium->eval(m_mediaQueryRules[i].mediaList.get());
+        if (result != m_mediaQueryRules[i].result) {
+            m_mediaQueryRules[i].result = result;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
 void CSSStyleSelector::SelectorChecker::allVisitedStateChanged()
 {
     if (m_linksCheckedForVisitedState.isEmpty())
@@ -58,6 +58,7 @@ class FrameView;
 class KURL;
 class KeyframeList;
 class KeyframeValue;
+class MediaList;
 class MediaQueryEvaluator;
 class Node;
 class RuleData;
@@ -172,6 +173,14 @@ public:
 
         bool affectedByViewportChange() const;
 
+        // The style rules of an @media rule whose query depends on the viewport are indexed whether
+        // the query matches or not, and are only matched while it does. Blocks with the same query
+        // share an index, which is never 0.
+        unsigned addMediaQueryRules(MediaList*);
+        bool mediaQueryRulesMatch(unsigned index) const { return m_mediaQueryRules[index - 1].result; }
+        // Evaluates each distinct query again, and returns whether any of the results changed.
+        bool updateMediaQueryRules();
+
         void allVisitedStateChanged() { m_checker.allVisitedStateChanged(); }
         void visitedStateChanged(LinkHash visitedHash) { m_checker.visitedStateChanged(visitedHash); }
 
@@ -185,10 +194,78 @@ public:
 
         static bool createTransformOperations(CSSValue* inValue, RenderStyle* inStyle, RenderStyle* rootStyle, TransformOperations& outOperations);
 
+#if ENABLE(PERFORMANCE_STATISTICS)
+        struct MatchedPropertiesCacheStatistics {
+            MatchedPropertiesCacheStatistics()
+                : lookups(0)
+                , hits(0)
+                , inheritedOnlyHits(0)
+                , additions(0)
+            {
+            }
+
+            unsigned lookups;
+            // Styles copied whole from the cache.
+            unsigned hits;
+            // Styles that took their non-inherited properties from the cache and applied only the inherited ones.
+            unsigned inheritedOnlyHits;
+            unsigned additions;
+        };
+
+        const MatchedPropertiesCacheStatistics& matchedPropertiesCacheStatistics() const { return m_matchedPropertiesCacheStatistics; }
+#endif
+
+        // These mark for recalculation only the elements that a rule using one of the changed
+        // classes, ids or attributes could match: nothing, the element, its subtree, or its later
+        // siblings and their subtrees.
+        void invalidateStyleForClassChange(StyledElement*, const Vector<AtomicString>& oldClasses);
+        void invalidateStyleForIdChange(Element*, const AtomicString& oldId);
+        void invalidateStyleForAttributeChange(Element*, const AtomicString& attributeName);
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+        struct StyleInvalidationStatistics {
+            StyleInvalidationStatistics()
+                : mutations(0)
+                , mutationsIgnored(0)
+                , elementInvalidations(0)
+                , subtreeInvalidations(0)
+                , siblingInvalidations(0)
+                , elementsRecalculated(0)
+            {
+            }
+
+            // Class, id and attribute changes seen by the invalidate functions above.
+            unsigned mutations;
+            // Changes that no rule depends on.
+            unsigned mutationsIgnored;
+            unsigned elementInvalidations;
+            unsigned subtreeInvalidations;
+            unsigned siblingInvalidations;
+            // Calls to styleForElement() that resolved a style, which divided by mutations gives the recalc cost of each.
+            unsigned elementsRecalculated;
+        };
+
+        const StyleInvalidationStatistics& styleInvalidationStatistics() const { return m_styleInvalidationStatistics; }
+#endif
+
+        // Where a class, id or attribute appears in a selector: in the part that matches the element
+        // itself, in a part that matches one of its ancestors, or in a part that matches an earlier sibling.
+        enum SelectorFeaturePosition {
+            SubjectPosition = 1 << 0,
+            AncestorPosition = 1 << 1,
+            SiblingPosition = 1 << 2
+        };
+        typedef HashMap<AtomicStringImpl*, unsigned> SelectorFeaturePositionMap;
+
         struct Features {
             Features();
             ~Features();
             HashSet<AtomicStringImpl*> idsInRules;
+            // Each entry is a combination of SelectorFeaturePosition bits. The user agent sheets are not included;
+            // the attribute positions of the MathML sheet are kept separately.
+            SelectorFeaturePositionMap classPositions;
+            SelectorFeaturePositionMap idPositions;
+            SelectorFeaturePositionMap attributePositions;
             OwnPtr<RuleSet> siblingRules;
             bool usesFirstLineRules;
             bool usesBeforeAfterRules;
@@ -215,8 +292,53 @@ public:
         
         bool checkSelector(const RuleData&);
 
+        // Where the UA, user and author declarations begin and end in m_matchedDecls.
+        struct MatchRanges {
+            MatchRanges()
+                : firstUARule(-1)
+                , lastUARule(-1)
+                , firstUserRule(-1)
+                , lastUserRule(-1)
+                , firstAuthorRule(-1)
+                , lastAuthorRule(-1)
+            {
+            }
+
+            bool operator==(const MatchRanges& other) const
+            {
+                return firstUARule == other.firstUARule && lastUARule == other.lastUARule
+                    && firstUserRule == other.firstUserRule && lastUserRule == other.lastUserRule
+                    && firstAuthorRule == other.firstAuthorRule && lastAuthorRule == other.lastAuthorRule;
+            }
+            bool operator!=(const MatchRanges& other) const { return !(*this == other); }
+
+            int firstUARule;
+            int lastUARule;
+            int firstUserRule;
+            int lastUserRule;
+            int firstAuthorRule;
+            int lastAuthorRule;
+        };
+
         template <bool firstPass>
-        void applyDeclarations(bool important, int startIndex, int endIndex);
+        void applyDeclarations(bool important, int startIndex, int endIndex, bool inheritedOnly = false);
+        void applyMatchedDeclarations(const MatchRanges&, bool resolveForRootDefault, bool inheritedOnly);
+
+        // Elements that match the same declarations, in the same order, get the same non-inherited
+        // property values as long as the inherited values they are computed from (font size, zoom,
+        // color, direction and writing mode) are also the same. The cache is keyed by the matched
+        // declarations and remembers the style they produced along with the parent style it inherited.
+        struct MatchedPropertiesCacheItem {
+            Vector<RefPtr<CSSMutableStyleDeclaration> > declarations;
+            MatchRanges ranges;
+            RefPtr<RenderStyle> renderStyle;
+            RefPtr<RenderStyle> parentRenderStyle;
+        };
+
+        unsigned computeMatchedDeclarationsHash() const;
+        const MatchedPropertiesCacheItem* findFromMatchedPropertiesCache(unsigned hash, const MatchRanges&);
+        void addToMatchedPropertiesCache(unsigned hash, const MatchRanges&);
+        bool isCacheableInMatchedPropertiesCache() const;
 
         void matchPageRules(RuleSet*, bool isLeftPage, bool isFirstPage, const String& pageName);
         void matchPageRulesForList(const Vector<RuleData>*, bool isLeftPage, bool isFirstPage, const String& pageName);
@@ -263,6 +385,8 @@ public:
             bool checkOneSelector(CSSSelector*, Element*, HashSet<AtomicStringImpl*>* selectorAttrs, PseudoId& dynamicPseudo, bool isSubSelector, bool encounteredLink, RenderStyle*, RenderStyle* elementParentStyle) const;
             bool checkScrollbarPseudoClass(CSSSelector*, PseudoId& dynamicPseudo) const;
             static bool fastCheckSelector(const CSSSelector*, const Element*);
+            // Matches an attribute selector other than an id or class one against the value of the attribute.
+            static bool checkAttributeValue(const Element*, const CSSSelector*, bool documentIsHTML);
 
             EInsideLink determineLinkState(Element* element) const;
             EInsideLink determineLinkStateSlowCase(Element* element) const;
@@ -354,12 +478,32 @@ public:
         CSSValue* m_lineHeightValue;
         bool m_fontDirty;
         bool m_matchAuthorAndUserStyles;
+        // Set when a non-inherited property is given the value "inherit", which makes the style depend on more than the parent's inherited data.
+        bool m_hasExplicitlyInheritedProperties;
+
+        typedef HashMap<unsigned, MatchedPropertiesCacheItem> MatchedPropertiesCache;
+        MatchedPropertiesCache m_matchedPropertiesCache;
+#if ENABLE(PERFORMANCE_STATISTICS)
+        MatchedPropertiesCacheStatistics m_matchedPropertiesCacheStatistics;
+#endif
+
+        void invalidateStyle(Element*, unsigned featurePositions);
+#if ENABLE(PERFORMANCE_STATISTICS)
+        StyleInvalidationStatistics m_styleInvalidationStatistics;
+#endif
         
         RefPtr<CSSFontSelector> m_fontSelector;
         HashSet<AtomicStringImpl*> m_selectorAttrs;
         Vector<CSSMutableStyleDeclaration*> m_additionalAttributeStyleDecls;
         Vector<MediaQueryResult*> m_viewportDependentMediaQueryResults;
 
+        struct MediaQueryRules {
+            RefPtr<MediaList> mediaList;
+            bool result;
+        };
+        Vector<MediaQueryRules> m_mediaQueryRules;
+        HashMap<String, unsigned> m_mediaQueryRulesIndices;
+
         const CSSStyleApplyProperty& m_applyProperty;
     };
 
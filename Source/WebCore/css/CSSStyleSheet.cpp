@@ -25,6 +25,7 @@
 #include "CSSNamespace.h"
 #include "CSSParser.h"
 #include "CSSRuleList.h"
+#include "CSSStyleRule.h"
 #include "Document.h"
 #include "ExceptionCode.h"
 #include "HTMLNames.h"
@@ -85,6 +86,10 @@ CSSStyleSheet::CSSStyleSheet(CSSRule* ownerRule, const String& href, const KURL&
 
 CSSStyleSheet::~CSSStyleSheet()
 {
+    // ~StyleSheet detaches the rules, but by then this is no longer a CSSStyleSheet
+    // that the rules could parse their declarations against.
+    for (unsigned i = 0; i < length(); ++i)
+        CSSStyleRule::parseDeclarationsBeforeDetaching(item(i));
 }
 
 CSSRule *CSSStyleSheet::ownerRule() const
@@ -161,7 +166,9 @@ void CSSStyleSheet::deleteRule(unsigned index, ExceptionCode& ec)
     }
 
     ec = 0;
-    item(index)->setParent(0);
+    StyleBase* rule = item(index);
+    CSSStyleRule::parseDeclarationsBeforeDetaching(rule);
+    rule->setParent(0);
     remove(index);
     styleSheetChanged();
 }
@@ -205,6 +212,15 @@ bool CSSStyleSheet::parseStringAtLine(const String& string, bool strict, int sta
     return true;
 }
 
+bool CSSStyleSheet::parsePreparsedString(const String& string, bool strict, const Vector<CSSBlockExtent>& blocks)
+{
+    setStrictParsing(strict);
+    CSSParser p(strict);
+    p.setPreparsedBlocks(&blocks);
+    p.parseSheet(this, string);
+    return true;
+}
+
 bool CSSStyleSheet::isLoading()
 {
     unsigned len = length();
@@ -26,6 +26,7 @@
 
 namespace WebCore {
 
+struct CSSBlockExtent;
 struct CSSNamespace;
 class CSSParser;
 class CSSRule;
@@ -82,6 +83,8 @@ public:
     virtual bool parseString(const String&, bool strict = true);
 
     bool parseStringAtLine(const String&, bool strict, int startLineNumber);
+    // For text whose blocks CSSParser::findBlocks() has already found.
+    bool parsePreparsedString(const String&, bool strict, const Vector<CSSBlockExtent>& blocks);
 
     virtual bool isLoading();
 
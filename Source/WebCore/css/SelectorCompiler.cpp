@@ -0,0 +1,341 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SelectorCompiler.h"
+
+#if ENABLE(CSS_SELECTOR_JIT)
+
+#include "CSSSelector.h"
+#include "CSSStyleSelector.h"
+#include "Document.h"
+#include "Element.h"
+#include "NamedNodeMap.h"
+#include "QualifiedName.h"
+#include "StyledElement.h"
+#include <assembler/LinkBuffer.h>
+#include <assembler/MacroAssembler.h>
+#include <jit/ExecutableAllocator.h>
+#include <wtf/Vector.h>
+
+using namespace JSC;
+
+namespace WebCore {
+
+namespace SelectorCompiler {
+
+// The generated code compares StringImpl pointers loaded straight out of AtomicStrings.
+COMPILE_ASSERT(sizeof(AtomicString) == sizeof(StringImpl*), AtomicString_is_a_single_pointer);
+
+typedef MacroAssembler::RegisterID RegisterID;
+
+// The element being matched and the candidate ancestor to backtrack to survive calls to the helper functions.
+static const RegisterID elementRegister = X86Registers::ebx;
+static const RegisterID backtrackingRegister = X86Registers::r12;
+static const RegisterID scratchRegister = X86Registers::eax;
+static const RegisterID flagsRegister = X86Registers::edx;
+static const RegisterID argumentRegister0 = X86Registers::edi;
+static const RegisterID argumentRegister1 = X86Registers::esi;
+static const RegisterID returnRegister = X86Registers::eax;
+
+static ExecutableAllocator& executableAllocator()
+{
+    DEFINE_STATIC_LOCAL(ExecutableAllocator, allocator, ());
+    return allocator;
+}
+
+static unsigned elementHasClass(const Element* element, AtomicStringImpl* className)
+{
+    return static_cast<const StyledElement*>(element)->classNames().contains(className);
+}
+
+static unsigned elementAttributeMatches(const Element* element, const CSSSelector* selector)
+{
+    return CSSStyleSelector::SelectorChecker::checkAttributeValue(element, selector, element->document()->isHTMLDocument());
+}
+
+// The simple selectors that have to match one element, and how the element
+// matching the fragment to the left is related to it.
+struct SelectorFragment {
+    Vector<const CSSSelector*, 4> simpleSelectors;
+    CSSSelector::Relation relationToLeftFragment;
+};
+
+class SelectorCodeGenerator {
+public:
+    SelectorCodeGenerator(const CSSSelector*);
+
+    bool canCompile() const { return m_canCompile; }
+    MacroAssemblerCodeRef compile();
+
+private:
+    void generateSelectorChecker();
+    void generateWalkToParentElement(MacroAssembler::JumpList& noParentCases);
+    void generateFragmentMatching(const SelectorFragment&, MacroAssembler::JumpList& failureCases);
+    void generateTagCheck(const QualifiedName&, MacroAssembler::JumpList& failureCases);
+    void generateIdCheck(const AtomicString&, MacroAssembler::JumpList& failureCases);
+    void generateClassCheck(const AtomicString&, MacroAssembler::JumpList& failureCases);
+    void generateAttributeCheck(const CSSSelector*, MacroAssembler::JumpList& failureCases);
+    void generateReturn(MatchResult);
+
+    MacroAssembler m_assembler;
+    Vector<SelectorFragment, 4> m_fragments;
+    Vector<std::pair<MacroAssembler::Call, FunctionPtr> > m_functionCalls;
+    MacroAssembler::JumpList m_cannotMatchNativelyCases;
+    bool m_canCompile;
+};
+
+static bool isCompilableSimpleSelector(const CSSSelector* selector)
+{
+    switch (selector->m_match) {
+    case CSSSelector::None:
+    case CSSSelector::Id:
+    case CSSSelector::Class:
+    case CSSSelector::Exact:
+    case CSSSelector::Set:
+    case CSSSelector::List:
+    case CSSSelector::Hyphen:
+    case CSSSelector::Contain:
+    case CSSSelector::Begin:
+    case CSSSelector::End:
+        return true;
+    default:
+        return false;
+    }
+}
+
+SelectorCodeGenerator::SelectorCodeGenerator(const CSSSelector* selector)
+    : m_canCompile(true)
+{
+    SelectorFragment fragment;
+    for (; selector; selector = selector->tagHistory()) {
+        if (!isCompilableSimpleSelector(selector)) {
+            m_canCompile = false;
+            return;
+        }
+        fragment.simpleSelectors.append(selector);
+
+        if (!selector->tagHistory())
+            break;
+        CSSSelector::Relation relation = selector->relation();
+        if (relation == CSSSelector::SubSelector)
+            continue;
+        if (relation != CSSSelector::Descendant && relation != CSSSelector::Child) {
+            m_canCompile = false;
+            return;
+        }
+        fragment.relationToLeftFragment = relation;
+        m_fragments.append(fragment);
+        fragment.simpleSelectors.clear();
+    }
+    fragment.relationToLeftFragment = CSSSelector::SubSelector;
+    m_fragments.append(fragment);
+}
+
+MacroAssemblerCodeRef SelectorCodeGenerator::compile()
+{
+    ASSERT(m_canCompile);
+    generateSelectorChecker();
+
+    LinkBuffer linkBuffer(&m_assembler, executableAllocator().poolForSize(m_assembler.size()), 0);
+    for (size_t i = 0; i < m_functionCalls.size(); ++i)
+        linkBuffer.link(m_functionCalls[i].first, m_functionCalls[i].second);
+    return linkBuffer.finalizeCode();
+}
+
+// Matching walks up from the element one fragment at a time. A child combinator
+// has to match the parent, a descendant combinator tries every ancestor in turn.
+// Taking the nearest ancestor that matches a run of fragments joined by child
+// combinators never loses a match further up, so only the candidate of the
+// innermost descendant combinator is kept to backtrack to.
+void SelectorCodeGenerator::generateSelectorChecker()
+{
+    m_assembler.push(X86Registers::ebp);
+    m_assembler.move(X86Registers::esp, X86Registers::ebp);
+    m_assembler.push(elementRegister);
+    m_assembler.push(backtrackingRegister);
+    m_assembler.move(argumentRegister0, elementRegister);
+
+    MacroAssembler::JumpList doesNotMatch;
+    generateFragmentMatching(m_fragments[0], doesNotMatch);
+
+    bool hasBacktrackingPoint = false;
+    MacroAssembler::Label backtrackingPoint;
+    for (size_t i = 1; i < m_fragments.size(); ++i) {
+        if (m_fragments[i - 1].relationToLeftFragment == CSSSelector::Descendant) {
+            MacroAssembler::Label tryNextAncestor = m_assembler.label();
+            generateWalkToParentElement(doesNotMatch);
+            m_assembler.move(elementRegister, backtrackingRegister);
+
+            MacroAssembler::JumpList failureCases;
+            generateFragmentMatching(m_fragments[i], failureCases);
+            failureCases.linkTo(tryNextAncestor, &m_assembler);
+
+            hasBacktrackingPoint = true;
+            backtrackingPoint = tryNextAncestor;
+            continue;
+        }
+
+        ASSERT(m_fragments[i - 1].relationToLeftFragment == CSSSelector::Child);
+        // Without a parent no ancestor further up can be tried either.
+        generateWalkToParentElement(doesNotMatch);
+        if (!hasBacktrackingPoint) {
+            generateFragmentMatching(m_fragments[i], doesNotMatch);
+            continue;
+        }
+        MacroAssembler::JumpList failureCases;
+        generateFragmentMatching(m_fragments[i], failureCases);
+        MacroAssembler::Jump matched = m_assembler.jump();
+        failureCases.link(&m_assembler);
+        m_assembler.move(backtrackingRegister, elementRegister);
+        m_assembler.jump().linkTo(backtrackingPoint, &m_assembler);
+        matched.link(&m_assembler);
+    }
+
+    generateReturn(Matches);
+
+    doesNotMatch.link(&m_assembler);
+    generateReturn(DoesNotMatch);
+
+    if (!m_cannotMatchNativelyCases.empty()) {
+        m_cannotMatchNativelyCases.link(&m_assembler);
+        generateReturn(CannotMatchNatively);
+    }
+}
+
+void SelectorCodeGenerator::generateReturn(MatchResult result)
+{
+    m_assembler.move(MacroAssembler::TrustedImm32(result), returnRegister);
+    m_assembler.pop(backtrackingRegister);
+    m_assembler.pop(elementRegister);
+    m_assembler.pop(X86Registers::ebp);
+    m_assembler.ret();
+}
+
+// Same as Node::parentElement(). SVG elements are left to the SelectorChecker as
+// their shadow trees have additional rules.
+void SelectorCodeGenerator::generateWalkToParentElement(MacroAssembler::JumpList& noParentCases)
+{
+    MacroAssembler::Address elementFlags(elementRegister, Node::nodeFlagsMemoryOffset());
+    noParentCases.append(m_assembler.branchTest32(MacroAssembler::NonZero, elementFlags, MacroAssembler::TrustedImm32(Node::flagIsShadowRoot())));
+
+    m_assembler.loadPtr(MacroAssembler::Address(elementRegister, Node::parentNodeMemoryOffset()), scratchRegister);
+    noParentCases.append(m_assembler.branchTestPtr(MacroAssembler::Zero, scratchRegister));
+
+    m_assembler.load32(MacroAssembler::Address(scratchRegister, Node::nodeFlagsMemoryOffset()), flagsRegister);
+    noParentCases.append(m_assembler.branchTest32(MacroAssembler::Zero, flagsRegister, MacroAssembler::TrustedImm32(Node::flagIsElement())));
+    m_cannotMatchNativelyCases.append(m_assembler.branchTest32(MacroAssembler::NonZero, flagsRegister, MacroAssembler::TrustedImm32(Node::flagIsSVG())));
+
+    m_assembler.move(scratchRegister, elementRegister);
+}
+
+void SelectorCodeGenerator::generateFragmentMatching(const SelectorFragment& fragment, MacroAssembler::JumpList& failureCases)
+{
+    for (size_t i = 0; i < fragment.simpleSelectors.size(); ++i) {
+        const CSSSelector* selector = fragment.simpleSelectors[i];
+        if (selector->hasTag())
+            generateTagCheck(selector->tag(), failureCases);
+
+        switch (selector->m_match) {
+        case CSSSelector::None:
+            break;
+        case CSSSelector::Id:
+            generateIdCheck(selector->value(), failureCases);
+            break;
+        case CSSSelector::Class:
+            generateClassCheck(selector->value(), failureCases);
+            break;
+        default:
+            generateAttributeCheck(selector, failureCases);
+            break;
+        }
+    }
+}
+
+void SelectorCodeGenerator::generateTagCheck(const QualifiedName& tag, MacroAssembler::JumpList& failureCases)
+{
+    const AtomicString& localName = tag.localName();
+    const AtomicString& namespaceURI = tag.namespaceURI();
+    if (localName == starAtom && namespaceURI == starAtom)
+        return;
+
+    m_assembler.loadPtr(MacroAssembler::Address(elementRegister, Element::tagQNameMemoryOffset() + QualifiedName::implMemoryOffset()), scratchRegister);
+    if (localName != starAtom) {
+        MacroAssembler::Address elementLocalName(scratchRegister, OBJECT_OFFSETOF(QualifiedName::QualifiedNameImpl, m_localName));
+        failureCases.append(m_assembler.branchPtr(MacroAssembler::NotEqual, elementLocalName, MacroAssembler::TrustedImmPtr(localName.impl())));
+    }
+    if (namespaceURI != starAtom) {
+        MacroAssembler::Address elementNamespaceURI(scratchRegister, OBJECT_OFFSETOF(QualifiedName::QualifiedNameImpl, m_namespace));
+        failureCases.append(m_assembler.branchPtr(MacroAssembler::NotEqual, elementNamespaceURI, MacroAssembler::TrustedImmPtr(namespaceURI.impl())));
+    }
+}
+
+void SelectorCodeGenerator::generateIdCheck(const AtomicString& id, MacroAssembler::JumpList& failureCases)
+{
+    MacroAssembler::Address elementFlags(elementRegister, Node::nodeFlagsMemoryOffset());
+    failureCases.append(m_assembler.branchTest32(MacroAssembler::Zero, elementFlags, MacroAssembler::TrustedImm32(Node::flagHasID())));
+
+    m_assembler.loadPtr(MacroAssembler::Address(elementRegister, Element::attributeMapMemoryOffset()), scratchRegister);
+    failureCases.append(m_assembler.branchTestPtr(MacroAssembler::Zero, scratchRegister));
+    MacroAssembler::Address idForStyleResolution(scratchRegister, NamedNodeMap::idForStyleResolutionMemoryOffset());
+    failureCases.append(m_assembler.branchPtr(MacroAssembler::NotEqual, idForStyleResolution, MacroAssembler::TrustedImmPtr(id.impl())));
+}
+
+void SelectorCodeGenerator::generateClassCheck(const AtomicString& className, MacroAssembler::JumpList& failureCases)
+{
+    MacroAssembler::Address elementFlags(elementRegister, Node::nodeFlagsMemoryOffset());
+    failureCases.append(m_assembler.branchTest32(MacroAssembler::Zero, elementFlags, MacroAssembler::TrustedImm32(Node::flagHasClass())));
+
+    m_assembler.move(elementRegister, argumentRegister0);
+    m_assembler.move(MacroAssembler::TrustedImmPtr(className.impl()), argumentRegister1);
+    m_functionCalls.append(std::make_pair(m_assembler.call(), FunctionPtr(elementHasClass)));
+    failureCases.append(m_assembler.branchTest32(MacroAssembler::Zero, returnRegister));
+}
+
+void SelectorCodeGenerator::generateAttributeCheck(const CSSSelector* selector, MacroAssembler::JumpList& failureCases)
+{
+    m_assembler.move(elementRegister, argumentRegister0);
+    m_assembler.move(MacroAssembler::TrustedImmPtr(selector), argumentRegister1);
+    m_functionCalls.append(std::make_pair(m_assembler.call(), FunctionPtr(elementAttributeMatches)));
+    failureCases.append(m_assembler.branchTest32(MacroAssembler::Zero, returnRegister));
+}
+
+void CompiledSelector::compile(const CSSSelector* selector)
+{
+    ASSERT(m_status == NotCompiled);
+    SelectorCodeGenerator codeGenerator(selector);
+    if (!codeGenerator.canCompile()) {
+        m_status = CannotCompile;
+        return;
+    }
+    m_code = codeGenerator.compile();
+    m_status = Compiled;
+}
+
+} // namespace SelectorCompiler
+
+} // namespace WebCore
+
+#endif // ENABLE(CSS_SELECTOR_JIT)
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SelectorCompiler_h
+#define SelectorCompiler_h
+
+#if ENABLE(CSS_SELECTOR_JIT)
+
+#include <assembler/MacroAssemblerCodeRef.h>
+
+namespace WebCore {
+
+class CSSSelector;
+class Element;
+
+namespace SelectorCompiler {
+
+enum MatchResult {
+    DoesNotMatch,
+    Matches,
+    // The element has an SVG ancestor; let the SelectorChecker decide.
+    CannotMatchNatively
+};
+
+// Native code for one selector, generated the first time it is needed. Only
+// selectors made of tag, id, class and attribute selectors joined by descendant
+// and child combinators are compiled; the others are left to the SelectorChecker.
+class CompiledSelector {
+public:
+    CompiledSelector()
+        : m_status(NotCompiled)
+    {
+    }
+
+    bool compileIfNeeded(const CSSSelector* selector)
+    {
+        if (m_status == NotCompiled)
+            compile(selector);
+        return m_status == Compiled;
+    }
+
+    MatchResult match(const Element* element) const
+    {
+        ASSERT(m_status == Compiled);
+        return static_cast<MatchResult>(reinterpret_cast<unsigned (*)(const Element*)>(m_code.m_code.executableAddress())(element));
+    }
+
+private:
+    void compile(const CSSSelector*);
+
+    enum Status { NotCompiled, CannotCompile, Compiled };
+    Status m_status;
+    JSC::MacroAssemblerCodeRef m_code;
+};
+
+} // namespace SelectorCompiler
+
+} // namespace WebCore
+
+#endif // ENABLE(CSS_SELECTOR_JIT)
+
+#endif // SelectorCompiler_h
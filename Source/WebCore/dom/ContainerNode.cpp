@@ -236,6 +236,7 @@ void ContainerNode::parserInsertBefore(PassRefPtr<Node> newChild, Node* nextChil
 
         insertBeforeCommon(next.get(), child);
 
+        document()->incDOMTreeVersion();
         childrenChanged(true, nextChildPreviousSibling.get(), nextChild, 1);
         notifyChildInserted(child);
     }
@@ -494,6 +495,7 @@ void ContainerNode::parserRemoveChild(Node* oldChild)
 
     removeBetween(prev, next, oldChild);
 
+    document()->incDOMTreeVersion();
     childrenChanged(true, prev, next, -1);
     if (oldChild->inDocument())
         oldChild->removedFromDocument();
@@ -107,7 +107,7 @@
 #include "ScriptRunner.cpp"
 #include "ScriptableDocumentParser.cpp"
 #include "SelectElement.cpp"
-#include "SelectorNodeList.cpp"
+#include "SelectorQuery.cpp"
 #include "ShadowRoot.cpp"
 #include "SpaceSplitString.cpp"
 #include "StaticHashSetNodeList.cpp"
@@ -60,6 +60,7 @@
 #include "EntityReference.h"
 #include "Event.h"
 #include "EventHandler.h"
+#include "EventDispatcher.h"
 #include "EventListener.h"
 #include "EventNames.h"
 #include "EventQueue.h"
@@ -132,6 +133,7 @@
 #include "SecurityOrigin.h"
 #include "SegmentedString.h"
 #include "SelectionController.h"
+#include "SelectorQuery.h"
 #include "Settings.h"
 #include "StaticHashSetNodeList.h"
 #include "StyleSheetList.h"
@@ -643,9 +645,18 @@ void Document::setCompatibilityMode(CompatibilityMode mode)
         // All user stylesheets have to reparse using the different mode.
         clearPageUserSheet();
         clearPageGroupUserSheets();
+        if (m_selectorQueryCache)
+            m_selectorQueryCache->invalidate();
     }
 }
 
+SelectorQueryCache* Document::selectorQueryCache()
+{
+    if (!m_selectorQueryCache)
+        m_selectorQueryCache = adoptPtr(new SelectorQueryCache);
+    return m_selectorQueryCache.get();
+}
+
 String Document::compatMode() const
 {
     return inQuirksMode() ? "BackCompat" : "CSS1Compat";
@@ -1778,6 +1789,7 @@ void Document::detach()
     m_hoverNode = 0;
     m_focusedNode = 0;
     m_activeNode = 0;
+    m_cachedEventPath = 0;
 
     TreeScope::detach();
 
@@ -1795,6 +1807,11 @@ void Document::detach()
     m_renderArena.clear();
 }
 
+void Document::setCachedEventPath(PassRefPtr<EventPath> path)
+{
+    m_cachedEventPath = path;
+}
+
 void Document::removeAllEventListeners()
 {
 #if ENABLE(TOUCH_EVENTS)
@@ -2950,7 +2967,19 @@ void Document::styleSelectorChanged(StyleSelectorUpdateFlag updateFlag)
 #endif
 
     recalcStyleSelector();
-    
+    recalcStyleForStyleSelectorChange(updateFlag);
+}
+
+void Document::mediaQueryRulesChanged()
+{
+    if (!attached() || (!m_didCalculateStyleSelector && !haveStylesheetsLoaded()))
+        return;
+
+    recalcStyleForStyleSelectorChange(RecalcStyleImmediately);
+}
+
+void Document::recalcStyleForStyleSelectorChange(StyleSelectorUpdateFlag updateFlag)
+{
     if (updateFlag == DeferRecalcStyle) {
         scheduleForcedStyleRecalc();
         return;
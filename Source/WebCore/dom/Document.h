@@ -75,6 +75,7 @@ class Element;
 class EntityReference;
 class Event;
 class EventListener;
+class EventPath;
 class EventQueue;
 class FontData;
 class FormAssociatedElement;
@@ -113,6 +114,7 @@ class ScriptableDocumentParser;
 class ScriptElementData;
 class ScriptRunner;
 class SecurityOrigin;
+class SelectorQueryCache;
 class SerializedScriptValue;
 class SegmentedString;
 class Settings;
@@ -476,6 +478,9 @@ public:
      * found and is used to calculate the derived styles for all rendering objects.
      */
     void styleSelectorChanged(StyleSelectorUpdateFlag);
+    // For when only the viewport-dependent @media rules that the style selector matches have
+    // changed, see CSSStyleSelector::updateMediaQueryRules(). The style selector is kept.
+    void mediaQueryRulesChanged();
     void recalcStyleSelector();
 
     bool usesSiblingRules() const { return m_usesSiblingRules || m_usesSiblingRulesOverride; }
@@ -893,6 +898,8 @@ public:
     
     ScriptRunner* scriptRunner() { return m_scriptRunner.get(); }
 
+    SelectorQueryCache* selectorQueryCache();
+
 #if ENABLE(XSLT)
     void applyXSLTransform(ProcessingInstruction* pi);
     PassRefPtr<Document> transformSourceDocument() { return m_transformSourceDocument; }
@@ -905,6 +912,9 @@ public:
     void incDOMTreeVersion() { m_domTreeVersion = ++s_globalTreeVersion; }
     uint64_t domTreeVersion() const { return m_domTreeVersion; }
 
+    EventPath* cachedEventPath() const { return m_cachedEventPath.get(); }
+    void setCachedEventPath(PassRefPtr<EventPath>);
+
     void setDocType(PassRefPtr<DocumentType>);
 
 #if ENABLE(XPATH)
@@ -1138,6 +1148,7 @@ private:
     void cacheDocumentElement() const;
 
     void createStyleSelector();
+    void recalcStyleForStyleSelectorChange(StyleSelectorUpdateFlag);
 
     void deleteRetiredCustomFonts();
 
@@ -1218,6 +1229,9 @@ private:
 
     uint64_t m_domTreeVersion;
     static uint64_t s_globalTreeVersion;
+
+    // Ancestor chain of the most recent event target; see EventDispatcher.
+    RefPtr<EventPath> m_cachedEventPath;
     
     HashSet<NodeIterator*> m_nodeIterators;
     HashSet<Range*> m_ranges;
@@ -1298,6 +1312,7 @@ private:
     int m_extraLayoutDelay;
     
     OwnPtr<ScriptRunner> m_scriptRunner;
+    OwnPtr<SelectorQueryCache> m_selectorQueryCache;
 
 #if ENABLE(XSLT)
     OwnPtr<TransformSource> m_transformSource;
@@ -53,6 +53,7 @@ unsigned DynamicNodeList::length() const
 {
     if (m_caches->isLengthCacheValid)
         return m_caches->cachedLength;
+    ASSERT(!m_caches->isItemArrayValid);
 
     unsigned length = 0;
 
@@ -101,16 +102,38 @@ Node* DynamicNodeList::itemBackwardsFromCurrent(Node* start, unsigned offset, in
     return 0; // no matching node in this subtree
 }
 
+void DynamicNodeList::fillItemArray() const
+{
+    Vector<Node*>& items = m_caches->items;
+    items.clear();
+    for (Node* n = m_rootNode->firstChild(); n; n = n->traverseNextNode(m_rootNode.get())) {
+        if (n->isElementNode() && nodeMatches(static_cast<Element*>(n)))
+            items.append(n);
+    }
+
+    m_caches->cachedLength = items.size();
+    m_caches->isLengthCacheValid = true;
+    m_caches->isItemArrayValid = true;
+}
+
 Node* DynamicNodeList::item(unsigned offset) const
 {
+    if (m_caches->isItemArrayValid)
+        return offset < m_caches->items.size() ? m_caches->items[offset] : 0;
+
     int remainingOffset = offset;
     Node* start = m_rootNode->firstChild();
     if (m_caches->isItemCacheValid) {
         if (offset == m_caches->lastItemOffset)
             return m_caches->lastItem;
-        else if (offset > m_caches->lastItemOffset || m_caches->lastItemOffset - offset < offset) {
+        if (offset + 1 == m_caches->lastItemOffset || offset == m_caches->lastItemOffset + 1) {
             start = m_caches->lastItem;
             remainingOffset -= m_caches->lastItemOffset;
+        } else {
+            // Walking from the last item or the root for every random access is quadratic,
+            // so look the rest of the accesses up in a snapshot of the list.
+            fillItemArray();
+            return item(offset);
         }
     }
 
@@ -161,6 +184,7 @@ DynamicNodeList::Caches::Caches()
     : lastItem(0)
     , isLengthCacheValid(false)
     , isItemCacheValid(false)
+    , isItemArrayValid(false)
 {
 }
 
@@ -172,8 +196,10 @@ PassRefPtr<DynamicNodeList::Caches> DynamicNodeList::Caches::create()
 void DynamicNodeList::Caches::reset()
 {
     lastItem = 0;
+    items.clear();
     isLengthCacheValid = false;
-    isItemCacheValid = false;     
+    isItemCacheValid = false;
+    isItemArrayValid = false;
 }
 
 } // namespace WebCore
@@ -28,12 +28,22 @@
 #include <wtf/RefCounted.h>
 #include <wtf/Forward.h>
 #include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
 
 namespace WebCore {
 
     class Element;
     class Node;
 
+    // The attributes that cached node lists depend on, besides the structure of the tree.
+    enum NodeListAttributeDependency {
+        DependsOnClassAttribute,
+        DependsOnNameAttribute,
+        // A control's labels depend on its id and the labels' for attributes.
+        DependsOnLabelAttributes,
+        NumNodeListAttributeDependencies
+    };
+
     class DynamicNodeList : public NodeList {
     public:
         struct Caches : RefCounted<Caches> {
@@ -43,8 +53,12 @@ namespace WebCore {
             unsigned cachedLength;
             Node* lastItem;
             unsigned lastItemOffset;
+            // Every matching node, in order. Only filled in once the list is accessed
+            // other than by stepping to a neighbour of the last item.
+            Vector<Node*> items;
             bool isLengthCacheValid : 1;
             bool isItemCacheValid : 1;
+            bool isItemArrayValid : 1;
         protected:
             Caches();
         };
@@ -76,6 +90,7 @@ namespace WebCore {
         virtual bool isDynamicNodeList() const;
         Node* itemForwardsFromCurrent(Node* start, unsigned offset, int remainingOffset) const;
         Node* itemBackwardsFromCurrent(Node* start, unsigned offset, int remainingOffset) const;
+        void fillItemArray() const;
     };
 
 } // namespace WebCore
@@ -678,6 +678,7 @@ void Element::setAttribute(const AtomicString& name, const AtomicString& value,
     else if (!old && !value.isNull())
         m_attributeMap->addAttribute(createAttribute(attributeName, value));
     else if (old && !value.isNull()) {
+        old = m_attributeMap->unsharedAttributeItem(old);
         if (Attr* attrNode = old->attr())
             attrNode->setValue(value);
         else
@@ -711,6 +712,7 @@ void Element::setAttribute(const QualifiedName& name, const AtomicString& value,
     else if (!old && !value.isNull())
         m_attributeMap->addAttribute(createAttribute(name, value));
     else if (old) {
+        old = m_attributeMap->unsharedAttributeItem(old);
         if (Attr* attrNode = old->attr())
             attrNode->setValue(value);
         else
@@ -734,6 +736,7 @@ void Element::attributeChanged(Attribute* attr, bool)
     if (isIdAttributeName(attr->name()))
         idAttributeChanged(attr);
     recalcStyleIfNeededAfterAttributeChanged(attr);
+    notifyNodeListsAttributeChanged(attr->name());
     updateAfterAttributeChanged(attr);
 }
 
@@ -767,12 +770,17 @@ void Element::updateAfterAttributeChanged(Attribute* attr)
     
 void Element::recalcStyleIfNeededAfterAttributeChanged(Attribute* attr)
 {
-    if (document()->attached() && document()->styleSelector()->hasSelectorForAttribute(attr->name().localName()))
-        setNeedsStyleRecalc();
+    if (document()->attached() && document()->styleSelector()->hasSelectorForAttribute(attr->name().localName())) {
+        if (attached())
+            document()->styleSelector()->invalidateStyleForAttributeChange(this, attr->name().localName());
+        else
+            setNeedsStyleRecalc();
+    }
 }
 
 void Element::idAttributeChanged(Attribute* attr)
 {
+    AtomicString oldId = attached() && hasID() ? idForStyleResolution() : nullAtom;
     setHasID(!attr->isNull());
     if (attributeMap()) {
         if (attr->isNull())
@@ -782,7 +790,10 @@ void Element::idAttributeChanged(Attribute* attr)
         else
             attributeMap()->setIdForStyleResolution(attr->value());
     }
-    setNeedsStyleRecalc();
+    if (attached())
+        document()->styleSelector()->invalidateStyleForIdChange(this, oldId);
+    else
+        setNeedsStyleRecalc();
 }
     
 // Returns true is the given attribute is an event handler.
@@ -832,7 +843,7 @@ void Element::setAttributeMap(PassRefPtr<NamedNodeMap> list, FragmentScriptingPe
                 }
 
                 if (isAttributeToRemove(attributeName, m_attributeMap->m_attributes[i]->value()))
-                    m_attributeMap->m_attributes[i]->setValue(nullAtom);
+                    m_attributeMap->unsharedAttributeItem(m_attributeMap->m_attributes[i].get())->setValue(nullAtom);
                 i++;
             }
         }
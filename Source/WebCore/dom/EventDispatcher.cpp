@@ -26,6 +26,7 @@
 #include "config.h"
 #include "EventDispatcher.h"
 
+#include "Document.h"
 #include "Event.h"
 #include "EventContext.h"
 #include "EventTarget.h"
@@ -50,6 +51,40 @@
 namespace WebCore {
 
 static HashSet<Node*>* gNodesDispatchingSimulatedClicks = 0;
+#if ENABLE(PERFORMANCE_STATISTICS)
+static EventDispatcher::PathCacheStatistics s_pathCacheStatistics;
+#endif
+
+PassRefPtr<EventPath> EventPath::create(PassRefPtr<Node> target, EventDispatchBehavior behavior, uint64_t domTreeVersion)
+{
+    return adoptRef(new EventPath(target, behavior, domTreeVersion));
+}
+
+PassRefPtr<EventPath> EventPath::createCopy(const EventPath& other)
+{
+    RefPtr<EventPath> path = adoptRef(new EventPath(other.m_target, other.m_behavior, other.m_domTreeVersion));
+    path->m_ancestors = other.m_ancestors;
+    return path.release();
+}
+
+EventPath::EventPath(PassRefPtr<Node> target, EventDispatchBehavior behavior, uint64_t domTreeVersion)
+    : m_target(target)
+    , m_behavior(behavior)
+    , m_domTreeVersion(domTreeVersion)
+{
+}
+
+bool EventPath::isValidFor(Node* target, EventDispatchBehavior behavior, uint64_t domTreeVersion) const
+{
+    return m_target == target && m_behavior == behavior && m_domTreeVersion == domTreeVersion;
+}
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+EventDispatcher::PathCacheStatistics EventDispatcher::pathCacheStatistics()
+{
+    return s_pathCacheStatistics;
+}
+#endif
 
 bool EventDispatcher::dispatchEvent(Node* node, const EventDispatchMediator& mediator)
 {
@@ -132,11 +167,12 @@ static inline bool isShadowRootOrSVGShadowRoot(const Node* node)
 
 PassRefPtr<EventTarget> EventDispatcher::adjustToShadowBoundaries(PassRefPtr<Node> relatedTarget, const Vector<Node*> relatedTargetAncestors)
 {
-    Vector<EventContext>::const_iterator lowestCommonBoundary = m_ancestors.end();
+    Vector<EventContext>& ancestors = this->ancestors();
+    Vector<EventContext>::const_iterator lowestCommonBoundary = ancestors.end();
     // Assume divergent boundary is the relatedTarget itself (in other words, related target ancestor chain does not cross any shadow DOM boundaries).
     Vector<Node*>::const_iterator firstDivergentBoundary = relatedTargetAncestors.begin();
 
-    Vector<EventContext>::const_iterator targetAncestor = m_ancestors.end();
+    Vector<EventContext>::const_iterator targetAncestor = ancestors.end();
     // Walk down from the top, looking for lowest common ancestor, also monitoring shadow DOM boundaries.
     bool diverged = false;
     for (Vector<Node*>::const_iterator i = relatedTargetAncestors.end() - 1; i >= relatedTargetAncestors.begin(); --i) {
@@ -148,7 +184,7 @@ PassRefPtr<EventTarget> EventDispatcher::adjustToShadowBoundaries(PassRefPtr<Nod
             continue;
         }
 
-        if (targetAncestor == m_ancestors.begin()) {
+        if (targetAncestor == ancestors.begin()) {
             diverged = true;
             continue;
         }
@@ -165,18 +201,23 @@ PassRefPtr<EventTarget> EventDispatcher::adjustToShadowBoundaries(PassRefPtr<Nod
     if (!diverged) {
         // The relatedTarget is an ancestor or shadowHost of the target.
         if (m_node->shadowHost() == relatedTarget.get())
-            lowestCommonBoundary = m_ancestors.begin();
+            lowestCommonBoundary = ancestors.begin();
     } else if ((*firstDivergentBoundary) == m_node.get()) {
         // Since ancestors does not contain target itself, we must account
         // for the possibility that target is a shadowHost of relatedTarget
         // and thus serves as the lowestCommonBoundary.
         // Luckily, in this case the firstDivergentBoundary is target.
-        lowestCommonBoundary = m_ancestors.begin();
+        lowestCommonBoundary = ancestors.begin();
     }
 
     // Trim ancestors to lowestCommonBoundary to keep events inside of the common shadow DOM subtree.
-    if (lowestCommonBoundary != m_ancestors.end())
-        m_ancestors.shrink(lowestCommonBoundary - m_ancestors.begin());
+    if (lowestCommonBoundary != ancestors.end()) {
+        size_t newSize = lowestCommonBoundary - ancestors.begin();
+        // The path may be shared with the document's cache and other dispatchers.
+        if (!m_eventPath->hasOneRef())
+            m_eventPath = EventPath::createCopy(*m_eventPath);
+        m_eventPath->ancestors().shrink(newSize);
+    }
     // Set event's related target to the first encountered shadow DOM boundary in the divergent subtree.
     return firstDivergentBoundary != relatedTargetAncestors.begin() ? *firstDivergentBoundary : relatedTarget;
 }
@@ -206,7 +247,7 @@ PassRefPtr<EventTarget> EventDispatcher::adjustRelatedTarget(Event* event, PassR
     // Calculate early if the common boundary is even possible by looking at
     // ancestors size and if the retargeting has occured (indicating the presence of shadow DOM boundaries).
     // If there are no boundaries detected, the target and related target can't have a common boundary.
-    bool noCommonBoundary = ancestorsCrossShadowBoundaries(m_ancestors);
+    bool noCommonBoundary = ancestorsCrossShadowBoundaries(ancestors());
 
     Vector<Node*> relatedTargetAncestors;
     Node* outermostShadowBoundary = relatedTarget.get();
@@ -226,7 +267,6 @@ PassRefPtr<EventTarget> EventDispatcher::adjustRelatedTarget(Event* event, PassR
 
 EventDispatcher::EventDispatcher(Node* node)
     : m_node(node)
-    , m_ancestorsInitialized(false)
 {
     ASSERT(node);
     m_view = node->document()->view();
@@ -234,16 +274,42 @@ EventDispatcher::EventDispatcher(Node* node)
 
 void EventDispatcher::ensureEventAncestors(Event* event)
 {
+    if (m_eventPath)
+        return;
+
     EventDispatchBehavior behavior = determineDispatchBehavior(event);
+    Document* document = m_node->document();
+    uint64_t domTreeVersion = document->domTreeVersion();
 
-    if (!m_node->inDocument())
+    if (!m_node->inDocument()) {
+        m_eventPath = EventPath::create(m_node, behavior, domTreeVersion);
         return;
+    }
 
-    if (m_ancestorsInitialized)
-        return;
+    if (EventPath* cachedPath = document->cachedEventPath()) {
+        if (cachedPath->isValidFor(m_node.get(), behavior, domTreeVersion)) {
+#if ENABLE(PERFORMANCE_STATISTICS)
+            ++s_pathCacheStatistics.pathsReused;
+#endif
+            m_eventPath = cachedPath;
+            return;
+        }
+        // Don't keep the nodes of a stale path alive until a new one replaces it.
+        document->setCachedEventPath(0);
+    }
 
-    m_ancestorsInitialized = true;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    ++s_pathCacheStatistics.pathsBuilt;
+#endif
+    m_eventPath = EventPath::create(m_node, behavior, domTreeVersion);
+    buildEventAncestors(behavior, m_eventPath->ancestors());
+    // The path refers to the document, so only documents that will be detached can keep it.
+    if (document->frame())
+        document->setCachedEventPath(m_eventPath);
+}
 
+void EventDispatcher::buildEventAncestors(EventDispatchBehavior behavior, Vector<EventContext>& ancestors)
+{
     Node* ancestor = m_node.get();
     EventTarget* target = eventTargetRespectingSVGTargetRules(ancestor);
     bool shouldSkipNextAncestor = false;
@@ -272,10 +338,16 @@ void EventDispatcher::ensureEventAncestors(Event* event)
             continue;
 #endif
         // FIXME: Unroll the extra loop inside eventTargetRespectingSVGTargetRules into this loop.
-        m_ancestors.append(EventContext(ancestor, eventTargetRespectingSVGTargetRules(ancestor), target));
+        ancestors.append(EventContext(ancestor, eventTargetRespectingSVGTargetRules(ancestor), target));
     }
 }
 
+Vector<EventContext>& EventDispatcher::ancestors()
+{
+    ASSERT(m_eventPath);
+    return m_eventPath->ancestors();
+}
+
 bool EventDispatcher::dispatchEvent(PassRefPtr<Event> event)
 {
     event->setTarget(eventTargetRespectingSVGTargetRules(m_node.get()));
@@ -286,10 +358,13 @@ bool EventDispatcher::dispatchEvent(PassRefPtr<Event> event)
 
     RefPtr<EventTarget> originalTarget = event->target();
     ensureEventAncestors(event.get());
+    // Keep the path alive and unchanged even if a listener dispatches another event.
+    RefPtr<EventPath> eventPath = m_eventPath;
+    Vector<EventContext>& ancestors = eventPath->ancestors();
 
     WindowEventContext windowContext(event.get(), m_node.get(), topEventContext());
 
-    InspectorInstrumentationCookie cookie = InspectorInstrumentation::willDispatchEvent(m_node->document(), *event, windowContext.window(), m_node.get(), m_ancestors);
+    InspectorInstrumentationCookie cookie = InspectorInstrumentation::willDispatchEvent(m_node->document(), *event, windowContext.window(), m_node.get(), ancestors);
 
     // Give the target node a chance to do some work before DOM event handlers get a crack.
     void* data = m_node->preDispatchEventHandler(event.get());
@@ -302,8 +377,8 @@ bool EventDispatcher::dispatchEvent(PassRefPtr<Event> event)
     if (windowContext.handleLocalEvents(event.get()) && event->propagationStopped())
         goto doneDispatching;
 
-    for (size_t i = m_ancestors.size(); i; --i) {
-        m_ancestors[i - 1].handleLocalEvents(event.get());
+    for (size_t i = ancestors.size(); i; --i) {
+        ancestors[i - 1].handleLocalEvents(event.get());
         if (event->propagationStopped())
             goto doneDispatching;
     }
@@ -319,9 +394,9 @@ bool EventDispatcher::dispatchEvent(PassRefPtr<Event> event)
         // Trigger bubbling event handlers, starting at the bottom and working our way up.
         event->setEventPhase(Event::BUBBLING_PHASE);
 
-        size_t size = m_ancestors.size();
+        size_t size = ancestors.size();
         for (size_t i = 0; i < size; ++i) {
-            m_ancestors[i].handleLocalEvents(event.get());
+            ancestors[i].handleLocalEvents(event.get());
             if (event->propagationStopped() || event->cancelBubble())
                 goto doneDispatching;
         }
@@ -348,9 +423,9 @@ doneDispatching:
         // For bubbling events, call default event handlers on the same targets in the
         // same order as the bubbling phase.
         if (event->bubbles()) {
-            size_t size = m_ancestors.size();
+            size_t size = ancestors.size();
             for (size_t i = 0; i < size; ++i) {
-                m_ancestors[i].node()->defaultEventHandler(event.get());
+                ancestors[i].node()->defaultEventHandler(event.get());
                 ASSERT(!event->defaultPrevented());
                 if (event->defaultHandled())
                     goto doneWithDefault;
@@ -371,7 +446,8 @@ doneWithDefault:
 
 const EventContext* EventDispatcher::topEventContext()
 {
-    return m_ancestors.isEmpty() ? 0 : &m_ancestors.last();
+    Vector<EventContext>& ancestors = this->ancestors();
+    return ancestors.isEmpty() ? 0 : &ancestors.last();
 }
 
 EventDispatchBehavior EventDispatcher::determineDispatchBehavior(Event* event)
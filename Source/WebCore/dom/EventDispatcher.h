@@ -26,13 +26,14 @@
 #ifndef EventDispatcher_h
 #define EventDispatcher_h
 
+#include "EventContext.h"
 #include <wtf/Forward.h>
+#include <wtf/RefCounted.h>
 #include <wtf/Vector.h>
 
 namespace WebCore {
 
 class Event;
-class EventContext;
 class EventDispatchMediator;
 class EventTarget;
 class FrameView;
@@ -46,6 +47,28 @@ enum EventDispatchBehavior {
     StayInsideShadowDOM
 };
 
+// The ancestors an event dispatched at a node propagates through, from the
+// node's parent up. A document keeps the path of the last event dispatched in
+// it, since successive events such as mousemove and touchmove usually share a
+// target, and reuses it until the DOM tree version changes.
+class EventPath : public RefCounted<EventPath> {
+public:
+    static PassRefPtr<EventPath> create(PassRefPtr<Node> target, EventDispatchBehavior, uint64_t domTreeVersion);
+    static PassRefPtr<EventPath> createCopy(const EventPath&);
+
+    bool isValidFor(Node* target, EventDispatchBehavior, uint64_t domTreeVersion) const;
+
+    Vector<EventContext>& ancestors() { return m_ancestors; }
+
+private:
+    EventPath(PassRefPtr<Node> target, EventDispatchBehavior, uint64_t domTreeVersion);
+
+    RefPtr<Node> m_target;
+    EventDispatchBehavior m_behavior;
+    uint64_t m_domTreeVersion;
+    Vector<EventContext> m_ancestors;
+};
+
 class EventDispatcher {
 public:
     static bool dispatchEvent(Node*, const EventDispatchMediator&);
@@ -57,19 +80,29 @@ public:
     PassRefPtr<EventTarget> adjustRelatedTarget(Event*, PassRefPtr<EventTarget>);
     Node* node() const;
 
+#if ENABLE(PERFORMANCE_STATISTICS)
+    struct PathCacheStatistics {
+        unsigned pathsBuilt;
+        unsigned pathsReused;
+        PathCacheStatistics() : pathsBuilt(0), pathsReused(0) { }
+    };
+    static PathCacheStatistics pathCacheStatistics();
+#endif
+
 private:
     EventDispatcher(Node*);
 
     PassRefPtr<EventTarget> adjustToShadowBoundaries(PassRefPtr<Node> relatedTarget, const Vector<Node*> relatedTargetAncestors);
     EventDispatchBehavior determineDispatchBehavior(Event*);
     void ensureEventAncestors(Event*);
+    void buildEventAncestors(EventDispatchBehavior, Vector<EventContext>&);
+    Vector<EventContext>& ancestors();
     const EventContext* topEventContext();
 
-    Vector<EventContext> m_ancestors;
+    RefPtr<EventPath> m_eventPath;
     RefPtr<Node> m_node;
     RefPtr<EventTarget> m_originalTarget;
     RefPtr<FrameView> m_view;
-    bool m_ancestorsInitialized;
 };
 
 inline Node* EventDispatcher::node() const
@@ -60,7 +60,7 @@ PassRefPtr<Node> NamedNodeMap::getNamedItem(const String& name) const
     if (!a)
         return 0;
     
-    return a->createAttrIfNeeded(m_element);
+    return const_cast<NamedNodeMap*>(this)->unsharedAttributeItem(a)->createAttrIfNeeded(m_element);
 }
 
 PassRefPtr<Node> NamedNodeMap::getNamedItemNS(const String& namespaceURI, const String& localName) const
@@ -90,7 +90,7 @@ PassRefPtr<Node> NamedNodeMap::getNamedItem(const QualifiedName& name) const
     if (!a)
         return 0;
 
-    return a->createAttrIfNeeded(m_element);
+    return const_cast<NamedNodeMap*>(this)->unsharedAttributeItem(a)->createAttrIfNeeded(m_element);
 }
 
 PassRefPtr<Node> NamedNodeMap::setNamedItem(Node* arg, ExceptionCode& ec)
@@ -125,7 +125,7 @@ PassRefPtr<Node> NamedNodeMap::setNamedItem(Node* arg, ExceptionCode& ec)
     // ### slightly inefficient - resizes attribute array twice.
     RefPtr<Node> r;
     if (old) {
-        r = old->createAttrIfNeeded(m_element);
+        r = unsharedAttributeItem(old)->createAttrIfNeeded(m_element);
         removeAttribute(a->name());
     }
 
@@ -149,7 +149,7 @@ PassRefPtr<Node> NamedNodeMap::removeNamedItem(const QualifiedName& name, Except
         return 0;
     }
 
-    RefPtr<Attr> r = a->createAttrIfNeeded(m_element);
+    RefPtr<Attr> r = unsharedAttributeItem(a)->createAttrIfNeeded(m_element);
 
     if (r->isId())
         m_element->updateId(a->value(), nullAtom);
@@ -163,7 +163,19 @@ PassRefPtr<Node> NamedNodeMap::item(unsigned index) const
     if (index >= length())
         return 0;
 
-    return m_attributes[index]->createAttrIfNeeded(m_element);
+    return const_cast<NamedNodeMap*>(this)->unsharedAttributeItem(m_attributes[index].get())->createAttrIfNeeded(m_element);
+}
+
+Attribute* NamedNodeMap::unsharedAttributeItem(Attribute* attribute)
+{
+    // Attributes wrapped in an Attr are never shared, but the Attr holds a reference too.
+    if (attribute->hasOneRef() || attribute->attr())
+        return attribute;
+
+    size_t index = m_attributes.find(attribute);
+    ASSERT(index != notFound);
+    m_attributes[index] = attribute->clone();
+    return m_attributes[index].get();
 }
 
 void NamedNodeMap::copyAttributesToVector(Vector<RefPtr<Attribute> >& copy)
@@ -211,9 +223,9 @@ void NamedNodeMap::detachFromElement()
     clearAttributes();
 }
 
-void NamedNodeMap::setAttributes(const NamedNodeMap& other)
+void NamedNodeMap::setAttributes(const NamedNodeMap& other, AttributeCopyMode mode)
 {
-    // clone all attributes in the other map, but attach to our element
+    // clone or share all attributes in the other map, but attach to our element
     if (!m_element)
         return;
 
@@ -228,8 +240,12 @@ void NamedNodeMap::setAttributes(const NamedNodeMap& other)
     clearAttributes();
     unsigned newLength = other.length();
     m_attributes.resize(newLength);
-    for (unsigned i = 0; i < newLength; i++)
-        m_attributes[i] = other.m_attributes[i]->clone();
+    for (unsigned i = 0; i < newLength; i++) {
+        if (mode == ShareAttributes && !other.m_attributes[i]->attr())
+            m_attributes[i] = other.m_attributes[i];
+        else
+            m_attributes[i] = other.m_attributes[i]->clone();
+    }
 
     // FIXME: This is wasteful.  The class list could be preserved on a copy, and we
     // wouldn't have to waste time reparsing the attribute.
@@ -275,6 +291,9 @@ void NamedNodeMap::removeAttribute(const QualifiedName& name)
     if (index >= len)
         return;
 
+    // The attribute's value and decl are changed below while notifying the element.
+    unsharedAttributeItem(m_attributes[index].get());
+
     // Remove the attribute from the list
     RefPtr<Attribute> attr = m_attributes[index].get();
     if (Attr* a = m_attributes[index]->attr())
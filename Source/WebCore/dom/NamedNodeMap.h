@@ -63,11 +63,17 @@ public:
 
     // Internal interface.
 
-    void setAttributes(const NamedNodeMap&);
+    enum AttributeCopyMode { CloneAttributes, ShareAttributes };
+    void setAttributes(const NamedNodeMap&, AttributeCopyMode = CloneAttributes);
 
     Attribute* attributeItem(unsigned index) const { return m_attributes[index].get(); }
     Attribute* getAttributeItem(const QualifiedName&) const;
 
+    // Elements parsed with identical attribute lists share their Attribute objects
+    // (see HTMLConstructionSite::createHTMLElement). An attribute must be unshared
+    // before it is changed in place or wrapped in an Attr.
+    Attribute* unsharedAttributeItem(Attribute*);
+
     void copyAttributesToVector(Vector<RefPtr<Attribute> >&);
 
     void shrinkToLength() { m_attributes.shrinkCapacity(length()); }
@@ -83,6 +89,9 @@ public:
 
     const AtomicString& idForStyleResolution() const { return m_idForStyleResolution; }
     void setIdForStyleResolution(const AtomicString& newId) { m_idForStyleResolution = newId; }
+#if ENABLE(CSS_SELECTOR_JIT)
+    static ptrdiff_t idForStyleResolutionMemoryOffset() { return OBJECT_OFFSETOF(NamedNodeMap, m_idForStyleResolution); }
+#endif
 
     // FIXME: These two functions should be merged if possible.
     bool mapsEquivalent(const NamedNodeMap* otherMap) const;
@@ -33,11 +33,8 @@
 #include "AXObjectCache.h"
 #include "Attr.h"
 #include "Attribute.h"
-#include "CSSParser.h"
 #include "CSSRule.h"
 #include "CSSRuleList.h"
-#include "CSSSelector.h"
-#include "CSSSelectorList.h"
 #include "CSSStyleRule.h"
 #include "CSSStyleSelector.h"
 #include "CSSStyleSheet.h"
@@ -81,8 +78,7 @@
 #include "RenderView.h"
 #include "ScopedEventQueue.h"
 #include "ScriptController.h"
-#include "SelectorNodeList.h"
-#include "StaticNodeList.h"
+#include "SelectorQuery.h"
 #include "TagNodeList.h"
 #include "Text.h"
 #include "TextEvent.h"
@@ -457,6 +453,7 @@ void Node::setDocument(Document* document)
         if (m_document)
             m_document->removeNodeListCache();
         document->addNodeListCache();
+        rareData()->nodeLists()->moveNodeListsThatDependOnAttributes(m_document, document);
     }
 
     if (m_document) {
@@ -1007,7 +1004,16 @@ void Node::unregisterDynamicNodeList(DynamicNodeList* list)
     }
 }
 
-void Node::notifyLocalNodeListsAttributeChanged()
+#if ENABLE(PERFORMANCE_STATISTICS)
+static Node::NodeListInvalidationStatistics nodeListInvalidationStatistics;
+
+Node::NodeListInvalidationStatistics Node::attributeNodeListInvalidationStatistics()
+{
+    return nodeListInvalidationStatistics;
+}
+#endif
+
+void Node::notifyLocalNodeListsAttributeChanged(const QualifiedName& attrName)
 {
     if (!hasRareData())
         return;
@@ -1015,10 +1021,7 @@ void Node::notifyLocalNodeListsAttributeChanged()
     if (!data->nodeLists())
         return;
 
-    if (!isAttributeNode())
-        data->nodeLists()->invalidateCachesThatDependOnAttributes();
-    else
-        data->nodeLists()->invalidateCaches();
+    data->nodeLists()->invalidateCachesThatDependOnAttribute(attrName);
 
     if (data->nodeLists()->isEmpty()) {
         data->clearNodeLists();
@@ -1026,10 +1029,21 @@ void Node::notifyLocalNodeListsAttributeChanged()
     }
 }
 
-void Node::notifyNodeListsAttributeChanged()
+void Node::notifyNodeListsAttributeChanged(const QualifiedName& attrName)
 {
-    for (Node *n = this; n; n = n->parentNode())
-        n->notifyLocalNodeListsAttributeChanged();
+    // Only lists rooted at an ancestor can contain this node, and only class, name and labels lists look at attributes.
+    if (!document()->hasNodeListsThatDependOnAttribute(attrName)) {
+#if ENABLE(PERFORMANCE_STATISTICS)
+        ++nodeListInvalidationStatistics.invalidationsSkipped;
+#endif
+        return;
+    }
+#if ENABLE(PERFORMANCE_STATISTICS)
+    ++nodeListInvalidationStatistics.invalidationsPerformed;
+#endif
+
+    for (Node* n = this; n; n = n->parentNode())
+        n->notifyLocalNodeListsAttributeChanged(attrName);
 }
 
 void Node::notifyLocalNodeListsChildrenChanged()
@@ -1058,18 +1072,6 @@ void Node::notifyNodeListsChildrenChanged()
         n->notifyLocalNodeListsChildrenChanged();
 }
 
-void Node::notifyLocalNodeListsLabelChanged()
-{
-    if (!hasRareData())
-        return;
-    NodeRareData* data = rareData();
-    if (!data->nodeLists())
-        return;
-
-    if (data->nodeLists()->m_labelsNodeListCache)
-        data->nodeLists()->m_labelsNodeListCache->invalidateCache();
-}
-
 void Node::removeCachedClassNodeList(ClassNodeList* list, const String& className)
 {
     ASSERT(rareData());
@@ -1079,6 +1081,8 @@ void Node::removeCachedClassNodeList(ClassNodeList* list, const String& classNam
     NodeListsNodeData* data = rareData()->nodeLists();
     ASSERT_UNUSED(list, list == data->m_classNodeListCache.get(className));
     data->m_classNodeListCache.remove(className);
+    if (document())
+        document()->removeNodeListThatDependsOnAttribute(DependsOnClassAttribute);
 }
 
 void Node::removeCachedNameNodeList(NameNodeList* list, const String& nodeName)
@@ -1090,6 +1094,8 @@ void Node::removeCachedNameNodeList(NameNodeList* list, const String& nodeName)
     NodeListsNodeData* data = rareData()->nodeLists();
     ASSERT_UNUSED(list, list == data->m_nameNodeListCache.get(nodeName));
     data->m_nameNodeListCache.remove(nodeName);
+    if (document())
+        document()->removeNodeListThatDependsOnAttribute(DependsOnNameAttribute);
 }
 
 void Node::removeCachedTagNodeList(TagNodeList* list, const QualifiedName& name)
@@ -1740,6 +1746,7 @@ PassRefPtr<NodeList> Node::getElementsByName(const String& elementName)
 
     RefPtr<NameNodeList> list = NameNodeList::create(this, elementName);
     result.first->second = list.get();
+    document()->addNodeListThatDependsOnAttribute(DependsOnNameAttribute);
     return list.release();
 }
 
@@ -1757,6 +1764,7 @@ PassRefPtr<NodeList> Node::getElementsByClassName(const String& classNames)
 
     RefPtr<ClassNodeList> list = ClassNodeList::create(this, classNames);
     result.first->second = list.get();
+    document()->addNodeListThatDependsOnAttribute(DependsOnClassAttribute);
     return list.release();
 }
 
@@ -1766,45 +1774,11 @@ PassRefPtr<Element> Node::querySelector(const String& selectors, ExceptionCode&
         ec = SYNTAX_ERR;
         return 0;
     }
-    bool strictParsing = !document()->inQuirksMode();
-    CSSParser p(strictParsing);
-
-    CSSSelectorList querySelectorList;
-    p.parseSelector(selectors, document(), querySelectorList);
-
-    if (!querySelectorList.first() || querySelectorList.hasUnknownPseudoElements()) {
-        ec = SYNTAX_ERR;
-        return 0;
-    }
-
-    // throw a NAMESPACE_ERR if the selector includes any namespace prefixes.
-    if (querySelectorList.selectorsNeedNamespaceResolution()) {
-        ec = NAMESPACE_ERR;
-        return 0;
-    }
-
-    CSSStyleSelector::SelectorChecker selectorChecker(document(), strictParsing);
 
-    // FIXME: we could also optimize for the the [id="foo"] case
-    if (strictParsing && inDocument() && querySelectorList.hasOneSelector() && querySelectorList.first()->m_match == CSSSelector::Id) {
-        Element* element = document()->getElementById(querySelectorList.first()->value());
-        if (element && (isDocumentNode() || element->isDescendantOf(this)) && selectorChecker.checkSelector(querySelectorList.first(), element))
-            return element;
+    SelectorQuery* selectorQuery = document()->selectorQueryCache()->add(selectors, document(), ec);
+    if (!selectorQuery)
         return 0;
-    }
-
-    // FIXME: We can speed this up by implementing caching similar to the one use by getElementById
-    for (Node* n = firstChild(); n; n = n->traverseNextNode(this)) {
-        if (n->isElementNode()) {
-            Element* element = static_cast<Element*>(n);
-            for (CSSSelector* selector = querySelectorList.first(); selector; selector = CSSSelectorList::next(selector)) {
-                if (selectorChecker.checkSelector(selector, element))
-                    return element;
-            }
-        }
-    }
-    
-    return 0;
+    return selectorQuery->queryFirst(this);
 }
 
 PassRefPtr<NodeList> Node::querySelectorAll(const String& selectors, ExceptionCode& ec)
@@ -1813,24 +1787,11 @@ PassRefPtr<NodeList> Node::querySelectorAll(const String& selectors, ExceptionCo
         ec = SYNTAX_ERR;
         return 0;
     }
-    bool strictParsing = !document()->inQuirksMode();
-    CSSParser p(strictParsing);
-
-    CSSSelectorList querySelectorList;
-    p.parseSelector(selectors, document(), querySelectorList);
 
-    if (!querySelectorList.first() || querySelectorList.hasUnknownPseudoElements()) {
-        ec = SYNTAX_ERR;
-        return 0;
-    }
-
-    // Throw a NAMESPACE_ERR if the selector includes any namespace prefixes.
-    if (querySelectorList.selectorsNeedNamespaceResolution()) {
-        ec = NAMESPACE_ERR;
+    SelectorQuery* selectorQuery = document()->selectorQueryCache()->add(selectors, document(), ec);
+    if (!selectorQuery)
         return 0;
-    }
-
-    return createSelectorNodeList(this, querySelectorList);
+    return selectorQuery->queryAll(this);
 }
 
 Document *Node::ownerDocument() const
@@ -2432,11 +2393,7 @@ void NodeListsNodeData::invalidateCaches()
     TagNodeListCache::const_iterator tagCacheEnd = m_tagNodeListCache.end();
     for (TagNodeListCache::const_iterator it = m_tagNodeListCache.begin(); it != tagCacheEnd; ++it)
         it->second->invalidateCache();
-    invalidateCachesThatDependOnAttributes();
-}
 
-void NodeListsNodeData::invalidateCachesThatDependOnAttributes()
-{
     ClassNodeListCache::iterator classCacheEnd = m_classNodeListCache.end();
     for (ClassNodeListCache::iterator it = m_classNodeListCache.begin(); it != classCacheEnd; ++it)
         it->second->invalidateCache();
@@ -2444,8 +2401,40 @@ void NodeListsNodeData::invalidateCachesThatDependOnAttributes()
     NameNodeListCache::iterator nameCacheEnd = m_nameNodeListCache.end();
     for (NameNodeListCache::iterator it = m_nameNodeListCache.begin(); it != nameCacheEnd; ++it)
         it->second->invalidateCache();
-    if (m_labelsNodeListCache)
-        m_labelsNodeListCache->invalidateCache();
+}
+
+void NodeListsNodeData::invalidateCachesThatDependOnAttribute(const QualifiedName& attrName)
+{
+    if (attrName == classAttr) {
+        ClassNodeListCache::iterator classCacheEnd = m_classNodeListCache.end();
+        for (ClassNodeListCache::iterator it = m_classNodeListCache.begin(); it != classCacheEnd; ++it)
+            it->second->invalidateCache();
+    } else if (attrName == nameAttr) {
+        NameNodeListCache::iterator nameCacheEnd = m_nameNodeListCache.end();
+        for (NameNodeListCache::iterator it = m_nameNodeListCache.begin(); it != nameCacheEnd; ++it)
+            it->second->invalidateCache();
+    } else if (attrName == idAttr || attrName == forAttr) {
+        // Labels lists are rooted at the document and keep their own caches.
+        if (m_labelsNodeListCache)
+            m_labelsNodeListCache->invalidateCache();
+        NodeListSet::iterator listsEnd = m_listsWithCaches.end();
+        for (NodeListSet::iterator it = m_listsWithCaches.begin(); it != listsEnd; ++it)
+            (*it)->invalidateCache();
+    }
+}
+
+void NodeListsNodeData::moveNodeListsThatDependOnAttributes(TreeScope* oldScope, TreeScope* newScope)
+{
+    for (unsigned i = 0; i < m_classNodeListCache.size(); ++i) {
+        if (oldScope)
+            oldScope->removeNodeListThatDependsOnAttribute(DependsOnClassAttribute);
+        newScope->addNodeListThatDependsOnAttribute(DependsOnClassAttribute);
+    }
+    for (unsigned i = 0; i < m_nameNodeListCache.size(); ++i) {
+        if (oldScope)
+            oldScope->removeNodeListThatDependsOnAttribute(DependsOnNameAttribute);
+        newScope->addNodeListThatDependsOnAttribute(DependsOnNameAttribute);
+    }
 }
 
 bool NodeListsNodeData::isEmpty() const
@@ -2719,7 +2708,10 @@ void Node::dispatchSubtreeModifiedEvent()
     
     document()->incDOMTreeVersion();
 
-    notifyNodeListsAttributeChanged(); // FIXME: Can do better some day. Really only care about the name attribute changing.
+    // Attribute changes invalidate the node lists that depend on them from Element::attributeChanged().
+    // An Attr's children are its value, and its child lists aren't reset by childrenChanged().
+    if (isAttributeNode())
+        notifyLocalNodeListsChildrenChanged();
     
     if (!document()->hasListenerType(Document::DOMSUBTREEMODIFIED_LISTENER))
         return;
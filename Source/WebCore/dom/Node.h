@@ -297,6 +297,17 @@ public:
     bool childNeedsStyleRecalc() const { return getFlag(ChildNeedsStyleRecalcFlag); }
     bool isLink() const { return getFlag(IsLinkFlag); }
 
+#if ENABLE(CSS_SELECTOR_JIT)
+    // Used by the code generated by the selector compiler.
+    static ptrdiff_t parentNodeMemoryOffset();
+    static ptrdiff_t nodeFlagsMemoryOffset() { return OBJECT_OFFSETOF(Node, m_nodeFlags); }
+    static uint32_t flagIsElement() { return IsElementFlag; }
+    static uint32_t flagIsSVG() { return IsSVGFlag; }
+    static uint32_t flagIsShadowRoot() { return IsShadowRootFlag; }
+    static uint32_t flagHasID() { return HasIDFlag; }
+    static uint32_t flagHasClass() { return HasClassFlag; }
+#endif
+
     void setHasID(bool f) { setFlag(f, HasIDFlag); }
     void setHasClass(bool f) { setFlag(f, HasClassFlag); }
     void setChildNeedsStyleRecalc() { setFlag(ChildNeedsStyleRecalcFlag); }
@@ -510,9 +521,20 @@ public:
     void unregisterDynamicNodeList(DynamicNodeList*);
     void notifyNodeListsChildrenChanged();
     void notifyLocalNodeListsChildrenChanged();
-    void notifyNodeListsAttributeChanged();
-    void notifyLocalNodeListsAttributeChanged();
-    void notifyLocalNodeListsLabelChanged();
+    void notifyNodeListsAttributeChanged(const QualifiedName&);
+    void notifyLocalNodeListsAttributeChanged(const QualifiedName&);
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    // How many attribute changes had to walk up the tree to invalidate node list
+    // caches, and how many were skipped because no list depends on the attribute.
+    struct NodeListInvalidationStatistics {
+        unsigned invalidationsPerformed;
+        unsigned invalidationsSkipped;
+        NodeListInvalidationStatistics() : invalidationsPerformed(0), invalidationsSkipped(0) { }
+    };
+    static NodeListInvalidationStatistics attributeNodeListInvalidationStatistics();
+#endif
+
     void removeCachedClassNodeList(ClassNodeList*, const String&);
     void removeCachedNameNodeList(NameNodeList*, const String&);
     void removeCachedTagNodeList(TagNodeList*, const QualifiedName&);
@@ -731,6 +753,16 @@ inline ContainerNode* Node::parentNode() const
     return getFlag(IsShadowRootFlag) || isSVGShadowRoot() ? 0 : parent();
 }
 
+#if ENABLE(CSS_SELECTOR_JIT)
+inline ptrdiff_t Node::parentNodeMemoryOffset()
+{
+    // The parent pointer is kept by the TreeShared base class.
+    const Node* node = reinterpret_cast<const Node*>(0x4000);
+    const TreeShared<ContainerNode>* treeShared = node;
+    return reinterpret_cast<const char*>(treeShared) - reinterpret_cast<const char*>(node) + TreeShared<ContainerNode>::parentMemoryOffset();
+}
+#endif
+
 inline ContainerNode* Node::parentOrHostNode() const
 {
     return parent();
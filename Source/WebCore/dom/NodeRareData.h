@@ -61,7 +61,8 @@ public:
     }
     
     void invalidateCaches();
-    void invalidateCachesThatDependOnAttributes();
+    void invalidateCachesThatDependOnAttribute(const QualifiedName&);
+    void moveNodeListsThatDependOnAttributes(TreeScope* oldScope, TreeScope* newScope);
     bool isEmpty() const;
 
 private:
@@ -87,6 +87,9 @@ public:
     String toString() const;
 
     QualifiedNameImpl* impl() const { return m_impl; }
+#if ENABLE(CSS_SELECTOR_JIT)
+    static ptrdiff_t implMemoryOffset() { return OBJECT_OFFSETOF(QualifiedName, m_impl); }
+#endif
     
     // Init routine for globals
     static void init();
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2007, 2008 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1.  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ * 2.  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ * 3.  Neither the name of Apple Computer, Inc. ("Apple") nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE AND ITS CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL APPLE OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SelectorQuery.h"
+
+#include "CSSParser.h"
+#include "CSSSelector.h"
+#include "CSSStyleSelector.h"
+#include "Document.h"
+#include "ExceptionCode.h"
+#include "StaticNodeList.h"
+#include "StyledElement.h"
+
+namespace WebCore {
+
+SelectorQuery::SelectorQuery(CSSSelectorList& selectorList, bool strictParsing)
+    : m_strictParsing(strictParsing)
+{
+    m_selectorList.adopt(selectorList);
+}
+
+PassRefPtr<NodeList> SelectorQuery::queryAll(Node* rootNode) const
+{
+    Vector<RefPtr<Node> > matchedElements;
+    execute<false>(rootNode, matchedElements);
+    return StaticNodeList::adopt(matchedElements);
+}
+
+PassRefPtr<Element> SelectorQuery::queryFirst(Node* rootNode) const
+{
+    Vector<RefPtr<Node> > matchedElements;
+    execute<true>(rootNode, matchedElements);
+    if (matchedElements.isEmpty())
+        return 0;
+    ASSERT(matchedElements.size() == 1);
+    return static_cast<Element*>(matchedElements.first().get());
+}
+
+static const AtomicString& idInRightmostCompound(const CSSSelector* selector)
+{
+    for (; selector; selector = selector->tagHistory()) {
+        if (selector->m_match == CSSSelector::Id)
+            return selector->value();
+        if (selector->relation() != CSSSelector::SubSelector)
+            break;
+    }
+    return nullAtom;
+}
+
+static inline bool isSimpleClassSelector(const CSSSelector* selector)
+{
+    return selector->m_match == CSSSelector::Class && !selector->hasTag() && !selector->tagHistory();
+}
+
+static inline bool isSimpleTagSelector(const CSSSelector* selector)
+{
+    return selector->m_match == CSSSelector::None && !selector->tagHistory();
+}
+
+// Same as the tag check done by the SelectorChecker.
+static inline bool tagMatches(const Element* element, const QualifiedName& tag)
+{
+    const AtomicString& localName = tag.localName();
+    if (localName != starAtom && localName != element->localName())
+        return false;
+    const AtomicString& namespaceURI = tag.namespaceURI();
+    return namespaceURI == starAtom || namespaceURI == element->namespaceURI();
+}
+
+template <bool firstMatchOnly>
+void SelectorQuery::execute(Node* rootNode, Vector<RefPtr<Node> >& matchedElements) const
+{
+    Document* document = rootNode->document();
+    CSSSelector* onlySelector = m_selectorList.hasOneSelector() ? m_selectorList.first() : 0;
+
+    CSSStyleSelector::SelectorChecker selectorChecker(document, m_strictParsing);
+
+    // Ids are matched case-insensitively in quirks mode, unlike getElementById().
+    if (onlySelector && m_strictParsing && rootNode->inDocument()) {
+        const AtomicString& id = idInRightmostCompound(onlySelector);
+        if (!id.isNull() && !document->containsMultipleElementsWithId(id)) {
+            Element* element = document->getElementById(id);
+            if (element && (rootNode->isDocumentNode() || element->isDescendantOf(rootNode)) && selectorChecker.checkSelector(onlySelector, element))
+                matchedElements.append(element);
+            return;
+        }
+    }
+
+    if (onlySelector && isSimpleClassSelector(onlySelector)) {
+        const AtomicString& className = onlySelector->value();
+        for (Node* n = rootNode->firstChild(); n; n = n->traverseNextNode(rootNode)) {
+            if (n->isElementNode() && static_cast<Element*>(n)->hasClass() && static_cast<StyledElement*>(n)->classNames().contains(className)) {
+                matchedElements.append(n);
+                if (firstMatchOnly)
+                    return;
+            }
+        }
+        return;
+    }
+
+    if (onlySelector && isSimpleTagSelector(onlySelector)) {
+        const QualifiedName& tag = onlySelector->tag();
+        for (Node* n = rootNode->firstChild(); n; n = n->traverseNextNode(rootNode)) {
+            if (n->isElementNode() && tagMatches(static_cast<Element*>(n), tag)) {
+                matchedElements.append(n);
+                if (firstMatchOnly)
+                    return;
+            }
+        }
+        return;
+    }
+
+    for (Node* n = rootNode->firstChild(); n; n = n->traverseNextNode(rootNode)) {
+        if (!n->isElementNode())
+            continue;
+        Element* element = static_cast<Element*>(n);
+        for (CSSSelector* selector = m_selectorList.first(); selector; selector = CSSSelectorList::next(selector)) {
+            if (selectorChecker.checkSelector(selector, element)) {
+                matchedElements.append(element);
+                if (firstMatchOnly)
+                    return;
+                break;
+            }
+        }
+    }
+}
+
+SelectorQueryCache::~SelectorQueryCache()
+{
+    deleteAllValues(m_entries);
+}
+
+SelectorQuery* SelectorQueryCache::add(const AtomicString& selectors, Document* document, ExceptionCode& ec)
+{
+    SelectorQueryMap::iterator it = m_entries.find(selectors);
+    if (it != m_entries.end()) {
+        if (m_usageOrder.last() != selectors) {
+            m_usageOrder.remove(selectors);
+            m_usageOrder.add(selectors);
+        }
+        return it->second;
+    }
+
+    bool strictParsing = !document->inQuirksMode();
+    CSSParser parser(strictParsing);
+    CSSSelectorList selectorList;
+    parser.parseSelector(selectors, document, selectorList);
+
+    if (!selectorList.first() || selectorList.hasUnknownPseudoElements()) {
+        ec = SYNTAX_ERR;
+        return 0;
+    }
+
+    // Throw a NAMESPACE_ERR if the selector includes any namespace prefixes.
+    if (selectorList.selectorsNeedNamespaceResolution()) {
+        ec = NAMESPACE_ERR;
+        return 0;
+    }
+
+    if (m_entries.size() == maximumSelectorQueryCacheSize) {
+        AtomicString leastRecentlyUsed = m_usageOrder.first();
+        m_usageOrder.remove(m_usageOrder.begin());
+        delete m_entries.take(leastRecentlyUsed);
+    }
+
+    SelectorQuery* selectorQuery = new SelectorQuery(selectorList, strictParsing);
+    m_entries.add(selectors, selectorQuery);
+    m_usageOrder.add(selectors);
+    return selectorQuery;
+}
+
+void SelectorQueryCache::invalidate()
+{
+    deleteAllValues(m_entries);
+    m_entries.clear();
+    m_usageOrder.clear();
+}
+
+} // namespace WebCore
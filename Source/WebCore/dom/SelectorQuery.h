@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2007, 2008 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1.  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ * 2.  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ * 3.  Neither the name of Apple Computer, Inc. ("Apple") nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE AND ITS CONTRIBUTORS "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL APPLE OR ITS CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SelectorQuery_h
+#define SelectorQuery_h
+
+#include "CSSSelectorList.h"
+#include <wtf/HashMap.h>
+#include <wtf/ListHashSet.h>
+#include <wtf/PassRefPtr.h>
+#include <wtf/text/AtomicStringHash.h>
+
+namespace WebCore {
+
+    class Document;
+    class Element;
+    class Node;
+    class NodeList;
+
+    typedef int ExceptionCode;
+
+    // A parsed selector group, ready to be matched against the descendants of any node in
+    // the document it was parsed for.
+    class SelectorQuery {
+        WTF_MAKE_NONCOPYABLE(SelectorQuery); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        // Adopts the selectors from the given list.
+        SelectorQuery(CSSSelectorList&, bool strictParsing);
+
+        PassRefPtr<NodeList> queryAll(Node* rootNode) const;
+        PassRefPtr<Element> queryFirst(Node* rootNode) const;
+
+    private:
+        template <bool firstMatchOnly> void execute(Node* rootNode, Vector<RefPtr<Node> >&) const;
+
+        CSSSelectorList m_selectorList;
+        bool m_strictParsing;
+    };
+
+    // Scripts tend to query the same few selectors over and over, so each Document keeps
+    // the most recently used ones parsed.
+    class SelectorQueryCache {
+        WTF_MAKE_NONCOPYABLE(SelectorQueryCache); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        SelectorQueryCache() { }
+        ~SelectorQueryCache();
+
+        // Returns 0 and sets the exception code if the selectors are not valid.
+        SelectorQuery* add(const AtomicString& selectors, Document*, ExceptionCode&);
+        void invalidate();
+
+    private:
+        static const unsigned maximumSelectorQueryCacheSize = 256;
+
+        typedef HashMap<AtomicString, SelectorQuery*> SelectorQueryMap;
+        SelectorQueryMap m_entries;
+        // Least recently used first.
+        ListHashSet<AtomicString> m_usageOrder;
+    };
+
+} // namespace WebCore
+
+#endif // SelectorQuery_h
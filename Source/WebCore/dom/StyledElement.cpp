@@ -199,6 +199,7 @@ void StyledElement::attributeChanged(Attribute* attr, bool preserveDecls)
             attributeMap()->declAdded();
     }
 
+    notifyNodeListsAttributeChanged(attr->name());
     updateAfterAttributeChanged(attr);
 }
 
@@ -220,6 +221,15 @@ void StyledElement::classAttributeChanged(const AtomicString& newClassString)
             break;
     }
     bool hasClass = i < length;
+
+    Vector<AtomicString> oldClasses;
+    if (attached() && this->hasClass()) {
+        const SpaceSplitString& oldClassNames = classNames();
+        oldClasses.reserveInitialCapacity(oldClassNames.size());
+        for (size_t j = 0; j < oldClassNames.size(); ++j)
+            oldClasses.uncheckedAppend(oldClassNames[j]);
+    }
+
     setHasClass(hasClass);
     if (hasClass) {
         attributes()->setClass(newClassString);
@@ -227,7 +237,10 @@ void StyledElement::classAttributeChanged(const AtomicString& newClassString)
             static_cast<ClassList*>(classList)->reset(newClassString);
     } else if (attributeMap())
         attributeMap()->clearClass();
-    setNeedsStyleRecalc();
+    if (attached())
+        document()->styleSelector()->invalidateStyleForClassChange(this, oldClasses);
+    else
+        setNeedsStyleRecalc();
     dispatchSubtreeModifiedEvent();
 }
 
@@ -42,6 +42,9 @@ TreeScope::TreeScope(Document* document, ConstructionType constructionType)
     , m_accessKeyMapValid(false)
     , m_numNodeListCaches(0)
 {
+    for (unsigned i = 0; i < NumNodeListAttributeDependencies; ++i)
+        m_numNodeListsThatDependOnAttribute[i] = 0;
+
     m_document = document;
     if (document != this) {
         // Assume document as parent scope
@@ -64,6 +67,17 @@ void TreeScope::destroyTreeScopeData()
     m_elementsByAccessKey.clear();
 }
 
+bool TreeScope::hasNodeListsThatDependOnAttribute(const QualifiedName& attrName) const
+{
+    if (attrName == classAttr)
+        return m_numNodeListsThatDependOnAttribute[DependsOnClassAttribute];
+    if (attrName == nameAttr)
+        return m_numNodeListsThatDependOnAttribute[DependsOnNameAttribute];
+    if (attrName == idAttr || attrName == forAttr)
+        return m_numNodeListsThatDependOnAttribute[DependsOnLabelAttributes];
+    return false;
+}
+
 void TreeScope::setParentTreeScope(TreeScope* newParentScope)
 {
     // A document node cannot be re-parented.
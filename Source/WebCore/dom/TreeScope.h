@@ -28,6 +28,7 @@
 
 #include "ContainerNode.h"
 #include "DocumentOrderedMap.h"
+#include "DynamicNodeList.h"
 
 namespace WebCore {
 
@@ -57,6 +58,12 @@ public:
     void removeNodeListCache() { ASSERT(m_numNodeListCaches > 0); --m_numNodeListCaches; }
     bool hasNodeListCaches() const { return m_numNodeListCaches; }
 
+    // Counts the cached node lists that depend on an attribute, so that changes to
+    // attributes no list looks at don't walk up the tree to invalidate caches.
+    void addNodeListThatDependsOnAttribute(NodeListAttributeDependency dependency) { ++m_numNodeListsThatDependOnAttribute[dependency]; }
+    void removeNodeListThatDependsOnAttribute(NodeListAttributeDependency dependency) { ASSERT(m_numNodeListsThatDependOnAttribute[dependency] > 0); --m_numNodeListsThatDependOnAttribute[dependency]; }
+    bool hasNodeListsThatDependOnAttribute(const QualifiedName&) const;
+
     // Find first anchor with the given name.
     // First searches for an element with the given ID, but if that fails, then looks
     // for an anchor with the given name. ID matching is always case sensitive, but
@@ -83,6 +90,7 @@ private:
     mutable bool m_accessKeyMapValid;
 
     unsigned m_numNodeListCaches;
+    unsigned m_numNodeListsThatDependOnAttribute[NumNodeListAttributeDependencies];
 };
 
 inline bool TreeScope::hasElementWithId(AtomicStringImpl* id) const
@@ -42,6 +42,14 @@ namespace WebCore {
     enum EChildrenOnly { IncludeNode, ChildrenOnly };
     enum EAbsoluteURLs { DoNotResolveURLs, AbsoluteURLs };
 
+    // Receives the markup of a large subtree, such as a whole page being saved,
+    // piece by piece instead of as one string.
+    class MarkupChunkClient {
+    public:
+        virtual ~MarkupChunkClient() { }
+        virtual void didSerializeMarkupChunk(const String&) = 0;
+    };
+
     PassRefPtr<DocumentFragment> createFragmentFromText(Range* context, const String& text);
     PassRefPtr<DocumentFragment> createFragmentFromMarkup(Document*, const String& markup, const String& baseURL, FragmentScriptingPermission = FragmentScriptingAllowed);
     PassRefPtr<DocumentFragment> createFragmentFromNodes(Document*, const Vector<Node*>&);
@@ -51,6 +59,7 @@ namespace WebCore {
     String createMarkup(const Range*,
         Vector<Node*>* = 0, EAnnotateForInterchange = DoNotAnnotateForInterchange, bool convertBlocksToInlines = false, EAbsoluteURLs = DoNotResolveURLs);
     String createMarkup(const Node*, EChildrenOnly = IncludeNode, Vector<Node*>* = 0, EAbsoluteURLs = DoNotResolveURLs);
+    void createMarkupInChunks(const Node*, MarkupChunkClient*, EChildrenOnly = IncludeNode, EAbsoluteURLs = DoNotResolveURLs);
     
     String createFullMarkup(const Node*);
     String createFullMarkup(const Range*);
@@ -43,8 +43,10 @@ CollectionCache::CollectionCache(const CollectionCache& other)
     , position(other.position)
     , length(other.length)
     , elementsArrayPosition(other.elementsArrayPosition)
+    , items(other.items)
     , hasLength(other.hasLength)
     , hasNameCache(other.hasNameCache)
+    , hasItems(other.hasItems)
 {
     copyCacheMap(idCache, other.idCache);
     copyCacheMap(nameCache, other.nameCache);
@@ -60,9 +62,11 @@ void CollectionCache::swap(CollectionCache& other)
 
     idCache.swap(other.idCache);
     nameCache.swap(other.nameCache);
+    items.swap(other.items);
     
     std::swap(hasLength, other.hasLength);
     std::swap(hasNameCache, other.hasNameCache);
+    std::swap(hasItems, other.hasItems);
 }
 
 CollectionCache::~CollectionCache()
@@ -83,6 +87,8 @@ void CollectionCache::reset()
     deleteAllValues(nameCache);
     nameCache.clear();
     hasNameCache = false;
+    items.clear();
+    hasItems = false;
 }
 
 #if !ASSERT_DISABLED
@@ -56,8 +56,11 @@ public:
     int elementsArrayPosition;
     NodeCacheMap idCache;
     NodeCacheMap nameCache;
+    // Every item, in order, once the collection has been accessed out of order.
+    Vector<Element*> items;
     bool hasLength;
     bool hasNameCache;
+    bool hasItems;
 
 private:
     static void copyCacheMap(NodeCacheMap&, const NodeCacheMap&);
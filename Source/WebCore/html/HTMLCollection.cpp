@@ -222,14 +222,39 @@ unsigned HTMLCollection::length() const
     return m_info->length;
 }
 
+void HTMLCollection::fillItemArray() const
+{
+    Vector<Element*>& items = m_info->items;
+    items.clear();
+    for (Element* current = itemAfter(0); current; current = itemAfter(current))
+        items.append(current);
+
+    m_info->length = items.size();
+    m_info->hasLength = true;
+    m_info->hasItems = true;
+}
+
 Node* HTMLCollection::item(unsigned index) const
 {
      resetCollectionInfo();
+     if (m_info->hasItems) {
+         if (index >= m_info->items.size())
+             return 0;
+         m_info->current = m_info->items[index];
+         m_info->position = index;
+         return m_info->current;
+     }
      if (m_info->current && m_info->position == index)
          return m_info->current;
      if (m_info->hasLength && m_info->length <= index)
          return 0;
-     if (!m_info->current || m_info->position > index) {
+     // Items can only be found by walking forwards, so going back would restart from the first
+     // one. Look up anything other than the next item in a snapshot of the collection instead.
+     if (m_info->current && (m_info->position > index || index - m_info->position > 1)) {
+         fillItemArray();
+         return item(index);
+     }
+     if (!m_info->current) {
          m_info->current = itemAfter(0);
          m_info->position = 0;
          if (!m_info->current)
@@ -71,6 +71,7 @@ protected:
 private:
     virtual Element* itemAfter(Element*) const;
     virtual unsigned calcLength() const;
+    void fillItemArray() const;
     virtual void updateNameCache() const;
 
     bool checkForNameMatch(Element*, bool checkName, const AtomicString& name) const;
@@ -492,11 +492,11 @@ void HTMLInputElement::updateType()
         NamedNodeMap* map = attributeMap();
         ASSERT(map);
         if (Attribute* height = map->getAttributeItem(heightAttr))
-            attributeChanged(height, false);
+            attributeChanged(map->unsharedAttributeItem(height), false);
         if (Attribute* width = map->getAttributeItem(widthAttr))
-            attributeChanged(width, false);
+            attributeChanged(map->unsharedAttributeItem(width), false);
         if (Attribute* align = map->getAttributeItem(alignAttr))
-            attributeChanged(align, false);
+            attributeChanged(map->unsharedAttributeItem(align), false);
     }
 
     if (wasAttached) {
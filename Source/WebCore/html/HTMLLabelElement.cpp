@@ -156,12 +156,8 @@ void HTMLLabelElement::accessKeyAction(bool sendToAnyElement)
 
 void HTMLLabelElement::parseMappedAttribute(Attribute* attribute)
 {
-    if (attribute->name() == forAttr) {
-        // htmlFor attribute change affects other nodes than this.
-        // Clear the caches to ensure that the labels caches are cleared.
-        if (document())
-            document()->notifyLocalNodeListsLabelChanged();
-    } else
+    // A change to the for attribute invalidates the labels lists from attributeChanged().
+    if (attribute->name() != forAttr)
         HTMLElement::parseMappedAttribute(attribute);
 }
                 
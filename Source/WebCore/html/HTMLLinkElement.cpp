@@ -386,7 +386,10 @@ void HTMLLinkElement::setCSSStyleSheet(const String& href, const KURL& baseURL,
 #endif
 
     String sheetText = sheet->sheetText(enforceMIMEType, &validMIMEType);
-    m_sheet->parseString(sheetText, strictParsing);
+    if (const Vector<CSSBlockExtent>* blocks = sheet->preparsedBlocks())
+        m_sheet->parsePreparsedString(sheetText, strictParsing, *blocks);
+    else
+        m_sheet->parseString(sheetText, strictParsing);
 
     // If we're loading a stylesheet cross-origin, and the MIME type is not
     // standard, require the CSS to at least start with a syntactically
@@ -35,11 +35,13 @@ using namespace HTMLNames;
 LabelsNodeList::LabelsNodeList(PassRefPtr<Node> forNode )
     : DynamicNodeList(forNode->document()) , m_forNode(forNode)
 {
+    rootNode()->document()->addNodeListThatDependsOnAttribute(DependsOnLabelAttributes);
 }
 
 LabelsNodeList::~LabelsNodeList()
 {
     m_forNode->removeCachedLabelsNodeList(this);
+    rootNode()->document()->removeNodeListThatDependsOnAttribute(DependsOnLabelAttributes);
 } 
     
 bool LabelsNodeList::nodeMatches(Element* testNode) const
@@ -0,0 +1,462 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "BackgroundHTMLParser.h"
+
+#include "CrossThreadTask.h"
+#include "HTMLDocumentParser.h"
+#include "HTMLInputStream.h"
+#include "HTMLPreloadScanner.h"
+#include "HTMLToken.h"
+#include "HTMLTokenizer.h"
+#include "HTMLTreeBuilderSimulator.h"
+#include "ScriptExecutionContext.h"
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+#include <wtf/MessageQueue.h>
+#include <wtf/Threading.h>
+
+namespace WebCore {
+
+// Tokens go to the main thread once this many have piled up, and whenever
+// the parser thread runs out of source.
+static const size_t tokenBatchSize = 256;
+
+namespace {
+
+// Owns the thread that all documents are tokenized on.
+class HTMLParserThread {
+public:
+    static HTMLParserThread* instance()
+    {
+        DEFINE_STATIC_LOCAL(HTMLParserThread*, instance, (new HTMLParserThread));
+        return instance;
+    }
+
+    void postTask(PassOwnPtr<ScriptExecutionContext::Task> task)
+    {
+        ASSERT(isMainThread());
+        if (!m_threadId)
+            m_threadId = createThread(threadEntryPoint, this, "WebCore: HTML parser");
+        m_queue.append(task);
+    }
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    BackgroundHTMLParser::Statistics statistics()
+    {
+        MutexLocker lock(m_statisticsMutex);
+        return m_statistics;
+    }
+
+    void didStartDocument()
+    {
+        MutexLocker lock(m_statisticsMutex);
+        ++m_statistics.documentsParsed;
+    }
+
+    void didHandOverDocument()
+    {
+        MutexLocker lock(m_statisticsMutex);
+        ++m_statistics.documentsHandedOver;
+    }
+
+    void didTokenize(unsigned characters, double time)
+    {
+        MutexLocker lock(m_statisticsMutex);
+        m_statistics.charactersTokenized += characters;
+        m_statistics.tokenizeTime += time;
+    }
+
+    void didProcessTokens(unsigned characters, double time)
+    {
+        MutexLocker lock(m_statisticsMutex);
+        m_statistics.charactersProcessed += characters;
+        m_statistics.mainThreadTime += time;
+    }
+#endif
+
+private:
+    HTMLParserThread()
+        : m_threadId(0)
+    {
+    }
+
+    static void* threadEntryPoint(void* object)
+    {
+        HTMLParserThread* thread = static_cast<HTMLParserThread*>(object);
+        while (OwnPtr<ScriptExecutionContext::Task> task = thread->m_queue.waitForMessage()) {
+            // We don't need a ScriptExecutionContext in the callback, so pass 0 here.
+            task->performTask(0);
+        }
+        return 0;
+    }
+
+    ThreadIdentifier m_threadId;
+    MessageQueue<ScriptExecutionContext::Task> m_queue;
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    BackgroundHTMLParser::Statistics m_statistics;
+    Mutex m_statisticsMutex;
+#endif
+};
+
+} // namespace
+
+// The part of a BackgroundHTMLParser that the parser thread works on.
+class BackgroundHTMLTokenizer : public ThreadSafeRefCounted<BackgroundHTMLTokenizer> {
+public:
+    static PassRefPtr<BackgroundHTMLTokenizer> create(BackgroundHTMLParser* client, const BackgroundHTMLParser::Options& options)
+    {
+        return adoptRef(new BackgroundHTMLTokenizer(client, options));
+    }
+
+    // Main thread only.
+    void detach();
+    void takeTokens(Vector<OwnPtr<CompactHTMLTokenBatch> >&);
+
+    static void appendOnParserThread(ScriptExecutionContext*, PassRefPtr<BackgroundHTMLTokenizer>, const String&);
+    static void finishOnParserThread(ScriptExecutionContext*, PassRefPtr<BackgroundHTMLTokenizer>);
+
+private:
+    BackgroundHTMLTokenizer(BackgroundHTMLParser*, const BackgroundHTMLParser::Options&);
+
+    bool isDetached();
+    void pumpTokenizer();
+    void sendTokensToMainThread();
+    static void didSendTokensOnMainThread(void*);
+
+    // Only touched on the main thread.
+    BackgroundHTMLParser* m_client;
+
+    // Only touched on the parser thread.
+    OwnPtr<HTMLTokenizer> m_tokenizer;
+    SegmentedString m_input;
+    HTMLToken m_token;
+    HTMLTreeBuilderSimulator m_simulator;
+    OwnPtr<CompactHTMLTokenBatch> m_pendingTokens;
+
+    Mutex m_mutex;
+    bool m_detached;
+    Vector<OwnPtr<CompactHTMLTokenBatch> > m_tokensForMainThread;
+};
+
+BackgroundHTMLTokenizer::BackgroundHTMLTokenizer(BackgroundHTMLParser* client, const BackgroundHTMLParser::Options& options)
+    : m_client(client)
+    , m_tokenizer(HTMLTokenizer::create(options.usePreHTML5ParserQuirks))
+    , m_simulator(options.scriptEnabled, options.pluginsEnabled)
+    , m_detached(false)
+{
+}
+
+void BackgroundHTMLTokenizer::detach()
+{
+    ASSERT(isMainThread());
+    m_client = 0;
+    MutexLocker lock(m_mutex);
+    m_detached = true;
+}
+
+bool BackgroundHTMLTokenizer::isDetached()
+{
+    MutexLocker lock(m_mutex);
+    return m_detached;
+}
+
+void BackgroundHTMLTokenizer::takeTokens(Vector<OwnPtr<CompactHTMLTokenBatch> >& batches)
+{
+    ASSERT(isMainThread());
+    MutexLocker lock(m_mutex);
+    for (size_t i = 0; i < m_tokensForMainThread.size(); ++i)
+        batches.append(m_tokensForMainThread[i].release());
+    m_tokensForMainThread.clear();
+}
+
+void BackgroundHTMLTokenizer::appendOnParserThread(ScriptExecutionContext*, PassRefPtr<BackgroundHTMLTokenizer> prpTokenizer, const String& source)
+{
+    RefPtr<BackgroundHTMLTokenizer> tokenizer = prpTokenizer;
+    if (tokenizer->isDetached())
+        return;
+    tokenizer->m_input.append(SegmentedString(source));
+    tokenizer->pumpTokenizer();
+}
+
+void BackgroundHTMLTokenizer::finishOnParserThread(ScriptExecutionContext*, PassRefPtr<BackgroundHTMLTokenizer> prpTokenizer)
+{
+    RefPtr<BackgroundHTMLTokenizer> tokenizer = prpTokenizer;
+    if (tokenizer->isDetached())
+        return;
+    // See HTMLInputStream::markEndOfFile().
+    static const UChar endOfFileMarker = 0;
+    tokenizer->m_input.append(SegmentedString(String(&endOfFileMarker, 1)));
+    tokenizer->m_input.close();
+    tokenizer->pumpTokenizer();
+}
+
+void BackgroundHTMLTokenizer::pumpTokenizer()
+{
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double startTime = currentTime();
+    int startOffset = m_input.numberOfCharactersConsumed();
+#endif
+
+    while (m_tokenizer->nextToken(m_input, m_token)) {
+        if (!m_pendingTokens) {
+            m_pendingTokens = adoptPtr(new CompactHTMLTokenBatch);
+            m_pendingTokens->reserveInitialCapacity(tokenBatchSize);
+        }
+        // Build the token in the batch itself rather than in a local that would
+        // still hold references to its strings after the batch has been sent.
+        m_pendingTokens->append(CompactHTMLToken(m_token, TextPosition0(m_input.currentLine(), m_input.currentColumn())));
+        m_token.clear();
+        CompactHTMLToken& token = m_pendingTokens->last();
+        token.setSourceOffset(m_input.numberOfCharactersConsumed());
+        token.setIsResumable(!m_tokenizer->hasBufferedInput());
+        ASSERT(token.isResumable() || token.type() == HTMLToken::Character);
+
+        HTMLTokenizerSnapshot stateAfterEmission(*m_tokenizer);
+        m_simulator.simulate(token, *m_tokenizer);
+        token.setTokenizerStates(stateAfterEmission, HTMLTokenizerSnapshot(*m_tokenizer));
+
+        if (m_pendingTokens->size() >= tokenBatchSize)
+            sendTokensToMainThread();
+    }
+    sendTokensToMainThread();
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    HTMLParserThread::instance()->didTokenize(m_input.numberOfCharactersConsumed() - startOffset, currentTime() - startTime);
+#endif
+}
+
+void BackgroundHTMLTokenizer::sendTokensToMainThread()
+{
+    if (!m_pendingTokens)
+        return;
+
+    // Nothing on this thread refers to the tokens' strings: the tokens were
+    // built in the batch and the simulator keeps its own copies of the names
+    // it needs, so the main thread can take the batch over without copying.
+    bool mainThreadHasBeenTold;
+    {
+        MutexLocker lock(m_mutex);
+        mainThreadHasBeenTold = !m_tokensForMainThread.isEmpty();
+        m_tokensForMainThread.append(m_pendingTokens.release());
+    }
+    if (!mainThreadHasBeenTold)
+        callOnMainThread(didSendTokensOnMainThread, PassRefPtr<BackgroundHTMLTokenizer>(this).leakRef());
+}
+
+void BackgroundHTMLTokenizer::didSendTokensOnMainThread(void* context)
+{
+    RefPtr<BackgroundHTMLTokenizer> tokenizer = adoptRef(static_cast<BackgroundHTMLTokenizer*>(context));
+    if (BackgroundHTMLParser* client = tokenizer->m_client)
+        client->didReceiveTokens();
+}
+
+bool BackgroundHTMLParser::s_enabled = false;
+
+BackgroundHTMLParser::BackgroundHTMLParser(HTMLDocumentParser* parser, const Options& options)
+    : m_parser(parser)
+    , m_tokenizer(BackgroundHTMLTokenizer::create(this, options))
+    , m_finishWasCalled(false)
+    , m_processedEndOfFile(false)
+    , m_sourceStart(0)
+    , m_nextToken(0)
+    , m_receivedTokenCount(0)
+    , m_resumableTokenCount(0)
+    , m_takenTokenCount(0)
+    , m_scannedTokenCount(0)
+#if ENABLE(PERFORMANCE_STATISTICS)
+    , m_processedSourceOffset(0)
+    , m_charactersProcessed(0)
+    , m_mainThreadTime(0)
+#endif
+{
+#if ENABLE(PERFORMANCE_STATISTICS)
+    HTMLParserThread::instance()->didStartDocument();
+#endif
+}
+
+BackgroundHTMLParser::~BackgroundHTMLParser()
+{
+    m_tokenizer->detach();
+#if ENABLE(PERFORMANCE_STATISTICS)
+    reportProcessedTokens();
+#endif
+}
+
+void BackgroundHTMLParser::append(const String& source)
+{
+    ASSERT(!m_finishWasCalled);
+    m_source.append(source);
+    HTMLParserThread::instance()->postTask(createCallbackTask(&BackgroundHTMLTokenizer::appendOnParserThread, m_tokenizer, source));
+}
+
+void BackgroundHTMLParser::finish()
+{
+    if (m_finishWasCalled)
+        return;
+    m_finishWasCalled = true;
+    HTMLParserThread::instance()->postTask(createCallbackTask(&BackgroundHTMLTokenizer::finishOnParserThread, m_tokenizer));
+}
+
+void BackgroundHTMLParser::didReceiveTokens()
+{
+#if ENABLE(PERFORMANCE_STATISTICS)
+    reportProcessedTokens();
+#endif
+
+    size_t firstNewBatch = m_batches.size();
+    m_tokenizer->takeTokens(m_batches);
+    for (size_t i = firstNewBatch; i < m_batches.size(); ++i) {
+        const CompactHTMLTokenBatch& batch = *m_batches[i];
+        for (size_t j = 0; j < batch.size(); ++j) {
+            ++m_receivedTokenCount;
+            if (batch[j].isResumable())
+                m_resumableTokenCount = m_receivedTokenCount;
+        }
+    }
+    m_parser->didReceiveBackgroundTokens();
+}
+
+CompactHTMLToken BackgroundHTMLParser::takeNextToken(const HTMLTokenizer& tokenizer)
+{
+    ASSERT(m_takenTokenCount < m_receivedTokenCount);
+    while (m_nextToken == m_batches[0]->size()) {
+        m_batches.remove(0);
+        m_nextToken = 0;
+    }
+    CompactHTMLToken token = m_batches[0]->at(m_nextToken++);
+    ++m_takenTokenCount;
+
+    if (token.isResumable()) {
+        m_resumePoint.textPosition = token.textPosition();
+        m_resumePoint.sourceOffset = token.sourceOffset();
+        if (token.type() == HTMLToken::StartTag)
+            m_resumePoint.appropriateEndTagName = token.data();
+        m_resumePoint.hasTokenizerState = false;
+        m_resumePoint.charactersSince = 0;
+    } else {
+        if (!m_resumePoint.hasTokenizerState) {
+            m_resumePoint.tokenizerState = HTMLTokenizerSnapshot(tokenizer);
+            m_resumePoint.hasTokenizerState = true;
+        }
+        m_resumePoint.charactersSince += token.data().length();
+    }
+    return token;
+}
+
+void BackgroundHTMLParser::didProcessToken(const CompactHTMLToken& token)
+{
+    if (token.type() == HTMLToken::EndOfFile)
+        m_processedEndOfFile = true;
+
+    while (!m_source.isEmpty() && m_sourceStart + static_cast<int>(m_source.first().length()) <= m_resumePoint.sourceOffset) {
+        m_sourceStart += m_source.first().length();
+        m_source.removeFirst();
+    }
+}
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+void BackgroundHTMLParser::didTakeTimeToProcessToken(const CompactHTMLToken& token, double processingTime)
+{
+    m_charactersProcessed += token.sourceOffset() - m_processedSourceOffset;
+    m_processedSourceOffset = token.sourceOffset();
+    m_mainThreadTime += processingTime;
+}
+
+void BackgroundHTMLParser::reportProcessedTokens()
+{
+    HTMLParserThread::instance()->didProcessTokens(m_charactersProcessed, m_mainThreadTime);
+    m_charactersProcessed = 0;
+    m_mainThreadTime = 0;
+}
+#endif
+
+void BackgroundHTMLParser::scanForPreloads(HTMLPreloadScanner& scanner)
+{
+    size_t tokenNumber = m_takenTokenCount - m_nextToken;
+    size_t firstTokenToScan = std::max(m_takenTokenCount, m_scannedTokenCount);
+    for (size_t i = 0; i < m_batches.size(); ++i) {
+        const CompactHTMLTokenBatch& batch = *m_batches[i];
+        for (size_t j = 0; j < batch.size(); ++j, ++tokenNumber) {
+            if (tokenNumber >= firstTokenToScan)
+                scanner.scan(batch[j]);
+        }
+    }
+    ASSERT(tokenNumber == m_receivedTokenCount);
+    m_scannedTokenCount = m_receivedTokenCount;
+}
+
+SegmentedString BackgroundHTMLParser::takeUnprocessedSource()
+{
+    SegmentedString source;
+    int offset = m_sourceStart;
+    while (!m_source.isEmpty()) {
+        String chunk = m_source.takeFirst();
+        int chunkEnd = offset + chunk.length();
+        if (chunkEnd > m_resumePoint.sourceOffset) {
+            if (offset < m_resumePoint.sourceOffset)
+                chunk = chunk.substring(m_resumePoint.sourceOffset - offset);
+            source.append(SegmentedString(chunk));
+        }
+        offset = chunkEnd;
+    }
+    return source;
+}
+
+unsigned BackgroundHTMLParser::handOver(HTMLTokenizer& tokenizer, HTMLInputStream& input)
+{
+    ASSERT(!m_processedEndOfFile);
+    m_tokenizer->detach();
+
+    if (m_resumePoint.hasTokenizerState)
+        m_resumePoint.tokenizerState.restore(tokenizer);
+    tokenizer.setLineNumber(m_resumePoint.textPosition.m_line.zeroBasedInt());
+    tokenizer.setAppropriateEndTagName(m_resumePoint.appropriateEndTagName);
+
+    // If a script is running, the source goes after the insertion point,
+    // and the position was set when the insertion point was.
+    bool hadInsertionPoint = input.hasInsertionPoint();
+    input.appendToEnd(takeUnprocessedSource());
+    if (!hadInsertionPoint)
+        input.current().setCurrentPosition(m_resumePoint.textPosition.m_line, m_resumePoint.textPosition.m_column, 0);
+    if (m_finishWasCalled)
+        input.markEndOfFile();
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    HTMLParserThread::instance()->didHandOverDocument();
+#endif
+    return m_resumePoint.charactersSince;
+}
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+BackgroundHTMLParser::Statistics BackgroundHTMLParser::statistics()
+{
+    return HTMLParserThread::instance()->statistics();
+}
+#endif
+
+} // namespace WebCore
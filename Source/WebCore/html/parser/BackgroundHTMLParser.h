@@ -0,0 +1,203 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BackgroundHTMLParser_h
+#define BackgroundHTMLParser_h
+
+#include "CompactHTMLToken.h"
+#include "PlatformString.h"
+#include "SegmentedString.h"
+#include <wtf/Deque.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+class BackgroundHTMLTokenizer;
+class HTMLDocumentParser;
+class HTMLInputStream;
+class HTMLPreloadScanner;
+class HTMLTokenizer;
+
+typedef Vector<CompactHTMLToken> CompactHTMLTokenBatch;
+
+// Tokenizes a document's network data on the HTML parser thread and hands
+// the tokens to its HTMLDocumentParser in batches, leaving the main thread
+// only the tree building.
+//
+// The tree builder changes the tokenizer's state as it goes, for instance
+// to RAWTEXT after a <style> start tag, so the parser thread predicts those
+// changes from the tokens themselves. The main thread checks each prediction
+// against what its tree builder did, and on the first wrong one, or as soon
+// as a script writes into the document, it takes back the rest of the source
+// and tokenizes it itself for the rest of the document.
+class BackgroundHTMLParser {
+    WTF_MAKE_NONCOPYABLE(BackgroundHTMLParser); WTF_MAKE_FAST_ALLOCATED;
+public:
+    struct Options {
+        bool usePreHTML5ParserQuirks;
+        bool scriptEnabled;
+        bool pluginsEnabled;
+    };
+
+    static PassOwnPtr<BackgroundHTMLParser> create(HTMLDocumentParser* parser, const Options& options)
+    {
+        return adoptPtr(new BackgroundHTMLParser(parser, options));
+    }
+
+    ~BackgroundHTMLParser();
+
+    static void setEnabled(bool enabled) { s_enabled = enabled; }
+    static bool isEnabled() { return s_enabled; }
+
+    void append(const String&);
+    void finish();
+    bool finishWasCalled() const { return m_finishWasCalled; }
+
+    // A token the tokenizer could not have stopped after is only handed out
+    // once the next one that it could have stopped after has arrived, and
+    // the caller is expected to process the tokens in between without
+    // stopping.
+    bool hasNextToken() const { return m_takenTokenCount < m_resumableTokenCount; }
+
+    // Also records where the main thread tokenizer would have to resume if
+    // it took over while, or after, the tree builder processes the token.
+    // The tokenizer is the main thread one, in its state after the previous
+    // token.
+    CompactHTMLToken takeNextToken(const HTMLTokenizer&);
+    void didProcessToken(const CompactHTMLToken&);
+#if ENABLE(PERFORMANCE_STATISTICS)
+    void didTakeTimeToProcessToken(const CompactHTMLToken&, double processingTime);
+#endif
+    bool processedEndOfFile() const { return m_processedEndOfFile; }
+
+    // Feeds the scanner the tokens that the tree builder has not taken yet
+    // and that have not been scanned before.
+    void scanForPreloads(HTMLPreloadScanner&);
+    bool hasOvertakenPreloadScanner() const { return m_takenTokenCount >= m_scannedTokenCount; }
+
+    // Stops the parser thread's work on the document, puts the tokenizer in
+    // the state it has to resume in and appends the source that has not been
+    // tokenized from that point to the input stream. Returns the number of
+    // characters at the start of the Character tokens the tokenizer emits
+    // next that the tree builder has already processed.
+    unsigned handOver(HTMLTokenizer&, HTMLInputStream&);
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    struct Statistics {
+        Statistics()
+            : documentsParsed(0)
+            , documentsHandedOver(0)
+            , charactersTokenized(0)
+            , tokenizeTime(0)
+            , charactersProcessed(0)
+            , mainThreadTime(0)
+        {
+        }
+
+        unsigned documentsParsed;
+        // Documents whose tokenizing the main thread took over before the end.
+        unsigned documentsHandedOver;
+        unsigned charactersTokenized;
+        // Seconds spent on the parser thread.
+        double tokenizeTime;
+        // Source characters whose tokens the main thread built the tree from,
+        // and the seconds that took, for main thread time per kilobyte.
+        unsigned charactersProcessed;
+        double mainThreadTime;
+    };
+
+    static Statistics statistics();
+#endif
+
+private:
+    friend class BackgroundHTMLTokenizer;
+
+    BackgroundHTMLParser(HTMLDocumentParser*, const Options&);
+
+    void didReceiveTokens();
+#if ENABLE(PERFORMANCE_STATISTICS)
+    void reportProcessedTokens();
+#endif
+    SegmentedString takeUnprocessedSource();
+
+    static bool s_enabled;
+
+    HTMLDocumentParser* m_parser;
+    RefPtr<BackgroundHTMLTokenizer> m_tokenizer;
+    bool m_finishWasCalled;
+    bool m_processedEndOfFile;
+
+    // The source sent to the parser thread that the tree builder has not
+    // been past yet, and the offset of its first character.
+    Deque<String> m_source;
+    int m_sourceStart;
+
+    // Token counts are over the whole document. The tokens the tree builder
+    // has not taken yet start at m_nextToken in m_batches[0].
+    Vector<OwnPtr<CompactHTMLTokenBatch> > m_batches;
+    size_t m_nextToken;
+    size_t m_receivedTokenCount;
+    size_t m_resumableTokenCount;
+    size_t m_takenTokenCount;
+    size_t m_scannedTokenCount;
+
+    // The last point the main thread tokenizer can resume from.
+    struct ResumePoint {
+        ResumePoint()
+            : textPosition(TextPosition0::minimumPosition())
+            , sourceOffset(0)
+            , hasTokenizerState(false)
+            , charactersSince(0)
+        {
+        }
+
+        TextPosition0 textPosition;
+        int sourceOffset;
+        String appropriateEndTagName;
+        // Taken once the tree builder moves on to a token the tokenizer
+        // could not have stopped after. Until then the main thread tokenizer
+        // itself is in the right state.
+        bool hasTokenizerState;
+        HTMLTokenizerSnapshot tokenizerState;
+        // Characters in the tokens processed since.
+        unsigned charactersSince;
+    };
+    ResumePoint m_resumePoint;
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    // Not yet added to the statistics, which are shared with the parser thread.
+    int m_processedSourceOffset;
+    unsigned m_charactersProcessed;
+    double m_mainThreadTime;
+#endif
+};
+
+} // namespace WebCore
+
+#endif // BackgroundHTMLParser_h
@@ -58,6 +58,14 @@ void CSSPreloadScanner::scan(const HTMLToken& token, bool scanningBody)
         tokenize(*iter);
 }
 
+void CSSPreloadScanner::scan(const String& characters, bool scanningBody)
+{
+    m_scanningBody = scanningBody;
+
+    for (unsigned i = 0; i < characters.length() && m_state != DoneParsingImportRules; ++i)
+        tokenize(characters[i]);
+}
+
 inline void CSSPreloadScanner::tokenize(UChar c)
 {
     // We are just interested in @import rules, no need for real tokenization here
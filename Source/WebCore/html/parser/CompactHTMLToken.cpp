@@ -0,0 +1,127 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CompactHTMLToken.h"
+
+#include "Attribute.h"
+#include "HTMLNameCache.h"
+#include "NamedNodeMap.h"
+
+namespace WebCore {
+
+static inline String toString(const HTMLToken::DataVector& vector)
+{
+    return String(vector.data(), vector.size());
+}
+
+CompactHTMLToken::CompactHTMLToken(const HTMLToken& token, const TextPosition0& textPosition)
+    : m_type(token.type())
+    , m_selfClosing(false)
+    , m_forceQuirks(false)
+    , m_isResumable(true)
+    , m_textPosition(textPosition)
+    , m_sourceOffset(0)
+{
+    switch (token.type()) {
+    case HTMLToken::Uninitialized:
+        ASSERT_NOT_REACHED();
+        break;
+    case HTMLToken::DOCTYPE:
+        m_data = toString(token.name());
+        m_publicIdentifier = String(token.publicIdentifier().data(), token.publicIdentifier().size());
+        m_systemIdentifier = String(token.systemIdentifier().data(), token.systemIdentifier().size());
+        m_forceQuirks = token.forceQuirks();
+        break;
+    case HTMLToken::EndOfFile:
+        break;
+    case HTMLToken::StartTag:
+    case HTMLToken::EndTag: {
+        m_selfClosing = token.selfClosing();
+        m_data = toString(token.name());
+        const HTMLToken::AttributeList& attributes = token.attributes();
+        m_attributes.reserveInitialCapacity(attributes.size());
+        for (HTMLToken::AttributeList::const_iterator iter = attributes.begin(); iter != attributes.end(); ++iter) {
+            // AtomicHTMLToken drops these as well.
+            if (iter->m_name.isEmpty())
+                continue;
+            m_attributes.append(Attribute(toString(iter->m_name), toString(iter->m_value)));
+        }
+        break;
+    }
+    case HTMLToken::Comment:
+        m_data = toString(token.comment());
+        break;
+    case HTMLToken::Character:
+        m_data = toString(token.characters());
+        break;
+    }
+}
+
+AtomicHTMLToken::AtomicHTMLToken(const CompactHTMLToken& token)
+    : m_type(token.type())
+{
+    switch (m_type) {
+    case HTMLToken::Uninitialized:
+        ASSERT_NOT_REACHED();
+        break;
+    case HTMLToken::DOCTYPE:
+        m_name = token.data();
+        m_doctypeData = adoptPtr(new HTMLToken::DoctypeData);
+        m_doctypeData->m_hasPublicIdentifier = !token.publicIdentifier().isEmpty();
+        m_doctypeData->m_hasSystemIdentifier = !token.systemIdentifier().isEmpty();
+        m_doctypeData->m_forceQuirks = token.forceQuirks();
+        m_doctypeData->m_publicIdentifier.append(token.publicIdentifier().characters(), token.publicIdentifier().length());
+        m_doctypeData->m_systemIdentifier.append(token.systemIdentifier().characters(), token.systemIdentifier().length());
+        break;
+    case HTMLToken::EndOfFile:
+        break;
+    case HTMLToken::StartTag:
+    case HTMLToken::EndTag: {
+        m_selfClosing = token.selfClosing();
+        m_name = HTMLNameCache::makeName(token.data().characters(), token.data().length());
+        const Vector<CompactHTMLToken::Attribute>& attributes = token.attributes();
+        if (attributes.isEmpty())
+            break;
+        m_attributes = NamedNodeMap::create();
+        m_attributes->reserveInitialCapacity(attributes.size());
+        for (Vector<CompactHTMLToken::Attribute>::const_iterator iter = attributes.begin(); iter != attributes.end(); ++iter) {
+            AtomicString name = HTMLNameCache::makeName(iter->name.characters(), iter->name.length());
+            AtomicString value = HTMLNameCache::makeAttributeValue(iter->value.characters(), iter->value.length());
+            m_attributes->insertAttribute(Attribute::createMapped(name, value), false);
+        }
+        break;
+    }
+    case HTMLToken::Comment:
+        m_data = token.data();
+        break;
+    case HTMLToken::Character:
+        m_externalCharacters = token.data().characters();
+        m_externalCharactersLength = token.data().length();
+        break;
+    }
+}
+
+} // namespace WebCore
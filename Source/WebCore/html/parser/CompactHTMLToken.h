@@ -0,0 +1,158 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CompactHTMLToken_h
+#define CompactHTMLToken_h
+
+#include "HTMLToken.h"
+#include "HTMLTokenizer.h"
+#include "PlatformString.h"
+#include <wtf/text/TextPosition.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+// The parts of an HTMLTokenizer's state that the tree builder changes as it
+// processes tokens.
+struct HTMLTokenizerSnapshot {
+    HTMLTokenizerSnapshot()
+        : state(HTMLTokenizer::DataState)
+        , skipLeadingNewLineForListing(false)
+        , forceNullCharacterReplacement(false)
+        , shouldAllowCDATA(false)
+    {
+    }
+
+    explicit HTMLTokenizerSnapshot(const HTMLTokenizer& tokenizer)
+        : state(tokenizer.state())
+        , skipLeadingNewLineForListing(tokenizer.skipLeadingNewLineForListing())
+        , forceNullCharacterReplacement(tokenizer.forceNullCharacterReplacement())
+        , shouldAllowCDATA(tokenizer.shouldAllowCDATA())
+    {
+    }
+
+    void restore(HTMLTokenizer& tokenizer) const
+    {
+        tokenizer.setState(state);
+        tokenizer.setSkipLeadingNewLineForListing(skipLeadingNewLineForListing);
+        tokenizer.setForceNullCharacterReplacement(forceNullCharacterReplacement);
+        tokenizer.setShouldAllowCDATA(shouldAllowCDATA);
+    }
+
+    bool operator==(const HTMLTokenizerSnapshot& other) const
+    {
+        return state == other.state
+            && skipLeadingNewLineForListing == other.skipLeadingNewLineForListing
+            && forceNullCharacterReplacement == other.forceNullCharacterReplacement
+            && shouldAllowCDATA == other.shouldAllowCDATA;
+    }
+
+    bool operator!=(const HTMLTokenizerSnapshot& other) const { return !(*this == other); }
+
+    HTMLTokenizer::State state;
+    bool skipLeadingNewLineForListing;
+    bool forceNullCharacterReplacement;
+    bool shouldAllowCDATA;
+};
+
+// A token that can be handed from the thread that tokenized it to the main
+// thread. Unlike HTMLToken it holds its name, characters and attributes in
+// Strings of their exact size, and unlike AtomicHTMLToken it does not touch
+// the AtomicString table, which belongs to the main thread.
+//
+// Besides the token itself, it records where the background tokenizer was
+// when it emitted the token, so that the main thread can check the tokenizer
+// state against what its tree builder actually did, and take over tokenizing
+// from that point if the two disagree.
+class CompactHTMLToken {
+public:
+    struct Attribute {
+        Attribute(const String& name, const String& value)
+            : name(name)
+            , value(value)
+        {
+        }
+
+        String name;
+        String value;
+    };
+
+    CompactHTMLToken(const HTMLToken&, const TextPosition0&);
+
+    HTMLToken::Type type() const { return static_cast<HTMLToken::Type>(m_type); }
+
+    // The name of a DOCTYPE, StartTag or EndTag, the characters of a
+    // Character token and the data of a Comment.
+    const String& data() const { return m_data; }
+
+    bool selfClosing() const { return m_selfClosing; }
+    const Vector<Attribute>& attributes() const { return m_attributes; }
+
+    // FIXME: Distinguish between a missing identifier and an empty one, once
+    // HTMLToken exposes the difference.
+    const String& publicIdentifier() const { return m_publicIdentifier; }
+    const String& systemIdentifier() const { return m_systemIdentifier; }
+    bool forceQuirks() const { return m_forceQuirks; }
+
+    // The position in the source just past the token.
+    const TextPosition0& textPosition() const { return m_textPosition; }
+    int sourceOffset() const { return m_sourceOffset; }
+    void setSourceOffset(int offset) { m_sourceOffset = offset; }
+
+    // False if the tokenizer held on to input of its own when it emitted the
+    // token; see HTMLTokenizer::hasBufferedInput(). Only Character tokens
+    // are ever emitted that way.
+    bool isResumable() const { return m_isResumable; }
+    void setIsResumable(bool isResumable) { m_isResumable = isResumable; }
+
+    // The tokenizer state right after the token was emitted, and the state
+    // the tree builder is expected to leave behind once it has processed it.
+    const HTMLTokenizerSnapshot& tokenizerStateAfterEmission() const { return m_tokenizerStateAfterEmission; }
+    const HTMLTokenizerSnapshot& expectedTokenizerState() const { return m_expectedTokenizerState; }
+    void setTokenizerStates(const HTMLTokenizerSnapshot& afterEmission, const HTMLTokenizerSnapshot& expected)
+    {
+        m_tokenizerStateAfterEmission = afterEmission;
+        m_expectedTokenizerState = expected;
+    }
+
+private:
+    unsigned m_type : 4;
+    bool m_selfClosing : 1;
+    bool m_forceQuirks : 1;
+    bool m_isResumable : 1;
+    String m_data;
+    Vector<Attribute> m_attributes;
+    String m_publicIdentifier;
+    String m_systemIdentifier;
+
+    TextPosition0 m_textPosition;
+    int m_sourceOffset;
+    HTMLTokenizerSnapshot m_tokenizerStateAfterEmission;
+    HTMLTokenizerSnapshot m_expectedTokenizerState;
+};
+
+} // namespace WebCore
+
+#endif // CompactHTMLToken_h
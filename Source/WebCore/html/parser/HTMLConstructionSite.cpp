@@ -153,6 +153,7 @@ void HTMLConstructionSite::detach()
 {
     m_document = 0;
     m_attachmentRoot = 0;
+    m_sharedAttributes.clear();
 }
 
 void HTMLConstructionSite::setForm(HTMLFormElement* form)
@@ -377,11 +378,71 @@ PassRefPtr<Element> HTMLConstructionSite::createHTMLElement(AtomicHTMLToken& tok
     // have to pass the current form element.  We should rework form association
     // to occur after construction to allow better code sharing here.
     RefPtr<Element> element = HTMLElementFactory::createHTMLElement(tagName, currentNode()->document(), form(), true);
-    element->setAttributeMap(token.takeAtributes(), m_fragmentScriptingPermission);
+    setAttributesForHTMLElement(token, element.get());
     ASSERT(element->isHTMLElement());
     return element.release();
 }
 
+#if ENABLE(PERFORMANCE_STATISTICS)
+HTMLConstructionSite::AttributeSharingStatistics HTMLConstructionSite::s_attributeSharingStatistics;
+#endif
+
+static bool hasIdenticalAttributes(const NamedNodeMap* attributes, const NamedNodeMap* otherAttributes)
+{
+    unsigned length = attributes->length();
+    if (length != otherAttributes->length())
+        return false;
+
+    // The order matters here, since it shows through the attributes collection.
+    for (unsigned i = 0; i < length; ++i) {
+        Attribute* attribute = attributes->attributeItem(i);
+        Attribute* otherAttribute = otherAttributes->attributeItem(i);
+        if (attribute->name() != otherAttribute->name() || attribute->value() != otherAttribute->value())
+            return false;
+    }
+    return true;
+}
+
+void HTMLConstructionSite::setAttributesForHTMLElement(AtomicHTMLToken& token, Element* element)
+{
+    // Fragments pasted without scripting have attributes removed or cleared by
+    // setAttributeMap, so they don't take part in sharing.
+    if (!token.attributes() || token.attributes()->isEmpty() || m_fragmentScriptingPermission != FragmentScriptingAllowed) {
+        element->setAttributeMap(token.takeAtributes(), m_fragmentScriptingPermission);
+        return;
+    }
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    ++s_attributeSharingStatistics.elementsWithAttributes;
+#endif
+    SharedAttributesMap::iterator it = m_sharedAttributes.find(token.name());
+    if (it != m_sharedAttributes.end() && hasIdenticalAttributes(token.attributes(), it->second.get())) {
+        // Like cloning an element, this keeps the mapped style declarations the
+        // first element built instead of looking them up again.
+        element->attributes(false)->setAttributes(*it->second, NamedNodeMap::ShareAttributes);
+#if ENABLE(PERFORMANCE_STATISTICS)
+        ++s_attributeSharingStatistics.elementsSharingAttributes;
+        s_attributeSharingStatistics.attributesShared += it->second->length();
+#endif
+        return;
+    }
+
+    element->setAttributeMap(token.takeAtributes(), m_fragmentScriptingPermission);
+
+    // Remember the attributes as the element ended up with them, since parsing
+    // them can normalize values. Holding a reference makes the element copy an
+    // attribute before changing it.
+    NamedNodeMap* attributes = element->attributeMap();
+    RefPtr<NamedNodeMap> sharedAttributes = NamedNodeMap::create();
+    sharedAttributes->reserveInitialCapacity(attributes->length());
+    for (unsigned i = 0; i < attributes->length(); ++i) {
+        if (attributes->attributeItem(i)->attr())
+            return;
+        sharedAttributes->addAttribute(attributes->attributeItem(i));
+    }
+    m_sharedAttributes.set(token.name(), sharedAttributes.release());
+}
+
 PassRefPtr<Element> HTMLConstructionSite::createHTMLElementFromElementRecord(HTMLElementStack::ElementRecord* record)
 {
     return createHTMLElementFromSavedElement(record->element());
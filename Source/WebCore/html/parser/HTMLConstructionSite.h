@@ -31,15 +31,18 @@
 #include "HTMLElementStack.h"
 #include "HTMLFormattingElementList.h"
 #include "NotImplemented.h"
+#include <wtf/HashMap.h>
 #include <wtf/Noncopyable.h>
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefPtr.h>
+#include <wtf/text/AtomicStringHash.h>
 
 namespace WebCore {
 
 class AtomicHTMLToken;
 class Document;
 class Element;
+class NamedNodeMap;
 
 class HTMLConstructionSite {
     WTF_MAKE_NONCOPYABLE(HTMLConstructionSite);
@@ -93,6 +96,24 @@ public:
     HTMLFormElement* form() const { return m_form.get(); }
     PassRefPtr<HTMLFormElement> takeForm();
 
+#if ENABLE(PERFORMANCE_STATISTICS)
+    struct AttributeSharingStatistics {
+        AttributeSharingStatistics()
+            : elementsWithAttributes(0)
+            , elementsSharingAttributes(0)
+            , attributesShared(0)
+        {
+        }
+
+        unsigned elementsWithAttributes;
+        unsigned elementsSharingAttributes;
+        // Attribute objects that parsed elements did not have to allocate.
+        unsigned attributesShared;
+    };
+
+    static AttributeSharingStatistics attributeSharingStatistics() { return s_attributeSharingStatistics; }
+#endif
+
     class RedirectToFosterParentGuard {
         WTF_MAKE_NONCOPYABLE(RedirectToFosterParentGuard);
     public:
@@ -130,6 +151,7 @@ private:
     PassRefPtr<Element> createElement(AtomicHTMLToken&, const AtomicString& namespaceURI);
 
     void mergeAttributesFromTokenIntoElement(AtomicHTMLToken&, Element*);
+    void setAttributesForHTMLElement(AtomicHTMLToken&, Element*);
     void dispatchDocumentElementAvailableIfNeeded();
 
     Document* m_document;
@@ -147,6 +169,16 @@ private:
     FragmentScriptingPermission m_fragmentScriptingPermission;
     bool m_isParsingFragment;
 
+    // The attributes of the last element created for each tag name. A later
+    // element with an identical attribute list shares them instead of keeping
+    // its own copies, which adds up in large tables and lists.
+    typedef HashMap<AtomicString, RefPtr<NamedNodeMap> > SharedAttributesMap;
+    SharedAttributesMap m_sharedAttributes;
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    static AttributeSharingStatistics s_attributeSharingStatistics;
+#endif
+
     // http://www.whatwg.org/specs/web-apps/current-work/multipage/tokenization.html#parsing-main-intable
     // In the "in table" insertion mode, we sometimes get into a state where
     // "whenever a node would be inserted into the current node, it must instead
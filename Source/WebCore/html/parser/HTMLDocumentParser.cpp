@@ -26,6 +26,8 @@
 #include "config.h"
 #include "HTMLDocumentParser.h"
 
+#include "BackgroundHTMLParser.h"
+#include "CompactHTMLToken.h"
 #include "ContentSecurityPolicy.h"
 #include "DocumentFragment.h"
 #include "Element.h"
@@ -35,11 +37,13 @@
 #include "HTMLTokenizer.h"
 #include "HTMLPreloadScanner.h"
 #include "HTMLScriptRunner.h"
+#include "HTMLSimpleFragmentParser.h"
 #include "HTMLTreeBuilder.h"
 #include "HTMLDocument.h"
 #include "InspectorInstrumentation.h"
 #include "NestingLevelIncrementer.h"
 #include "Settings.h"
+#include <wtf/CurrentTime.h>
 
 namespace WebCore {
 
@@ -81,6 +85,8 @@ HTMLDocumentParser::HTMLDocumentParser(HTMLDocument* document, bool reportErrors
     , m_treeBuilder(HTMLTreeBuilder::create(this, document, reportErrors, usePreHTML5ParserQuirks(document)))
     , m_parserScheduler(HTMLParserScheduler::create(this))
     , m_xssFilter(this)
+    , m_mayUseBackgroundParser(BackgroundHTMLParser::isEnabled())
+    , m_charactersToSkip(0)
     , m_endWasDelayed(false)
     , m_pumpSessionNestingLevel(0)
 {
@@ -93,6 +99,8 @@ HTMLDocumentParser::HTMLDocumentParser(DocumentFragment* fragment, Element* cont
     , m_tokenizer(HTMLTokenizer::create(usePreHTML5ParserQuirks(fragment->document())))
     , m_treeBuilder(HTMLTreeBuilder::create(this, fragment, contextElement, scriptingPermission, usePreHTML5ParserQuirks(fragment->document())))
     , m_xssFilter(this)
+    , m_mayUseBackgroundParser(false)
+    , m_charactersToSkip(0)
     , m_endWasDelayed(false)
     , m_pumpSessionNestingLevel(0)
 {
@@ -113,6 +121,7 @@ void HTMLDocumentParser::detach()
     if (m_scriptRunner)
         m_scriptRunner->detach();
     m_treeBuilder->detach();
+    m_backgroundParser.clear();
     // FIXME: It seems wrong that we would have a preload scanner here.
     // Yet during fast/dom/HTMLScriptElement/script-load-events.html we do.
     m_preloadScanner.clear();
@@ -122,6 +131,7 @@ void HTMLDocumentParser::detach()
 void HTMLDocumentParser::stopParsing()
 {
     DocumentParser::stopParsing();
+    m_backgroundParser.clear();
     m_parserScheduler.clear(); // Deleting the scheduler will clear any timers.
 }
 
@@ -259,12 +269,40 @@ void HTMLDocumentParser::pumpTokenizer(SynchronousMode mode)
     InspectorInstrumentationCookie cookie = InspectorInstrumentation::willWriteHTML(document(), m_input.current().length(), m_tokenizer->lineNumber());
 
     while (canTakeNextToken(mode, session) && !session.needsYield) {
+        if (m_backgroundParser) {
+            if (!processBackgroundTokens())
+                break;
+            continue;
+        }
+
+        if (m_preloadScanner && m_preloadScanner->hasRecordedToken()) {
+            processRecordedTokens();
+            continue;
+        }
+        if (m_preloadScanner && m_preloadScanner->isRecordingTokens()) {
+            // We have caught up with the preload scanner and tokenize the
+            // rest ourselves; a new scanner starts where we block next.
+            m_preloadScanner.clear();
+        }
+
         if (!isParsingFragment())
             m_sourceTracker.start(m_input, m_token);
 
         if (!m_tokenizer->nextToken(m_input.current(), m_token))
             break;
 
+        if (m_charactersToSkip && m_token.type() == HTMLToken::Character) {
+            size_t length = m_token.characters().size();
+            if (m_charactersToSkip < length) {
+                m_token.removeLeadingCharacters(m_charactersToSkip);
+                m_charactersToSkip = 0;
+            } else {
+                m_charactersToSkip -= length;
+                m_token.clear();
+                continue;
+            }
+        }
+
         if (!isParsingFragment()) {
             m_sourceTracker.end(m_input, m_token);
 
@@ -289,16 +327,158 @@ void HTMLDocumentParser::pumpTokenizer(SynchronousMode mode)
 
     if (isWaitingForScripts()) {
         ASSERT(m_tokenizer->state() == HTMLTokenizer::DataState);
-        if (!m_preloadScanner) {
-            m_preloadScanner.set(new HTMLPreloadScanner(document()));
-            m_preloadScanner->appendToEnd(m_input.current());
+        if (m_backgroundParser) {
+            if (!m_preloadScanner)
+                m_preloadScanner.set(new HTMLPreloadScanner(document()));
+            m_backgroundParser->scanForPreloads(*m_preloadScanner);
+        } else {
+            if (!m_preloadScanner) {
+                m_preloadScanner.set(new HTMLPreloadScanner(document()));
+                if (canRecordPreloadScannerTokens()) {
+                    m_preloadScanner->startRecordingTokens(*m_tokenizer, m_input.current().numberOfCharactersConsumed(),
+                        HTMLTreeBuilder::scriptEnabled(document()->frame()), HTMLTreeBuilder::pluginsEnabled(document()->frame()));
+                }
+                m_preloadScanner->appendToEnd(m_input.current());
+            }
+            m_preloadScanner->scan();
         }
-        m_preloadScanner->scan();
     }
 
     InspectorInstrumentation::didWriteHTML(cookie, m_tokenizer->lineNumber());
 }
 
+bool HTMLDocumentParser::canUseBackgroundParser()
+{
+    // The parser thread cannot see what scripts write, and the XSS filter
+    // needs the source of every token, so both keep the tokenizing here.
+    return !wasCreatedByScript()
+        && !inPumpSession()
+        && !m_input.hasInsertionPoint()
+        && m_input.current().isEmpty()
+        && !m_input.haveSeenEndOfFile()
+        && !m_xssFilter.isActive();
+}
+
+void HTMLDocumentParser::didReceiveBackgroundTokens()
+{
+    ASSERT(m_backgroundParser);
+
+    // pumpTokenizer can cause this parser to be detached from the Document,
+    // but we need to ensure it isn't deleted yet.
+    RefPtr<HTMLDocumentParser> protect(this);
+
+    if (m_preloadScanner) {
+        if (!isWaitingForScripts() && m_backgroundParser->hasOvertakenPreloadScanner())
+            m_preloadScanner.clear();
+        else if (isWaitingForScripts())
+            m_backgroundParser->scanForPreloads(*m_preloadScanner);
+    }
+
+    // A pump session further up the stack takes the new tokens.
+    if (inPumpSession())
+        return;
+
+    pumpTokenizerIfPossible(AllowYield);
+    endIfDelayed();
+}
+
+bool HTMLDocumentParser::processBackgroundTokens()
+{
+    if (!m_backgroundParser->hasNextToken())
+        return false;
+
+    // The tokenizer could not have stopped in between, so neither can we.
+    bool isResumable;
+    do {
+        isResumable = processBackgroundToken();
+    } while (!isResumable && m_backgroundParser && !isStopped());
+    return true;
+}
+
+bool HTMLDocumentParser::processBackgroundToken()
+{
+    CompactHTMLToken token = m_backgroundParser->takeNextToken(*m_tokenizer);
+#if ENABLE(PERFORMANCE_STATISTICS)
+    double startTime = currentTime();
+#endif
+
+    TextPosition0 position = token.textPosition();
+    m_tokenizer->setLineNumber(position.m_line.zeroBasedInt());
+    m_input.current().setCurrentPosition(position.m_line, position.m_column, 0);
+
+    bool predictedTokenizerState = constructTreeFromCompactToken(token);
+
+    // Processing the token may have run a script that stopped the parser
+    // or wrote into the document.
+    if (m_backgroundParser) {
+        m_backgroundParser->didProcessToken(token);
+#if ENABLE(PERFORMANCE_STATISTICS)
+        m_backgroundParser->didTakeTimeToProcessToken(token, currentTime() - startTime);
+#endif
+        if (!predictedTokenizerState)
+            resumeTokenizingOnMainThread();
+    }
+    return token.isResumable();
+}
+
+bool HTMLDocumentParser::constructTreeFromCompactToken(const CompactHTMLToken& token)
+{
+    // The tree builder reads, and may change, the tokenizer's state.
+    token.tokenizerStateAfterEmission().restore(*m_tokenizer);
+    if (token.type() == HTMLToken::StartTag)
+        m_tokenizer->setAppropriateEndTagName(token.data());
+
+    AtomicHTMLToken atomicToken(token);
+    m_treeBuilder->constructTreeFromAtomicToken(atomicToken);
+    return HTMLTokenizerSnapshot(*m_tokenizer) == token.expectedTokenizerState();
+}
+
+bool HTMLDocumentParser::canRecordPreloadScannerTokens()
+{
+    return !isParsingFragment()
+        && !m_input.hasInsertionPoint()
+        && !m_input.haveSeenEndOfFile()
+        && !m_charactersToSkip
+        && !m_xssFilter.isActive();
+}
+
+void HTMLDocumentParser::processRecordedTokens()
+{
+    bool isResumable;
+    bool predictedTokenizerState = true;
+    do {
+        CompactHTMLToken token = m_preloadScanner->takeRecordedToken();
+        isResumable = token.isResumable();
+        if (isResumable) {
+            // Move the input to where the tokenizer would be after the token.
+            SegmentedString& input = m_input.current();
+            int lineNumber = m_tokenizer->lineNumber();
+            input.advance(token.sourceOffset() - input.numberOfCharactersConsumed(), lineNumber);
+            m_tokenizer->setLineNumber(lineNumber);
+        }
+        if (!constructTreeFromCompactToken(token))
+            predictedTokenizerState = false;
+    } while (!isResumable && m_preloadScanner && !isStopped());
+
+    // The tokenizer is right for the source after the last token, but the
+    // scanner tokenized that source in a different state.
+    if (!predictedTokenizerState && m_preloadScanner)
+        m_preloadScanner->discardRecordedTokens();
+}
+
+void HTMLDocumentParser::resumeTokenizingOnMainThread()
+{
+    OwnPtr<BackgroundHTMLParser> backgroundParser = m_backgroundParser.release();
+    m_charactersToSkip = backgroundParser->handOver(*m_tokenizer, m_input);
+    // The scanner only ever saw tokens, so it cannot carry on from the source.
+    m_preloadScanner.clear();
+}
+
+bool HTMLDocumentParser::isWaitingForBackgroundParser() const
+{
+    return m_backgroundParser && m_backgroundParser->finishWasCalled() && !m_backgroundParser->processedEndOfFile();
+}
+
 bool HTMLDocumentParser::hasInsertionPoint()
 {
     // FIXME: The wasCreatedByScript() branch here might not be fully correct.
@@ -318,6 +498,13 @@ void HTMLDocumentParser::insert(const SegmentedString& source)
     // but we need to ensure it isn't deleted yet.
     RefPtr<HTMLDocumentParser> protect(this);
 
+    // The background parser cannot know what the script wrote, and the
+    // preload scanner's tokens come after it.
+    if (m_backgroundParser)
+        resumeTokenizingOnMainThread();
+    if (m_preloadScanner)
+        m_preloadScanner->discardRecordedTokens();
+
     SegmentedString excludedLineNumberSource(source);
     excludedLineNumberSource.setExcludeLineNumbers();
     m_input.insertAtCurrentInsertionPoint(excludedLineNumberSource);
@@ -343,6 +530,23 @@ void HTMLDocumentParser::append(const SegmentedString& source)
     // but we need to ensure it isn't deleted yet.
     RefPtr<HTMLDocumentParser> protect(this);
 
+    if (m_mayUseBackgroundParser) {
+        m_mayUseBackgroundParser = false;
+        if (canUseBackgroundParser()) {
+            BackgroundHTMLParser::Options options;
+            options.usePreHTML5ParserQuirks = usePreHTML5ParserQuirks(document());
+            options.scriptEnabled = HTMLTreeBuilder::scriptEnabled(document()->frame());
+            options.pluginsEnabled = HTMLTreeBuilder::pluginsEnabled(document()->frame());
+            m_backgroundParser = BackgroundHTMLParser::create(this, options);
+        }
+    }
+
+    if (m_backgroundParser) {
+        // The tokens come back through didReceiveBackgroundTokens().
+        m_backgroundParser->append(source.toString());
+        return;
+    }
+
     if (m_preloadScanner) {
         if (m_input.current().isEmpty() && !isWaitingForScripts()) {
             // We have parsed until the end of the current input and so are now moving ahead of the preload scanner.
@@ -422,13 +626,17 @@ void HTMLDocumentParser::finish()
     // We're not going to get any more data off the network, so we tell the
     // input stream we've reached the end of file.  finish() can be called more
     // than once, if the first time does not call end().
-    if (!m_input.haveSeenEndOfFile())
+    if (m_backgroundParser)
+        m_backgroundParser->finish();
+    else if (!m_input.haveSeenEndOfFile())
         m_input.markEndOfFile();
     attemptToEnd();
 }
 
 bool HTMLDocumentParser::finishWasCalled()
 {
+    if (m_backgroundParser)
+        return m_backgroundParser->finishWasCalled();
     return m_input.haveSeenEndOfFile();
 }
 
@@ -497,6 +705,10 @@ void HTMLDocumentParser::stopWatchingForLoad(CachedResource* cachedScript)
 void HTMLDocumentParser::appendCurrentInputStreamToPreloadScannerAndScan()
 {
     ASSERT(m_preloadScanner);
+    if (m_backgroundParser) {
+        m_backgroundParser->scanForPreloads(*m_preloadScanner);
+        return;
+    }
     m_preloadScanner->appendToEnd(m_input.current());
     m_preloadScanner->scan();
 }
@@ -557,6 +769,9 @@ ScriptController* HTMLDocumentParser::script() const
 
 void HTMLDocumentParser::parseDocumentFragment(const String& source, DocumentFragment* fragment, Element* contextElement, FragmentScriptingPermission scriptingPermission)
 {
+    if (HTMLSimpleFragmentParser::parse(source, fragment, contextElement, scriptingPermission))
+        return;
+
     RefPtr<HTMLDocumentParser> parser = HTMLDocumentParser::create(fragment, contextElement, scriptingPermission);
     parser->insert(source); // Use insert() so that the parser will not yield.
     parser->finish();
@@ -40,6 +40,8 @@
 
 namespace WebCore {
 
+class BackgroundHTMLParser;
+class CompactHTMLToken;
 class Document;
 class DocumentFragment;
 class HTMLDocument;
@@ -70,6 +72,9 @@ public:
     // Exposed for HTMLParserScheduler
     void resumeParsingAfterYield();
 
+    // Exposed for BackgroundHTMLParser
+    void didReceiveBackgroundTokens();
+
     static void parseDocumentFragment(const String&, DocumentFragment*, Element* contextElement, FragmentScriptingPermission = FragmentScriptingAllowed);
     
     static bool usePreHTML5ParserQuirks(Document*);
@@ -123,6 +128,18 @@ private:
     void pumpTokenizer(SynchronousMode);
     void pumpTokenizerIfPossible(SynchronousMode);
 
+    bool canUseBackgroundParser();
+    bool processBackgroundTokens();
+    bool processBackgroundToken();
+    void resumeTokenizingOnMainThread();
+    bool isWaitingForBackgroundParser() const;
+
+    // Returns whether the tokenizer ended up in the state that the token's
+    // tokenizer predicted.
+    bool constructTreeFromCompactToken(const CompactHTMLToken&);
+    bool canRecordPreloadScannerTokens();
+    void processRecordedTokens();
+
     bool runScriptsForPausedTreeBuilder();
     void resumeParsingAfterScriptExecution();
 
@@ -136,7 +153,7 @@ private:
     bool isScheduledForResume() const;
     bool inScriptExecution() const;
     bool inPumpSession() const { return m_pumpSessionNestingLevel > 0; }
-    bool shouldDelayEnd() const { return inPumpSession() || isWaitingForScripts() || inScriptExecution() || isScheduledForResume(); }
+    bool shouldDelayEnd() const { return inPumpSession() || isWaitingForScripts() || inScriptExecution() || isScheduledForResume() || isWaitingForBackgroundParser(); }
 
     ScriptController* script() const;
 
@@ -153,6 +170,14 @@ private:
     HTMLSourceTracker m_sourceTracker;
     XSSFilter m_xssFilter;
 
+    // While there is a background parser, m_tokenizer only holds the state
+    // the tree builder sets; the tokens come from the parser thread.
+    OwnPtr<BackgroundHTMLParser> m_backgroundParser;
+    bool m_mayUseBackgroundParser;
+    // Characters the tokenizer emits again after taking over from the
+    // background parser, which the tree builder has already processed.
+    unsigned m_charactersToSkip;
+
     bool m_endWasDelayed;
     unsigned m_pumpSessionNestingLevel;
 };
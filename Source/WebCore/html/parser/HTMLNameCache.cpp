@@ -0,0 +1,126 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HTMLNameCache.h"
+
+#include "HTMLNames.h"
+#include <wtf/MainThread.h>
+
+namespace WebCore {
+
+// Both must be powers of two. Longer strings are rarely repeated and are
+// looked up in the global table directly.
+static const unsigned nameCacheCapacity = 512;
+static const unsigned valueCacheCapacity = 256;
+static const unsigned maxCachedLength = 24;
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+static HTMLNameCache::Statistics s_statistics;
+#endif
+
+static inline unsigned slotFor(const UChar* characters, unsigned length, unsigned capacity)
+{
+    ASSERT(length);
+    return (characters[0] * 33 + characters[length / 2] * 7 + characters[length - 1] + length * 131) & (capacity - 1);
+}
+
+static inline bool matches(const AtomicString& string, const UChar* characters, unsigned length)
+{
+    return string.length() == length && !memcmp(string.characters(), characters, length * sizeof(UChar));
+}
+
+static AtomicString* nameCache()
+{
+    static AtomicString* cache = 0;
+    if (cache)
+        return cache;
+
+    cache = new AtomicString[nameCacheCapacity];
+    // Seed the cache with the names the parser sees most, so that they are
+    // answered from the start.
+    HTMLNames::init();
+    size_t tagCount;
+    QualifiedName** tags = HTMLNames::getHTMLTags(&tagCount);
+    size_t attributeCount;
+    QualifiedName** attributes = HTMLNames::getHTMLAttrs(&attributeCount);
+    for (size_t i = 0; i < attributeCount; ++i) {
+        const AtomicString& name = attributes[i]->localName();
+        cache[slotFor(name.characters(), name.length(), nameCacheCapacity)] = name;
+    }
+    // Tags go in last to win the slots they share with attributes.
+    for (size_t i = 0; i < tagCount; ++i) {
+        const AtomicString& name = tags[i]->localName();
+        cache[slotFor(name.characters(), name.length(), nameCacheCapacity)] = name;
+    }
+    return cache;
+}
+
+static AtomicString* valueCache()
+{
+    static AtomicString* cache = new AtomicString[valueCacheCapacity];
+    return cache;
+}
+
+static inline AtomicString lookUp(AtomicString* cache, unsigned capacity, const UChar* characters, unsigned length)
+{
+    ASSERT(isMainThread());
+#if ENABLE(PERFORMANCE_STATISTICS)
+    ++s_statistics.lookups;
+#endif
+    if (!length)
+        return emptyAtom;
+    if (length > maxCachedLength)
+        return AtomicString(characters, length);
+
+    AtomicString& entry = cache[slotFor(characters, length, capacity)];
+    if (matches(entry, characters, length)) {
+#if ENABLE(PERFORMANCE_STATISTICS)
+        ++s_statistics.hits;
+#endif
+        return entry;
+    }
+    entry = AtomicString(characters, length);
+    return entry;
+}
+
+AtomicString HTMLNameCache::makeName(const UChar* characters, unsigned length)
+{
+    return lookUp(nameCache(), nameCacheCapacity, characters, length);
+}
+
+AtomicString HTMLNameCache::makeAttributeValue(const UChar* characters, unsigned length)
+{
+    return lookUp(valueCache(), valueCacheCapacity, characters, length);
+}
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+HTMLNameCache::Statistics HTMLNameCache::statistics()
+{
+    return s_statistics;
+}
+#endif
+
+} // namespace WebCore
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HTMLNameCache_h
+#define HTMLNameCache_h
+
+#include <wtf/text/AtomicString.h>
+
+namespace WebCore {
+
+// Turns the characters of tag names, attribute names and short attribute
+// values coming out of the tokenizer into AtomicStrings. A small direct-mapped
+// table, seeded with the HTMLNames tags and attributes, answers most of them
+// by comparing characters instead of hashing into the global AtomicString
+// table. Only used on the main thread.
+class HTMLNameCache {
+public:
+    static AtomicString makeName(const UChar*, unsigned length);
+    static AtomicString makeAttributeValue(const UChar*, unsigned length);
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    struct Statistics {
+        unsigned lookups;
+        unsigned hits;
+        Statistics() : lookups(0), hits(0) { }
+    };
+    static Statistics statistics();
+#endif
+};
+
+} // namespace WebCore
+
+#endif // HTMLNameCache_h
@@ -29,6 +29,7 @@
 #include "HTMLPreloadScanner.h"
 
 #include "CachedResourceLoader.h"
+#include "CompactHTMLToken.h"
 #include "Document.h"
 #include "InputType.h"
 #include "HTMLDocumentParser.h"
@@ -36,6 +37,7 @@
 #include "HTMLLinkElement.h"
 #include "HTMLNames.h"
 #include "HTMLParserIdioms.h"
+#include "HTMLTreeBuilderSimulator.h"
 #include "MediaList.h"
 #include "MediaQueryEvaluator.h"
 
@@ -56,38 +58,60 @@ public:
         processAttributes(token.attributes());
     }
 
+    PreloadTask(const CompactHTMLToken& token)
+        : m_tagName(token.data())
+        , m_linkIsStyleSheet(false)
+        , m_linkMediaAttributeIsScreen(true)
+        , m_inputIsImage(false)
+    {
+        if (!hasPreloadableAttributes())
+            return;
+        const Vector<CompactHTMLToken::Attribute>& attributes = token.attributes();
+        for (Vector<CompactHTMLToken::Attribute>::const_iterator iter = attributes.begin(); iter != attributes.end(); ++iter)
+            processAttribute(iter->name, iter->value);
+    }
+
+    bool hasPreloadableAttributes() const
+    {
+        return m_tagName == imgTag
+            || m_tagName == inputTag
+            || m_tagName == linkTag
+            || m_tagName == scriptTag;
+    }
+
     void processAttributes(const HTMLToken::AttributeList& attributes)
     {
-        if (m_tagName != imgTag
-            && m_tagName != inputTag
-            && m_tagName != linkTag
-            && m_tagName != scriptTag)
+        if (!hasPreloadableAttributes())
             return;
 
         for (HTMLToken::AttributeList::const_iterator iter = attributes.begin();
              iter != attributes.end(); ++iter) {
             AtomicString attributeName(iter->m_name.data(), iter->m_name.size());
             String attributeValue(iter->m_value.data(), iter->m_value.size());
+            processAttribute(attributeName, attributeValue);
+        }
+    }
 
-            if (attributeName == charsetAttr)
-                m_charset = attributeValue;
-
-            if (m_tagName == scriptTag || m_tagName == imgTag) {
-                if (attributeName == srcAttr)
-                    setUrlToLoad(attributeValue);
-            } else if (m_tagName == linkTag) {
-                if (attributeName == hrefAttr)
-                    setUrlToLoad(attributeValue);
-                else if (attributeName == relAttr)
-                    m_linkIsStyleSheet = relAttributeIsStyleSheet(attributeValue);
-                else if (attributeName == mediaAttr)
-                    m_linkMediaAttributeIsScreen = linkMediaAttributeIsScreen(attributeValue);
-            } else if (m_tagName == inputTag) {
-                if (attributeName == srcAttr)
-                    setUrlToLoad(attributeValue);
-                else if (attributeName == typeAttr)
-                    m_inputIsImage = equalIgnoringCase(attributeValue, InputTypeNames::image());
-            }
+    void processAttribute(const AtomicString& attributeName, const String& attributeValue)
+    {
+        if (attributeName == charsetAttr)
+            m_charset = attributeValue;
+
+        if (m_tagName == scriptTag || m_tagName == imgTag) {
+            if (attributeName == srcAttr)
+                setUrlToLoad(attributeValue);
+        } else if (m_tagName == linkTag) {
+            if (attributeName == hrefAttr)
+                setUrlToLoad(attributeValue);
+            else if (attributeName == relAttr)
+                m_linkIsStyleSheet = relAttributeIsStyleSheet(attributeValue);
+            else if (attributeName == mediaAttr)
+                m_linkMediaAttributeIsScreen = linkMediaAttributeIsScreen(attributeValue);
+        } else if (m_tagName == inputTag) {
+            if (attributeName == srcAttr)
+                setUrlToLoad(attributeValue);
+            else if (attributeName == typeAttr)
+                m_inputIsImage = equalIgnoringCase(attributeValue, InputTypeNames::image());
         }
     }
 
@@ -147,12 +171,26 @@ private:
 
 } // namespace
 
+#if ENABLE(PERFORMANCE_STATISTICS)
+HTMLPreloadScanner::Statistics HTMLPreloadScanner::s_statistics;
+#endif
+
 HTMLPreloadScanner::HTMLPreloadScanner(Document* document)
     : m_document(document)
     , m_cssScanner(document)
     , m_tokenizer(HTMLTokenizer::create(HTMLDocumentParser::usePreHTML5ParserQuirks(document)))
     , m_bodySeen(false)
     , m_inStyle(false)
+    , m_recordingInputOffset(0)
+    , m_recordingSourceOffset(0)
+#if ENABLE(PERFORMANCE_STATISTICS)
+    , m_takenSourceOffset(0)
+#endif
+    , m_resumableRecordedTokenCount(0)
+{
+}
+
+HTMLPreloadScanner::~HTMLPreloadScanner()
 {
 }
 
@@ -163,12 +201,81 @@ void HTMLPreloadScanner::appendToEnd(const SegmentedString& source)
 
 void HTMLPreloadScanner::scan()
 {
-    // FIXME: We should save and re-use these tokens in HTMLDocumentParser if
-    // the pending script doesn't end up calling document.write.
+#if ENABLE(PERFORMANCE_STATISTICS)
+    int startOffset = m_source.numberOfCharactersConsumed();
+#endif
     while (m_tokenizer->nextToken(m_source, m_token)) {
-        processToken();
+        if (isRecordingTokens())
+            recordToken();
+        else
+            processToken();
         m_token.clear();
     }
+#if ENABLE(PERFORMANCE_STATISTICS)
+    s_statistics.charactersTokenized += m_source.numberOfCharactersConsumed() - startOffset;
+#endif
+}
+
+bool HTMLPreloadScanner::startRecordingTokens(const HTMLTokenizer& parserTokenizer, int inputOffset, bool scriptEnabled, bool pluginsEnabled)
+{
+    ASSERT(!isRecordingTokens());
+    ASSERT(m_recordedTokens.isEmpty());
+    ASSERT(m_token.type() == HTMLToken::Uninitialized);
+
+    if (parserTokenizer.hasBufferedInput() || HTMLTokenizerSnapshot(parserTokenizer) != HTMLTokenizerSnapshot(*m_tokenizer))
+        return false;
+
+    m_treeBuilderSimulator = adoptPtr(new HTMLTreeBuilderSimulator(scriptEnabled, pluginsEnabled));
+    m_recordingInputOffset = inputOffset;
+    m_recordingSourceOffset = m_source.numberOfCharactersConsumed();
+#if ENABLE(PERFORMANCE_STATISTICS)
+    m_takenSourceOffset = inputOffset;
+#endif
+    return true;
+}
+
+void HTMLPreloadScanner::stopRecordingTokens()
+{
+    m_treeBuilderSimulator.clear();
+}
+
+void HTMLPreloadScanner::discardRecordedTokens()
+{
+    stopRecordingTokens();
+    m_recordedTokens.clear();
+    m_resumableRecordedTokenCount = 0;
+}
+
+void HTMLPreloadScanner::recordToken()
+{
+    CompactHTMLToken token(m_token, TextPosition0::minimumPosition());
+    token.setSourceOffset(m_recordingInputOffset + m_source.numberOfCharactersConsumed() - m_recordingSourceOffset);
+    token.setIsResumable(!m_tokenizer->hasBufferedInput());
+
+    // The simulator takes the place of updateStateFor().
+    HTMLTokenizerSnapshot stateAfterEmission(*m_tokenizer);
+    m_treeBuilderSimulator->simulate(token, *m_tokenizer);
+    token.setTokenizerStates(stateAfterEmission, HTMLTokenizerSnapshot(*m_tokenizer));
+
+    scan(token);
+
+    m_recordedTokens.append(token);
+    if (token.isResumable())
+        m_resumableRecordedTokenCount = m_recordedTokens.size();
+}
+
+CompactHTMLToken HTMLPreloadScanner::takeRecordedToken()
+{
+    ASSERT(hasRecordedToken());
+    CompactHTMLToken token = m_recordedTokens.takeFirst();
+    --m_resumableRecordedTokenCount;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    if (token.isResumable()) {
+        s_statistics.charactersReused += token.sourceOffset() - m_takenSourceOffset;
+        m_takenSourceOffset = token.sourceOffset();
+    }
+#endif
+    return token;
 }
 
 void HTMLPreloadScanner::processToken()
@@ -197,6 +304,31 @@ void HTMLPreloadScanner::processToken()
     task.preload(m_document, scanningBody());
 }
 
+void HTMLPreloadScanner::scan(const CompactHTMLToken& token)
+{
+    if (m_inStyle) {
+        if (token.type() == HTMLToken::Character)
+            m_cssScanner.scan(token.data(), scanningBody());
+        else if (token.type() == HTMLToken::EndTag) {
+            m_inStyle = false;
+            m_cssScanner.reset();
+        }
+    }
+
+    if (token.type() != HTMLToken::StartTag)
+        return;
+
+    PreloadTask task(token);
+
+    if (task.tagName() == bodyTag)
+        m_bodySeen = true;
+
+    if (task.tagName() == styleTag)
+        m_inStyle = true;
+
+    task.preload(m_document, scanningBody());
+}
+
 bool HTMLPreloadScanner::scanningBody() const
 {
     return m_document->body() || m_bodySeen;
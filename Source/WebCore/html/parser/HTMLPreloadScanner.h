@@ -28,28 +28,74 @@
 #define HTMLPreloadScanner_h
 
 #include "CSSPreloadScanner.h"
+#include "CompactHTMLToken.h"
 #include "HTMLToken.h"
 #include "SegmentedString.h"
+#include <wtf/Deque.h>
 
 namespace WebCore {
 
 class Document;
 class HTMLToken;
 class HTMLTokenizer;
+class HTMLTreeBuilderSimulator;
 class SegmentedString;
 
 class HTMLPreloadScanner {
     WTF_MAKE_NONCOPYABLE(HTMLPreloadScanner); WTF_MAKE_FAST_ALLOCATED;
 public:
     HTMLPreloadScanner(Document*);
+    ~HTMLPreloadScanner();
 
     void appendToEnd(const SegmentedString&);
     void scan();
 
+    // Keeps the tokens from the next scan() on, so that HTMLDocumentParser
+    // can build the tree from them once the script it waits for has run,
+    // instead of tokenizing the same source a second time. Fails if the
+    // parser's tokenizer is not in the state the scanner's one starts in.
+    // The source offsets of the tokens are offsets in the parser's input,
+    // which is at inputOffset now; their text positions are not set.
+    bool startRecordingTokens(const HTMLTokenizer& parserTokenizer, int inputOffset, bool scriptEnabled, bool pluginsEnabled);
+    bool isRecordingTokens() const { return m_treeBuilderSimulator; }
+    // Keeps the tokens recorded so far.
+    void stopRecordingTokens();
+    void discardRecordedTokens();
+
+    // Same contract as BackgroundHTMLParser::hasNextToken().
+    bool hasRecordedToken() const { return m_resumableRecordedTokenCount; }
+    CompactHTMLToken takeRecordedToken();
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    struct Statistics {
+        Statistics()
+            : charactersTokenized(0)
+            , charactersReused(0)
+        {
+        }
+
+        unsigned charactersTokenized;
+        // Source characters that HTMLDocumentParser did not have to tokenize
+        // again because it built the tree from recorded tokens.
+        unsigned charactersReused;
+    };
+
+    static Statistics statistics() { return s_statistics; }
+#endif
+
+    // For tokens from a BackgroundHTMLParser, which has already put its
+    // tokenizer in the right state for each of them.
+    void scan(const CompactHTMLToken&);
+
 private:
     void processToken();
+    void recordToken();
     bool scanningBody() const;
 
+#if ENABLE(PERFORMANCE_STATISTICS)
+    static Statistics s_statistics;
+#endif
+
     Document* m_document;
     SegmentedString m_source;
     CSSPreloadScanner m_cssScanner;
@@ -57,6 +103,17 @@ private:
     HTMLToken m_token;
     bool m_bodySeen;
     bool m_inStyle;
+
+    OwnPtr<HTMLTreeBuilderSimulator> m_treeBuilderSimulator;
+    int m_recordingInputOffset;
+    int m_recordingSourceOffset;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    int m_takenSourceOffset;
+#endif
+    Deque<CompactHTMLToken> m_recordedTokens;
+    // The number of recorded tokens up to and including the last one the
+    // tokenizer could have stopped after.
+    size_t m_resumableRecordedTokenCount;
 };
 
 }
@@ -0,0 +1,490 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HTMLSimpleFragmentParser.h"
+
+#include "Attribute.h"
+#include "DocumentFragment.h"
+#include "Element.h"
+#include "HTMLElementFactory.h"
+#include "HTMLFormElement.h"
+#include "HTMLNameCache.h"
+#include "HTMLNames.h"
+#include "HTMLParserIdioms.h"
+#include "HTMLTreeBuilder.h"
+#include "NamedNodeMap.h"
+#include "Text.h"
+#include <wtf/ASCIICType.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+using namespace HTMLNames;
+
+namespace {
+
+// What, besides inserting the element, the tree builder does for a start tag
+// in the "in body" insertion mode.
+enum TagKind {
+    PhrasingTag, // Nothing.
+    AnchorTag, // Closes an open <a>.
+    BlockTag, // Closes an open <p>.
+    HeadingTag, // Closes an open <p>, and a heading that is the current node.
+    ListItemTag, // Closes an open <p> and <li>.
+    VoidTag, // Pops the element again straight away.
+    VoidBlockTag // Closes an open <p>, and pops the element again.
+};
+
+struct TagInfo {
+    const QualifiedName* name;
+    TagKind kind;
+};
+
+// Formatting elements other than <a> are only safe because misnested end tags
+// are refused; nothing is ever left for the tree builder to reconstruct.
+const TagInfo tags[] = {
+    { &aTag, AnchorTag },
+    { &abbrTag, PhrasingTag },
+    { &addressTag, BlockTag },
+    { &articleTag, BlockTag },
+    { &asideTag, BlockTag },
+    { &bTag, PhrasingTag },
+    { &blockquoteTag, BlockTag },
+    { &brTag, VoidTag },
+    { &centerTag, BlockTag },
+    { &citeTag, PhrasingTag },
+    { &codeTag, PhrasingTag },
+    { &dfnTag, PhrasingTag },
+    { &divTag, BlockTag },
+    { &emTag, PhrasingTag },
+    { &figcaptionTag, BlockTag },
+    { &figureTag, BlockTag },
+    { &footerTag, BlockTag },
+    { &h1Tag, HeadingTag },
+    { &h2Tag, HeadingTag },
+    { &h3Tag, HeadingTag },
+    { &h4Tag, HeadingTag },
+    { &h5Tag, HeadingTag },
+    { &h6Tag, HeadingTag },
+    { &headerTag, BlockTag },
+    { &hgroupTag, BlockTag },
+    { &hrTag, VoidBlockTag },
+    { &iTag, PhrasingTag },
+    { &imgTag, VoidTag },
+    { &kbdTag, PhrasingTag },
+    { &labelTag, PhrasingTag },
+    { &liTag, ListItemTag },
+    { &markTag, PhrasingTag },
+    { &navTag, BlockTag },
+    { &olTag, BlockTag },
+    { &pTag, BlockTag },
+    { &qTag, PhrasingTag },
+    { &sTag, PhrasingTag },
+    { &sampTag, PhrasingTag },
+    { &sectionTag, BlockTag },
+    { &smallTag, PhrasingTag },
+    { &spanTag, PhrasingTag },
+    { &strongTag, PhrasingTag },
+    { &subTag, PhrasingTag },
+    { &supTag, PhrasingTag },
+    { &uTag, PhrasingTag },
+    { &ulTag, BlockTag },
+    { &varTag, PhrasingTag },
+    { &wbrTag, VoidTag },
+};
+
+inline bool isVoid(const TagInfo* tag)
+{
+    return tag->kind == VoidTag || tag->kind == VoidBlockTag;
+}
+
+inline bool closesParagraph(const TagInfo* tag)
+{
+    return tag->kind == BlockTag || tag->kind == HeadingTag || tag->kind == ListItemTag || tag->kind == VoidBlockTag;
+}
+
+// The tree builder starts in the data state and the "in body" insertion mode
+// for any other context element.
+bool canParseInContext(Element* contextElement)
+{
+    if (!contextElement || !contextElement->isHTMLElement())
+        return false;
+
+    const QualifiedName& contextTag = contextElement->tagQName();
+    return !(contextTag.matches(titleTag)
+        || contextTag.matches(textareaTag)
+        || contextTag.matches(styleTag)
+        || contextTag.matches(xmpTag)
+        || contextTag.matches(iframeTag)
+        || contextTag.matches(noembedTag)
+        || contextTag.matches(noscriptTag)
+        || contextTag.matches(noframesTag)
+        || contextTag.matches(scriptTag)
+        || contextTag.matches(plaintextTag)
+        || contextTag.matches(selectTag)
+        || contextTag.matches(tableTag)
+        || contextTag.matches(captionTag)
+        || contextTag.matches(colgroupTag)
+        || contextTag.matches(tbodyTag)
+        || contextTag.matches(theadTag)
+        || contextTag.matches(tfootTag)
+        || contextTag.matches(trTag)
+        || contextTag.matches(tdTag)
+        || contextTag.matches(thTag)
+        || contextTag.matches(framesetTag)
+        || contextTag.matches(htmlTag));
+}
+
+// Splits the whole source into tokens before any node is created, so that
+// refusing the markup has no side effects, such as image loads.
+class SimpleFragmentScanner {
+    WTF_MAKE_NONCOPYABLE(SimpleFragmentScanner);
+public:
+    explicit SimpleFragmentScanner(const String& source)
+        : m_characters(source.characters())
+        , m_length(source.length())
+        , m_position(0)
+    {
+    }
+
+    bool scan();
+    void build(DocumentFragment*, HTMLFormElement*);
+
+private:
+    struct Token {
+        enum Type {
+            StartTag,
+            EndTag,
+            Character
+        };
+
+        Token(Type type, const TagInfo* tag)
+            : type(type)
+            , tag(tag)
+            , start(0)
+            , length(0)
+        {
+        }
+
+        Type type;
+        const TagInfo* tag;
+        unsigned start;
+        unsigned length;
+        RefPtr<NamedNodeMap> attributes;
+    };
+
+    bool scanText();
+    bool scanTag();
+    bool scanAttribute(RefPtr<NamedNodeMap>&);
+    bool scanAttributeValue(String&);
+    const TagInfo* scanTagName();
+    bool skipWhitespace();
+    bool consume(UChar);
+
+    bool processStartTag(const TagInfo*, PassRefPtr<NamedNodeMap>);
+    bool processEndTag(const TagInfo*);
+    bool isOpen(const QualifiedName&) const;
+
+    const UChar* m_characters;
+    unsigned m_length;
+    unsigned m_position;
+
+    Vector<Token> m_tokens;
+    Vector<const TagInfo*, 32> m_openTags;
+};
+
+bool SimpleFragmentScanner::scan()
+{
+    while (m_position < m_length) {
+        if (m_characters[m_position] == '<') {
+            if (!scanTag())
+                return false;
+        } else if (!scanText())
+            return false;
+    }
+    return true;
+}
+
+bool SimpleFragmentScanner::scanText()
+{
+    unsigned start = m_position;
+    while (m_position < m_length) {
+        UChar character = m_characters[m_position];
+        if (character == '<')
+            break;
+        // Character references and the input stream preprocessing are left to the tokenizer.
+        if (character == '&' || character == '\r' || !character)
+            return false;
+        ++m_position;
+    }
+
+    // The tree builder splits longer runs into several Text nodes.
+    if (m_position - start > Text::defaultLengthLimit)
+        return false;
+
+    Token token(Token::Character, 0);
+    token.start = start;
+    token.length = m_position - start;
+    m_tokens.append(token);
+    return true;
+}
+
+bool SimpleFragmentScanner::scanTag()
+{
+    ASSERT(m_characters[m_position] == '<');
+    ++m_position;
+
+    bool isEndTag = consume('/');
+    const TagInfo* tag = scanTagName();
+    if (!tag)
+        return false;
+
+    if (isEndTag) {
+        skipWhitespace();
+        return consume('>') && processEndTag(tag);
+    }
+
+    RefPtr<NamedNodeMap> attributes;
+    while (true) {
+        bool sawWhitespace = skipWhitespace();
+        if (m_position >= m_length)
+            return false;
+        // The tree builder ignores the self-closing flag, so <div/> opens a div.
+        if (consume('/'))
+            return consume('>') && processStartTag(tag, attributes.release());
+        if (consume('>'))
+            return processStartTag(tag, attributes.release());
+        if (!sawWhitespace || !scanAttribute(attributes))
+            return false;
+    }
+}
+
+const TagInfo* SimpleFragmentScanner::scanTagName()
+{
+    UChar name[16];
+    unsigned length = 0;
+    while (m_position < m_length && isASCIIAlphanumeric(m_characters[m_position])) {
+        if (length == WTF_ARRAY_LENGTH(name))
+            return 0;
+        name[length++] = toASCIILower(m_characters[m_position++]);
+    }
+    if (!length || !isASCIIAlpha(name[0]))
+        return 0;
+
+    for (size_t i = 0; i < WTF_ARRAY_LENGTH(tags); ++i) {
+        const AtomicString& localName = tags[i].name->localName();
+        if (localName.length() == length && !memcmp(localName.characters(), name, length * sizeof(UChar)))
+            return &tags[i];
+    }
+    return 0;
+}
+
+bool SimpleFragmentScanner::scanAttribute(RefPtr<NamedNodeMap>& attributes)
+{
+    Vector<UChar, 32> name;
+    while (m_position < m_length) {
+        UChar character = m_characters[m_position];
+        if (isHTMLSpace(character) || character == '/' || character == '>' || character == '=')
+            break;
+        if (character == '"' || character == '\'' || character == '<' || character == '&' || character == '\r' || !character)
+            return false;
+        name.append(toASCIILower(character));
+        ++m_position;
+    }
+    if (name.isEmpty())
+        return false;
+
+    String value("");
+    unsigned positionAfterName = m_position;
+    skipWhitespace();
+    if (consume('=')) {
+        skipWhitespace();
+        if (!scanAttributeValue(value))
+            return false;
+    } else
+        m_position = positionAfterName;
+
+    if (!attributes)
+        attributes = NamedNodeMap::create();
+    // Like the tokenizer, keep the first of several attributes with the same name.
+    AtomicString attributeName = HTMLNameCache::makeName(name.data(), name.size());
+    attributes->insertAttribute(Attribute::createMapped(attributeName, HTMLNameCache::makeAttributeValue(value.characters(), value.length())), false);
+    return true;
+}
+
+bool SimpleFragmentScanner::scanAttributeValue(String& value)
+{
+    if (m_position >= m_length)
+        return false;
+
+    UChar quote = m_characters[m_position];
+    if (quote == '"' || quote == '\'') {
+        unsigned start = ++m_position;
+        while (m_position < m_length && m_characters[m_position] != quote) {
+            UChar character = m_characters[m_position];
+            if (character == '&' || character == '\r' || !character)
+                return false;
+            ++m_position;
+        }
+        if (m_position >= m_length)
+            return false;
+        value = String(m_characters + start, m_position - start);
+        ++m_position;
+        return true;
+    }
+
+    unsigned start = m_position;
+    while (m_position < m_length) {
+        UChar character = m_characters[m_position];
+        if (isHTMLSpace(character) || character == '>')
+            break;
+        if (character == '"' || character == '\'' || character == '<' || character == '=' || character == '`' || character == '&' || !character)
+            return false;
+        ++m_position;
+    }
+    if (m_position == start)
+        return false;
+    value = String(m_characters + start, m_position - start);
+    return true;
+}
+
+bool SimpleFragmentScanner::skipWhitespace()
+{
+    unsigned start = m_position;
+    while (m_position < m_length && isHTMLSpace(m_characters[m_position]))
+        ++m_position;
+    return m_position != start;
+}
+
+bool SimpleFragmentScanner::consume(UChar character)
+{
+    if (m_position >= m_length || m_characters[m_position] != character)
+        return false;
+    ++m_position;
+    return true;
+}
+
+bool SimpleFragmentScanner::isOpen(const QualifiedName& tagName) const
+{
+    for (size_t i = 0; i < m_openTags.size(); ++i) {
+        if (m_openTags[i]->name == &tagName)
+            return true;
+    }
+    return false;
+}
+
+bool SimpleFragmentScanner::processStartTag(const TagInfo* tag, PassRefPtr<NamedNodeMap> attributes)
+{
+    // Elements the tree builder would close implicitly are found in the whole
+    // stack rather than in scope, which refuses a little more than necessary.
+    if (closesParagraph(tag) && isOpen(pTag))
+        return false;
+    if (tag->kind == ListItemTag && isOpen(liTag))
+        return false;
+    if (tag->kind == HeadingTag && !m_openTags.isEmpty() && m_openTags.last()->kind == HeadingTag)
+        return false;
+    if (tag->kind == AnchorTag && isOpen(aTag))
+        return false;
+
+    if (!isVoid(tag))
+        m_openTags.append(tag);
+
+    Token token(Token::StartTag, tag);
+    token.attributes = attributes;
+    m_tokens.append(token);
+    return true;
+}
+
+bool SimpleFragmentScanner::processEndTag(const TagInfo* tag)
+{
+    // Any end tag but the current element's makes the tree builder close or ignore elements.
+    if (m_openTags.isEmpty() || m_openTags.last() != tag)
+        return false;
+    m_openTags.removeLast();
+    m_tokens.append(Token(Token::EndTag, tag));
+    return true;
+}
+
+// Mirrors what HTMLConstructionSite and HTMLElementStack do for the same tokens.
+void SimpleFragmentScanner::build(DocumentFragment* fragment, HTMLFormElement* form)
+{
+    Document* document = fragment->document();
+    Vector<RefPtr<Element>, 32> openElements;
+    ContainerNode* currentNode = fragment;
+
+    fragment->beginParsingChildren();
+    for (size_t i = 0; i < m_tokens.size(); ++i) {
+        Token& token = m_tokens[i];
+        switch (token.type) {
+        case Token::Character:
+            currentNode->parserAddChild(Text::create(document, String(m_characters + token.start, token.length)));
+            break;
+        case Token::StartTag: {
+            RefPtr<Element> element = HTMLElementFactory::createHTMLElement(*token.tag->name, document, form, true);
+            element->setAttributeMap(token.attributes.release(), FragmentScriptingAllowed);
+            currentNode->parserAddChild(element);
+            if (isVoid(token.tag)) {
+                element->finishParsingChildren();
+                break;
+            }
+            element->beginParsingChildren();
+            currentNode = element.get();
+            openElements.append(element.release());
+            break;
+        }
+        case Token::EndTag:
+            openElements.last()->finishParsingChildren();
+            openElements.removeLast();
+            currentNode = openElements.isEmpty() ? static_cast<ContainerNode*>(fragment) : openElements.last().get();
+            break;
+        }
+    }
+
+    while (!openElements.isEmpty()) {
+        openElements.last()->finishParsingChildren();
+        openElements.removeLast();
+    }
+    fragment->finishParsingChildren();
+}
+
+} // namespace
+
+bool HTMLSimpleFragmentParser::parse(const String& source, DocumentFragment* fragment, Element* contextElement, FragmentScriptingPermission scriptingPermission)
+{
+    // Removing event handlers is left to the full parser too.
+    if (scriptingPermission != FragmentScriptingAllowed || !canParseInContext(contextElement))
+        return false;
+
+    SimpleFragmentScanner scanner(source);
+    if (!scanner.scan())
+        return false;
+
+    scanner.build(fragment, HTMLTreeBuilder::closestFormAncestor(contextElement));
+    return true;
+}
+
+} // namespace WebCore
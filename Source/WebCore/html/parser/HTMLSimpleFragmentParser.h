@@ -0,0 +1,50 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HTMLSimpleFragmentParser_h
+#define HTMLSimpleFragmentParser_h
+
+#include "FragmentScriptingPermission.h"
+#include <wtf/Forward.h>
+
+namespace WebCore {
+
+class DocumentFragment;
+class Element;
+
+// Parses the markup that innerHTML is usually given, well nested elements
+// with text and attributes, straight into a DocumentFragment without setting
+// up an HTMLDocumentParser. Markup that would make the tree builder do more
+// than insert elements, such as tables, forms, scripts, character references
+// or misnested formatting elements, is refused so that the caller can fall
+// back to the full parser. Nothing is added to the fragment in that case.
+class HTMLSimpleFragmentParser {
+public:
+    static bool parse(const String&, DocumentFragment*, Element* contextElement, FragmentScriptingPermission);
+};
+
+} // namespace WebCore
+
+#endif // HTMLSimpleFragmentParser_h
@@ -26,12 +26,15 @@
 #ifndef HTMLToken_h
 #define HTMLToken_h
 
+#include "HTMLNameCache.h"
 #include "NamedNodeMap.h"
 #include <wtf/PassOwnPtr.h>
 #include <wtf/Vector.h>
 
 namespace WebCore {
 
+class CompactHTMLToken;
+
 class HTMLToken {
     WTF_MAKE_NONCOPYABLE(HTMLToken); WTF_MAKE_FAST_ALLOCATED;
 public:
@@ -160,6 +163,19 @@ public:
         m_data.append(characters);
     }
 
+    void appendToCharacter(const UChar* characters, size_t length)
+    {
+        ASSERT(m_type == Character);
+        m_data.append(characters, length);
+    }
+
+    void removeLeadingCharacters(size_t length)
+    {
+        ASSERT(m_type == Character);
+        ASSERT(length < m_data.size());
+        m_data.remove(0, length);
+    }
+
     void appendToComment(UChar character)
     {
         ASSERT(character);
@@ -222,6 +238,13 @@ public:
         m_currentAttribute->m_value.append(character);
     }
 
+    void appendToAttributeValue(const UChar* characters, size_t length)
+    {
+        ASSERT(m_type == StartTag || m_type == EndTag);
+        ASSERT(m_currentAttribute->m_valueRange.m_start);
+        m_currentAttribute->m_value.append(characters, length);
+    }
+
     void appendToAttributeValue(size_t i, const String& value)
     {
         ASSERT(!value.isEmpty());
@@ -399,7 +422,7 @@ public:
         case HTMLToken::StartTag:
         case HTMLToken::EndTag: {
             m_selfClosing = token.selfClosing();
-            m_name = AtomicString(token.name().data(), token.name().size());
+            m_name = HTMLNameCache::makeName(token.name().data(), token.name().size());
             initializeAttributes(token.attributes());
             break;
         }
@@ -407,11 +430,16 @@ public:
             m_data = String(token.comment().data(), token.comment().size());
             break;
         case HTMLToken::Character:
-            m_externalCharacters = &token.characters();
+            m_externalCharacters = token.characters().data();
+            m_externalCharactersLength = token.characters().size();
             break;
         }
     }
 
+    // The token keeps pointing at the characters of a Character token, so
+    // the CompactHTMLToken has to outlive it.
+    explicit AtomicHTMLToken(const CompactHTMLToken&);
+
     AtomicHTMLToken(HTMLToken::Type type, AtomicString name, PassRefPtr<NamedNodeMap> attributes = 0)
         : m_type(type)
         , m_name(name)
@@ -460,10 +488,16 @@ public:
         return m_attributes.release();
     }
 
-    const HTMLToken::DataVector& characters() const
+    const UChar* characters() const
+    {
+        ASSERT(m_type == HTMLToken::Character);
+        return m_externalCharacters;
+    }
+
+    size_t charactersLength() const
     {
         ASSERT(m_type == HTMLToken::Character);
-        return *m_externalCharacters;
+        return m_externalCharactersLength;
     }
 
     const String& comment() const
@@ -521,7 +555,8 @@ private:
     //
     // FIXME: Add a mechanism for "internalizing" the characters when the
     //        HTMLToken is destructed.
-    const HTMLToken::DataVector* m_externalCharacters;
+    const UChar* m_externalCharacters;
+    size_t m_externalCharactersLength;
 
     // For DOCTYPE
     OwnPtr<HTMLToken::DoctypeData> m_doctypeData;
@@ -550,8 +585,8 @@ inline void AtomicHTMLToken::initializeAttributes(const HTMLToken::AttributeList
         ASSERT(attribute.m_valueRange.m_start);
         ASSERT(attribute.m_valueRange.m_end);
 
-        String name(attribute.m_name.data(), attribute.m_name.size());
-        String value(attribute.m_value.data(), attribute.m_value.size());
+        AtomicString name = HTMLNameCache::makeName(attribute.m_name.data(), attribute.m_name.size());
+        AtomicString value = HTMLNameCache::makeAttributeValue(attribute.m_value.data(), attribute.m_value.size());
         m_attributes->insertAttribute(Attribute::createMapped(name, value), false);
     }
 }
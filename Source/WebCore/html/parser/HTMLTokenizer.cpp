@@ -84,6 +84,32 @@ inline bool vectorEqualsString(const Vector<UChar, 32>& vector, const String& st
     return !memcmp(stringData, vectorData, vector.size() * sizeof(UChar));
 }
 
+// Sets of ASCII characters below 64, for scanning runs of characters that
+// the state machine would only append one at a time.
+inline uint64_t characterBit(char character)
+{
+    ASSERT(character < 64);
+    return static_cast<uint64_t>(1) << character;
+}
+
+// The input stream preprocessor has to see every null, carriage return and
+// newline, so runs always stop before them.
+const uint64_t preprocessedCharacters = characterBit('\0') | characterBit('\r') | characterBit('\n');
+const uint64_t dataStateDelimiters = preprocessedCharacters | characterBit('&') | characterBit('<');
+const uint64_t rawTextDelimiters = preprocessedCharacters | characterBit('<');
+const uint64_t doubleQuotedAttributeValueDelimiters = preprocessedCharacters | characterBit('&') | characterBit('"');
+const uint64_t singleQuotedAttributeValueDelimiters = preprocessedCharacters | characterBit('&') | characterBit('\'');
+
+inline unsigned runLengthBeforeDelimiter(const UChar* characters, unsigned length, uint64_t delimiters)
+{
+    for (unsigned i = 0; i < length; ++i) {
+        UChar character = characters[i];
+        if (character < 64 && (delimiters & (static_cast<uint64_t>(1) << character)))
+            return i;
+    }
+    return length;
+}
+
 inline bool isEndTagBufferingState(HTMLTokenizer::State state)
 {
     switch (state) {
@@ -316,7 +342,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
         } else if (cc == InputStreamPreprocessor::endOfFileMarker)
             return emitEndOfFile(source);
         else {
-            bufferCharacter(cc);
+            bufferCharacters(source, cc, dataStateDelimiters);
             ADVANCE_TO(DataState);
         }
     }
@@ -337,7 +363,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
         else if (cc == InputStreamPreprocessor::endOfFileMarker)
             return emitEndOfFile(source);
         else {
-            bufferCharacter(cc);
+            bufferCharacters(source, cc, dataStateDelimiters);
             ADVANCE_TO(RCDATAState);
         }
     }
@@ -356,7 +382,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
         else if (cc == InputStreamPreprocessor::endOfFileMarker)
             return emitEndOfFile(source);
         else {
-            bufferCharacter(cc);
+            bufferCharacters(source, cc, rawTextDelimiters);
             ADVANCE_TO(RAWTEXTState);
         }
     }
@@ -368,7 +394,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
         else if (cc == InputStreamPreprocessor::endOfFileMarker)
             return emitEndOfFile(source);
         else {
-            bufferCharacter(cc);
+            bufferCharacters(source, cc, rawTextDelimiters);
             ADVANCE_TO(ScriptDataState);
         }
     }
@@ -1003,7 +1029,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             m_token->endAttributeValue(source.numberOfCharactersConsumed());
             RECONSUME_IN(DataState);
         } else {
-            m_token->appendToAttributeValue(cc);
+            appendToAttributeValue(source, cc, doubleQuotedAttributeValueDelimiters);
             ADVANCE_TO(AttributeValueDoubleQuotedState);
         }
     }
@@ -1021,7 +1047,7 @@ bool HTMLTokenizer::nextToken(SegmentedString& source, HTMLToken& token)
             m_token->endAttributeValue(source.numberOfCharactersConsumed());
             RECONSUME_IN(DataState);
         } else {
-            m_token->appendToAttributeValue(cc);
+            appendToAttributeValue(source, cc, singleQuotedAttributeValueDelimiters);
             ADVANCE_TO(AttributeValueSingleQuotedState);
         }
     }
@@ -1662,6 +1688,12 @@ void HTMLTokenizer::updateStateFor(const AtomicString& tagName, Frame* frame)
         setState(RAWTEXTState);
 }
 
+void HTMLTokenizer::setAppropriateEndTagName(const String& tagName)
+{
+    m_appropriateEndTagName.clear();
+    m_appropriateEndTagName.append(tagName.characters(), tagName.length());
+}
+
 inline bool HTMLTokenizer::temporaryBufferIs(const String& expectedString)
 {
     return vectorEqualsString(m_temporaryBuffer, expectedString);
@@ -1685,6 +1717,36 @@ inline void HTMLTokenizer::bufferCharacter(UChar character)
     m_token->appendToCharacter(character);
 }
 
+// Buffers the current character together with the characters after it in
+// the current substring, up to the first delimiter, and leaves the last of
+// them as the current character, so that ADVANCE_TO moves past the whole
+// run as it would past the single character.
+inline void HTMLTokenizer::bufferCharacters(SegmentedString& source, UChar cc, uint64_t delimiters)
+{
+    unsigned length = runLengthBeforeDelimiter(source.currentSubstringCharacters(), source.currentSubstringLength(), delimiters);
+    if (length <= 1) {
+        // The preprocessor may have replaced the current character.
+        bufferCharacter(cc);
+        return;
+    }
+    ASSERT(*source.currentSubstringCharacters() == cc);
+    m_token->ensureIsCharacterToken();
+    m_token->appendToCharacter(source.currentSubstringCharacters(), length);
+    source.advancePastNonNewlines(length - 1);
+}
+
+inline void HTMLTokenizer::appendToAttributeValue(SegmentedString& source, UChar cc, uint64_t delimiters)
+{
+    unsigned length = runLengthBeforeDelimiter(source.currentSubstringCharacters(), source.currentSubstringLength(), delimiters);
+    if (length <= 1) {
+        m_token->appendToAttributeValue(cc);
+        return;
+    }
+    ASSERT(*source.currentSubstringCharacters() == cc);
+    m_token->appendToAttributeValue(source.currentSubstringCharacters(), length);
+    source.advancePastNonNewlines(length - 1);
+}
+
 inline void HTMLTokenizer::parseError()
 {
     notImplemented();
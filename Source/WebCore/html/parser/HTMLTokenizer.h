@@ -131,6 +131,7 @@ public:
     bool nextToken(SegmentedString&, HTMLToken&);
 
     int lineNumber() const { return m_lineNumber; }
+    void setLineNumber(int lineNumber) { m_lineNumber = lineNumber; }
     int columnNumber() const { return 1; } // Matches LegacyHTMLDocumentParser.h behavior.
 
     State state() const { return m_state; }
@@ -154,6 +155,7 @@ public:
 
     // Hack to skip leading newline in <pre>/<listing> for authoring ease.
     // http://www.whatwg.org/specs/web-apps/current-work/multipage/tokenization.html#parsing-main-inbody
+    bool skipLeadingNewLineForListing() const { return m_skipLeadingNewLineForListing; }
     void setSkipLeadingNewLineForListing(bool value) { m_skipLeadingNewLineForListing = value; }
 
     bool forceNullCharacterReplacement() const { return m_forceNullCharacterReplacement; }
@@ -171,6 +173,22 @@ public:
                 || m_state == PLAINTEXTState);
     }
 
+    // True if the tokenizer is holding on to input it has consumed but not
+    // yet emitted, such as a possible end tag or the newline of a \r\n pair.
+    // Otherwise another tokenizer put in the same state, with the same line
+    // number and appropriate end tag name, carries on exactly where this one
+    // stopped.
+    bool hasBufferedInput() const
+    {
+        return !m_bufferedEndTagName.isEmpty()
+            || !m_temporaryBuffer.isEmpty()
+            || m_inputStreamPreprocessor.skipNextNewLine();
+    }
+
+    // The name of the last start tag emitted, which is the end tag that
+    // closes RCDATA, RAWTEXT and script data.
+    void setAppropriateEndTagName(const String&);
+
 private:
     // http://www.whatwg.org/specs/web-apps/current-work/#preprocessing-the-input-stream
     class InputStreamPreprocessor {
@@ -184,6 +202,7 @@ private:
         }
 
         UChar nextInputCharacter() const { return m_nextInputCharacter; }
+        bool skipNextNewLine() const { return m_skipNextNewLine; }
 
         // Returns whether we succeeded in peeking at the next character.
         // The only way we can fail to peek is if there are no more
@@ -264,6 +283,11 @@ private:
     inline void bufferCharacter(UChar);
     inline void bufferCodePoint(unsigned);
 
+    // Take a run of ordinary characters at once instead of going around
+    // the state machine for each of them.
+    inline void bufferCharacters(SegmentedString&, UChar, uint64_t delimiters);
+    inline void appendToAttributeValue(SegmentedString&, UChar, uint64_t delimiters);
+
     inline bool emitAndResumeIn(SegmentedString&, State);
     inline bool emitAndReconsumeIn(SegmentedString&, State);
     inline bool emitEndOfFile(SegmentedString&);
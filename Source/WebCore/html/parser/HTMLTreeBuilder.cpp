@@ -230,27 +230,14 @@ bool isFormattingTag(const AtomicString& tagName)
     return tagName == aTag || isNonAnchorFormattingTag(tagName);
 }
 
-HTMLFormElement* closestFormAncestor(Element* element)
-{
-    while (element) {
-        if (element->hasTagName(formTag))
-            return static_cast<HTMLFormElement*>(element);
-        ContainerNode* parent = element->parentNode();
-        if (!parent || !parent->isElementNode())
-            return 0;
-        element = static_cast<Element*>(parent);
-    }
-    return 0;
-}
-
 } // namespace
 
 class HTMLTreeBuilder::ExternalCharacterTokenBuffer {
     WTF_MAKE_NONCOPYABLE(ExternalCharacterTokenBuffer);
 public:
     explicit ExternalCharacterTokenBuffer(AtomicHTMLToken& token)
-        : m_current(token.characters().data())
-        , m_end(m_current + token.characters().size())
+        : m_current(token.characters())
+        , m_end(m_current + token.charactersLength())
     {
         ASSERT(!isEmpty());
     }
@@ -2839,4 +2826,17 @@ bool HTMLTreeBuilder::pluginsEnabled(Frame* frame)
     return frame->loader()->subframeLoader()->allowPlugins(NotAboutToInstantiatePlugin);
 }
 
+HTMLFormElement* HTMLTreeBuilder::closestFormAncestor(Element* element)
+{
+    while (element) {
+        if (element->hasTagName(formTag))
+            return static_cast<HTMLFormElement*>(element);
+        ContainerNode* parent = element->parentNode();
+        if (!parent || !parent->isElementNode())
+            return 0;
+        element = static_cast<Element*>(parent);
+    }
+    return 0;
+}
+
 }
@@ -49,6 +49,7 @@ class DocumentFragment;
 class Frame;
 class HTMLToken;
 class HTMLDocument;
+class HTMLFormElement;
 class Node;
 class HTMLDocumentParser;
 
@@ -85,6 +86,9 @@ public:
     static bool scriptEnabled(Frame*);
     static bool pluginsEnabled(Frame*);
 
+    // The form that controls parsed into a fragment for this context element are associated with.
+    static HTMLFormElement* closestFormAncestor(Element*);
+
 private:
     class FakeInsertionMode;
     class ExternalCharacterTokenBuffer;
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HTMLTreeBuilderSimulator.h"
+
+#include "CompactHTMLToken.h"
+#include "HTMLTokenizer.h"
+
+namespace WebCore {
+
+namespace {
+
+// Tag names are compared as plain strings, since the AtomicStrings in
+// HTMLNames belong to the main thread.
+inline bool isTextIntegrationPoint(const String& tagName)
+{
+    return tagName == "mi" || tagName == "mo" || tagName == "mn" || tagName == "ms" || tagName == "mtext";
+}
+
+inline bool isHTMLIntegrationPoint(const String& tagName)
+{
+    return tagName == "foreignObject" || tagName == "desc" || tagName == "title";
+}
+
+bool isVoidElement(const String& tagName)
+{
+    return tagName == "area"
+        || tagName == "base"
+        || tagName == "basefont"
+        || tagName == "bgsound"
+        || tagName == "br"
+        || tagName == "col"
+        || tagName == "command"
+        || tagName == "embed"
+        || tagName == "frame"
+        || tagName == "hr"
+        || tagName == "image"
+        || tagName == "img"
+        || tagName == "input"
+        || tagName == "keygen"
+        || tagName == "link"
+        || tagName == "meta"
+        || tagName == "param"
+        || tagName == "source"
+        || tagName == "track"
+        || tagName == "wbr";
+}
+
+bool hasAttribute(const CompactHTMLToken& token, const char* name)
+{
+    const Vector<CompactHTMLToken::Attribute>& attributes = token.attributes();
+    for (size_t i = 0; i < attributes.size(); ++i) {
+        if (attributes[i].name == name)
+            return true;
+    }
+    return false;
+}
+
+// The start tags that HTMLTreeBuilder::processStartTag() pops foreign
+// content for.
+bool causesForeignContentBreakout(const CompactHTMLToken& token)
+{
+    static const char* const breakoutTags[] = {
+        "b", "big", "blockquote", "body", "br", "center", "code", "dd", "div", "dl", "dt", "em", "embed",
+        "h1", "h2", "h3", "h4", "h5", "h6", "head", "hr", "i", "img", "li", "listing", "menu", "meta", "nobr",
+        "ol", "p", "pre", "ruby", "s", "small", "span", "strong", "strike", "sub", "sup", "table", "tt", "u",
+        "ul", "var"
+    };
+    const String& tagName = token.data();
+    for (size_t i = 0; i < WTF_ARRAY_LENGTH(breakoutTags); ++i) {
+        if (tagName == breakoutTags[i])
+            return true;
+    }
+    return tagName == "font" && (hasAttribute(token, "color") || hasAttribute(token, "face") || hasAttribute(token, "size"));
+}
+
+} // namespace
+
+void HTMLTreeBuilderSimulator::simulate(const CompactHTMLToken& token, HTMLTokenizer& tokenizer)
+{
+    if (token.type() == HTMLToken::StartTag)
+        processStartTag(token, tokenizer);
+    else if (token.type() == HTMLToken::EndTag)
+        processEndTag(token, tokenizer);
+
+    // See HTMLTreeBuilder::constructTreeFromAtomicToken().
+    tokenizer.setForceNullCharacterReplacement(m_inTextMode || inForeignContent());
+    tokenizer.setShouldAllowCDATA(!m_inTextMode && inForeignContent() && m_foreignContentStack.last().elementNamespace != HTML);
+}
+
+bool HTMLTreeBuilderSimulator::processesStartTagsAsHTML() const
+{
+    if (!inForeignContent())
+        return true;
+    const OpenElement& currentElement = m_foreignContentStack.last();
+    if (currentElement.elementNamespace == HTML)
+        return true;
+    if (currentElement.elementNamespace == SVG)
+        return isHTMLIntegrationPoint(currentElement.name);
+    return isTextIntegrationPoint(currentElement.name);
+}
+
+void HTMLTreeBuilderSimulator::processStartTag(const CompactHTMLToken& token, HTMLTokenizer& tokenizer)
+{
+    const String& tagName = token.data();
+
+    if (!processesStartTagsAsHTML()) {
+        if (!causesForeignContentBreakout(token)) {
+            Namespace elementNamespace = m_foreignContentStack.last().elementNamespace;
+            if (tagName == "svg")
+                elementNamespace = SVG;
+            else if (tagName == "math")
+                elementNamespace = MathML;
+            if (!token.selfClosing())
+                m_foreignContentStack.append(OpenElement(tagName, elementNamespace));
+            return;
+        }
+        m_foreignContentStack.clear();
+    }
+
+    if (tagName == "svg" || tagName == "math") {
+        if (!token.selfClosing())
+            m_foreignContentStack.append(OpenElement(tagName, tagName == "svg" ? SVG : MathML));
+        return;
+    }
+
+    if (inForeignContent() && !isVoidElement(tagName))
+        m_foreignContentStack.append(OpenElement(tagName, HTML));
+
+    // See HTMLTokenizer::updateStateFor().
+    if (tagName == "textarea" || tagName == "title") {
+        tokenizer.setState(HTMLTokenizer::RCDATAState);
+        m_inTextMode = true;
+    } else if (tagName == "plaintext")
+        tokenizer.setState(HTMLTokenizer::PLAINTEXTState);
+    else if (tagName == "script") {
+        tokenizer.setState(HTMLTokenizer::ScriptDataState);
+        m_inTextMode = true;
+    } else if (tagName == "style"
+        || tagName == "iframe"
+        || tagName == "xmp"
+        || (tagName == "noembed" && m_pluginsEnabled)
+        || tagName == "noframes"
+        || (tagName == "noscript" && m_scriptEnabled)) {
+        tokenizer.setState(HTMLTokenizer::RAWTEXTState);
+        m_inTextMode = true;
+    }
+
+    if (tagName == "pre" || tagName == "listing" || tagName == "textarea")
+        tokenizer.setSkipLeadingNewLineForListing(true);
+}
+
+void HTMLTreeBuilderSimulator::processEndTag(const CompactHTMLToken& token, HTMLTokenizer& tokenizer)
+{
+    const String& tagName = token.data();
+
+    if (m_inTextMode) {
+        m_inTextMode = false;
+        if (tagName == "script")
+            tokenizer.setState(HTMLTokenizer::DataState);
+    }
+
+    for (size_t i = m_foreignContentStack.size(); i; --i) {
+        if (m_foreignContentStack[i - 1].name == tagName) {
+            m_foreignContentStack.shrink(i - 1);
+            break;
+        }
+    }
+}
+
+} // namespace WebCore
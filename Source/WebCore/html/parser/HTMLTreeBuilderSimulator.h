@@ -0,0 +1,90 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HTMLTreeBuilderSimulator_h
+#define HTMLTreeBuilderSimulator_h
+
+#include "PlatformString.h"
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+class CompactHTMLToken;
+class HTMLTokenizer;
+
+// Predicts how HTMLTreeBuilder changes the tokenizer state as it processes
+// each token, from the tokens alone. It tracks whether the tree builder is
+// in TextMode and which elements are open in foreign content, and nothing
+// else, so it can be wrong; a <style> in a frameset, for instance, is
+// ignored by the tree builder but not here. HTMLDocumentParser checks every
+// prediction. It works on any thread.
+class HTMLTreeBuilderSimulator {
+    WTF_MAKE_NONCOPYABLE(HTMLTreeBuilderSimulator); WTF_MAKE_FAST_ALLOCATED;
+public:
+    HTMLTreeBuilderSimulator(bool scriptEnabled, bool pluginsEnabled)
+        : m_scriptEnabled(scriptEnabled)
+        , m_pluginsEnabled(pluginsEnabled)
+        , m_inTextMode(false)
+    {
+    }
+
+    void simulate(const CompactHTMLToken&, HTMLTokenizer&);
+
+private:
+    enum Namespace {
+        HTML,
+        SVG,
+        MathML
+    };
+
+    struct OpenElement {
+        // The token's name goes to the main thread with the token, so keep a
+        // copy that this thread alone refers to.
+        OpenElement(const String& name, Namespace elementNamespace)
+            : name(name.threadsafeCopy())
+            , elementNamespace(elementNamespace)
+        {
+        }
+
+        String name;
+        Namespace elementNamespace;
+    };
+
+    bool inForeignContent() const { return !m_foreignContentStack.isEmpty(); }
+    bool processesStartTagsAsHTML() const;
+    void processStartTag(const CompactHTMLToken&, HTMLTokenizer&);
+    void processEndTag(const CompactHTMLToken&, HTMLTokenizer&);
+
+    bool m_scriptEnabled;
+    bool m_pluginsEnabled;
+    bool m_inTextMode;
+    // The elements opened since the outermost <svg> or <math>, that one included.
+    Vector<OpenElement> m_foreignContentStack;
+};
+
+} // namespace WebCore
+
+#endif // HTMLTreeBuilderSimulator_h
@@ -189,6 +189,13 @@ void XSSFilter::init()
         m_isEnabled = false;
 }
 
+bool XSSFilter::isActive()
+{
+    if (m_state == Uninitialized)
+        init();
+    return m_isEnabled && m_xssProtection != XSSProtectionDisabled;
+}
+
 void XSSFilter::filterToken(HTMLToken& token)
 {
     if (m_state == Uninitialized) {
@@ -41,6 +41,9 @@ public:
 
     void filterToken(HTMLToken&);
 
+    // Whether filterToken() can change tokens in this document.
+    bool isActive();
+
 private:
     enum State {
         Uninitialized,
@@ -319,6 +319,18 @@ TextResourceDecoder::~TextResourceDecoder()
 {
 }
 
+PassRefPtr<TextResourceDecoder> TextResourceDecoder::clone() const
+{
+    ASSERT(!m_checkedForBOM && m_buffer.isEmpty());
+
+    RefPtr<TextResourceDecoder> decoder = adoptRef(new TextResourceDecoder(String(), m_encoding, m_usesEncodingDetector));
+    decoder->m_contentType = m_contentType;
+    decoder->m_source = m_source;
+    decoder->m_hintEncoding = m_hintEncoding;
+    decoder->m_useLenientXMLDecoding = m_useLenientXMLDecoding;
+    return decoder.release();
+}
+
 void TextResourceDecoder::setEncoding(const TextEncoding& encoding, EncodingSource source)
 {
     // In case the encoding didn't exist, we keep the old one (helps some sites specifying invalid encodings).
@@ -48,6 +48,10 @@ public:
     }
     ~TextResourceDecoder();
 
+    // A decoder with the same settings, for decoding the same data on another
+    // thread. Nothing may have been decoded with this one yet.
+    PassRefPtr<TextResourceDecoder> clone() const;
+
     void setEncoding(const TextEncoding&, EncodingSource);
     const TextEncoding& encoding() const { return m_encoding; }
 
@@ -31,6 +31,9 @@
 #if ENABLE(WEB_ARCHIVE)
 
 #include "Base64.h"
+#include "Document.h"
+#include "Element.h"
+#include "markup.h"
 #include <libxml/encoding.h>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
@@ -61,9 +64,50 @@ PassRefPtr<WebArchiveAndroid> WebArchiveAndroid::create(PassRefPtr<ArchiveResour
     return 0;
 }
 
+namespace {
+
+// Encodes markup as it is serialized, so a large document is never held as
+// one String alongside its UTF-8 copy.
+class MarkupBufferWriter : public MarkupChunkClient {
+public:
+    MarkupBufferWriter()
+        : m_buffer(SharedBuffer::create())
+    {
+    }
+
+    virtual void didSerializeMarkupChunk(const String& chunk)
+    {
+        CString utf8Chunk = chunk.utf8();
+        m_buffer->append(utf8Chunk.data(), utf8Chunk.length());
+    }
+
+    PassRefPtr<SharedBuffer> buffer() { return m_buffer.release(); }
+
+private:
+    RefPtr<SharedBuffer> m_buffer;
+};
+
+} // namespace
+
+// A frame whose document was built by script, such as an about:blank iframe,
+// has no source to save, so its current markup is saved instead.
+static PassRefPtr<ArchiveResource> createMainResourceFromMarkup(Frame* frame, PassRefPtr<ArchiveResource> mainResource)
+{
+    Document* document = frame->document();
+    if (!document || !document->documentElement())
+        return mainResource;
+
+    MarkupBufferWriter writer;
+    writer.didSerializeMarkupChunk(frame->documentTypeString());
+    createMarkupInChunks(document->documentElement(), &writer);
+    return ArchiveResource::create(writer.buffer(), mainResource->url(), "text/html", "UTF-8", mainResource->frameName());
+}
+
 PassRefPtr<WebArchiveAndroid> WebArchiveAndroid::create(Frame* frame)
 {
-    PassRefPtr<ArchiveResource> mainResource = frame->loader()->documentLoader()->mainResource();
+    RefPtr<ArchiveResource> mainResource = frame->loader()->documentLoader()->mainResource();
+    if (mainResource->data()->isEmpty())
+        mainResource = createMainResourceFromMarkup(frame, mainResource.release());
     Vector<PassRefPtr<ArchiveResource> > subresources;
     Vector<PassRefPtr<Archive> > subframes;
     int children = frame->tree()->childCount();
@@ -73,7 +117,7 @@ PassRefPtr<WebArchiveAndroid> WebArchiveAndroid::create(Frame* frame)
     for (int child = 0; child < children; child++)
         subframes.append(create(frame->tree()->child(child)));
 
-    return create(mainResource, subresources, subframes);
+    return create(mainResource.release(), subresources, subframes);
 }
 
 WebArchiveAndroid::WebArchiveAndroid(PassRefPtr<ArchiveResource> mainResource,
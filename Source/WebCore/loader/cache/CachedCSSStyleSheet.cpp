@@ -27,6 +27,7 @@
 #include "config.h"
 #include "CachedCSSStyleSheet.h"
 
+#include "CSSPreparser.h"
 #include "MemoryCache.h"
 #include "CachedResourceClient.h"
 #include "CachedResourceClientWalker.h"
@@ -48,6 +49,8 @@ CachedCSSStyleSheet::CachedCSSStyleSheet(const String& url, const String& charse
 
 CachedCSSStyleSheet::~CachedCSSStyleSheet()
 {
+    if (m_preparseJob)
+        m_preparseJob->cancel();
 }
 
 void CachedCSSStyleSheet::didAddClient(CachedResourceClient *c)
@@ -95,6 +98,16 @@ void CachedCSSStyleSheet::data(PassRefPtr<SharedBuffer> data, bool allDataReceiv
 
     m_data = data;
     setEncodedSize(m_data.get() ? m_data->size() : 0);
+    if (m_preparseJob) {
+        m_preparseJob->cancel();
+        m_preparseJob = 0;
+    }
+    // Smaller sheets are not parsed lazily, so there would only be the decoding to save.
+    if (m_data && CSSPreparser::isEnabled() && m_data->size() >= CSSParser::minimumLazySheetLength) {
+        // The sheet stays loading until didFinishPreparse().
+        m_preparseJob = CSSPreparser::instance()->preparse(this, m_decoder.get(), m_data->data(), m_data->size());
+        return;
+    }
     // Decode the data to find out the encoding and keep the sheet text around during checkNotify()
     if (m_data) {
         m_decodedSheetText = m_decoder->decode(m_data->data(), m_data->size());
@@ -106,6 +119,25 @@ void CachedCSSStyleSheet::data(PassRefPtr<SharedBuffer> data, bool allDataReceiv
     m_decodedSheetText = String();
 }
 
+void CachedCSSStyleSheet::didFinishPreparse()
+{
+    // The preparser thread decoded the sheet with a copy of our decoder, which now knows the sheet's encoding.
+    m_decoder = m_preparseJob->releaseDecoder();
+    m_decodedSheetText = m_preparseJob->releaseSheetText();
+    setLoading(false);
+    checkNotify();
+    m_decodedSheetText = String();
+    m_preparseJob = 0;
+}
+
+const Vector<CSSBlockExtent>* CachedCSSStyleSheet::preparsedBlocks() const
+{
+    // The blocks go with m_decodedSheetText, which is only kept while the clients are told about the sheet.
+    if (!m_preparseJob || isLoading())
+        return 0;
+    return &m_preparseJob->blocks();
+}
+
 void CachedCSSStyleSheet::checkNotify()
 {
     if (isLoading())
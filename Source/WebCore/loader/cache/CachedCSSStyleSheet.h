@@ -32,8 +32,10 @@
 
 namespace WebCore {
 
+    class CSSPreparseJob;
     class CachedResourceLoader;
     class TextResourceDecoder;
+    struct CSSBlockExtent;
 
     class CachedCSSStyleSheet : public CachedResource {
     public:
@@ -41,6 +43,8 @@ namespace WebCore {
         virtual ~CachedCSSStyleSheet();
 
         const String sheetText(bool enforceMIMEType = true, bool* hasValidMIMEType = 0) const;
+        // The blocks of sheetText() when its clients are told about a sheet the CSSPreparser has scanned; otherwise 0.
+        const Vector<CSSBlockExtent>* preparsedBlocks() const;
 
         virtual void didAddClient(CachedResourceClient*);
         
@@ -54,12 +58,16 @@ namespace WebCore {
         void checkNotify();
     
     private:
+        friend class CSSPreparser;
+
         bool canUseSheet(bool enforceMIMEType, bool* hasValidMIMEType) const;
+        void didFinishPreparse();
         virtual PurgePriority purgePriority() const { return PurgeLast; }
 
     protected:
         RefPtr<TextResourceDecoder> m_decoder;
         String m_decodedSheetText;
+        RefPtr<CSSPreparseJob> m_preparseJob;
     };
 
 }
@@ -35,7 +35,10 @@
 #include <wtf/Vector.h>
 
 #if USE(JSC)  
+#include "ScriptPreparser.h"
 #include <parser/SourceProvider.h>
+#elif USE(V8)
+#include "ScriptPreparser.h"
 #endif
 
 namespace WebCore {
@@ -44,6 +47,9 @@ CachedScript::CachedScript(const String& url, const String& charset)
     : CachedResource(url, Script)
     , m_decoder(TextResourceDecoder::create("application/javascript", charset))
     , m_decodedDataDeletionTimer(this, &CachedScript::decodedDataDeletionTimerFired)
+#if USE(JSC)
+    , m_preparsedSyntaxIsValid(false)
+#endif
 {
     // It's javascript we want.
     // But some websites think their scripts are <some wrong mimetype here>
@@ -100,6 +106,17 @@ void CachedScript::data(PassRefPtr<SharedBuffer> data, bool allDataReceived)
 
     m_data = data;
     setEncodedSize(m_data.get() ? m_data->size() : 0);
+#if USE(JSC)
+    m_preparsedSyntaxIsValid = false;
+#endif
+#if USE(JSC) || USE(V8)
+    // Decoding never yields more characters than there are bytes, so shorter scripts are not decoded here.
+    if (ScriptPreparser::isEnabled() && encodedSize() >= ScriptPreparser::minimumSourceLength && script().length() >= ScriptPreparser::minimumSourceLength) {
+        m_preparseJob = ScriptPreparser::instance()->preparse(m_script);
+        // The script is about to run, so keep the decoded source instead of letting script() drop it.
+        m_decodedDataDeletionTimer.stop();
+    }
+#endif
     setLoading(false);
     checkNotify();
 }
@@ -144,6 +161,34 @@ void CachedScript::sourceProviderCacheSizeChanged(int delta)
 {
     setDecodedSize(decodedSize() + delta);
 }
+
+bool CachedScript::adoptPreparseResults()
+{
+    if (!m_preparseJob)
+        return m_preparsedSyntaxIsValid;
+
+    if (m_preparseJob->isFinished()) {
+        JSC::SourceProviderCache* cache = sourceProviderCache();
+        unsigned oldCacheSize = cache->byteSize();
+        m_preparsedSyntaxIsValid = m_preparseJob->adoptResults(cache);
+        sourceProviderCacheSizeChanged(cache->byteSize() - oldCacheSize);
+    }
+    // Once the script has been parsed on the main thread, its cache is already
+    // filled, so a preparse that has not finished by now is of no further use.
+    m_preparseJob = 0;
+    return m_preparsedSyntaxIsValid;
+}
+#elif USE(V8)
+PassOwnPtr<v8::ScriptData> CachedScript::takePreparseResults()
+{
+    OwnPtr<v8::ScriptData> scriptData;
+    if (m_preparseJob && m_preparseJob->isFinished())
+        scriptData = m_preparseJob->takeScriptData();
+    // The data ends up in the cached metadata either way, so a preparse that
+    // has not finished by now is of no further use.
+    m_preparseJob = 0;
+    return scriptData.release();
+}
 #endif
 
 } // namespace WebCore
@@ -33,11 +33,16 @@
 namespace JSC {
     class SourceProviderCache;
 }
+#elif USE(V8)
+namespace v8 {
+    class ScriptData;
+}
 #endif
 
 namespace WebCore {
 
     class CachedResourceLoader;
+    class ScriptPreparseJob;
     class TextResourceDecoder;
 
     class CachedScript : public CachedResource {
@@ -60,6 +65,13 @@ namespace WebCore {
         // Allows JSC to cache additional information about the source.
         JSC::SourceProviderCache* sourceProviderCache() const;
         void sourceProviderCacheSizeChanged(int delta);
+
+        // Moves the results of a finished background preparse into the source provider cache.
+        // Returns true if the script is known to be free of syntax errors.
+        bool adoptPreparseResults();
+#elif USE(V8)
+        // Hands over the results of a finished background preparse, or 0 if there are none.
+        PassOwnPtr<v8::ScriptData> takePreparseResults();
 #endif
     private:
         void decodedDataDeletionTimerFired(Timer<CachedScript>*);
@@ -70,6 +82,10 @@ namespace WebCore {
         Timer<CachedScript> m_decodedDataDeletionTimer;
 #if USE(JSC)        
         mutable OwnPtr<JSC::SourceProviderCache> m_sourceProviderCache;
+        RefPtr<ScriptPreparseJob> m_preparseJob;
+        bool m_preparsedSyntaxIsValid;
+#elif USE(V8)
+        RefPtr<ScriptPreparseJob> m_preparseJob;
 #endif
     };
 }
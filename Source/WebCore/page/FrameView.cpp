@@ -845,9 +845,13 @@ void FrameView::layout(bool allowSubtree)
     }
 
     // Viewport-dependent media queries may cause us to need completely different style information.
-    // Check that here.
-    if (document->styleSelector()->affectedByViewportChange())
+    // Check that here. Style rules in @media blocks are only turned on or off, which needs a new
+    // style for every element but not a new style selector.
+    CSSStyleSelector* styleSelector = document->styleSelector();
+    if (styleSelector->affectedByViewportChange())
         document->styleSelectorChanged(RecalcStyleImmediately);
+    else if (styleSelector->updateMediaQueryRules())
+        document->mediaQueryRulesChanged();
 
     // Always ensure our style info is up-to-date.  This can happen in situations where
     // the layout beats any sort of style recalc update that needs to occur.
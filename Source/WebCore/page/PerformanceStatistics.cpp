@@ -0,0 +1,118 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PerformanceStatistics.h"
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+
+#include "Attribute.h"
+#include "BackgroundHTMLParser.h"
+#include "CSSParser.h"
+#include "CSSPreparser.h"
+#include "CSSStyleSelector.h"
+#include "Document.h"
+#include "EventDispatcher.h"
+#include "HTMLConstructionSite.h"
+#include "HTMLNameCache.h"
+#include "HTMLPreloadScanner.h"
+#include "Node.h"
+#include "ScriptPreparser.h"
+#include "StyleInterner.h"
+#include "WordWidthCache.h"
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+static double percentage(unsigned part, unsigned whole)
+{
+    return whole ? 100.0 * part / whole : 0.0;
+}
+
+static void appendStyleInternerStatistics(Vector<String>& lines, const char* name, const StyleInterner::TableStatistics& table)
+{
+    lines.append(String::format("Style data %s: %u interned, %u shared, %u unique", name, table.interned, table.shared, table.unique));
+}
+
+Vector<String> performanceStatistics(Document* document)
+{
+    Vector<String> lines;
+
+    BackgroundHTMLParser::Statistics documents = BackgroundHTMLParser::statistics();
+    lines.append(String::format("Documents tokenized in the background: %u, handed over: %u, characters: %u, in %.3fs; main thread time: %.3fms/KB",
+        documents.documentsParsed, documents.documentsHandedOver, documents.charactersTokenized, documents.tokenizeTime,
+        documents.charactersProcessed ? documents.mainThreadTime * 1000 * 1024 / documents.charactersProcessed : 0.0));
+    HTMLNameCache::Statistics names = HTMLNameCache::statistics();
+    lines.append(String::format("Names and attribute values looked up: %u, found in the name cache: %u (%.1f%%)",
+        names.lookups, names.hits, percentage(names.hits, names.lookups)));
+    HTMLPreloadScanner::Statistics preloads = HTMLPreloadScanner::statistics();
+    lines.append(String::format("Characters preload scanned: %u, not tokenized again: %u (%.1f%%)",
+        preloads.charactersTokenized, preloads.charactersReused, percentage(preloads.charactersReused, preloads.charactersTokenized)));
+    ScriptPreparser::Statistics scripts = ScriptPreparser::instance()->statistics();
+    lines.append(String::format("Scripts preparsed: %u, adopted: %u, discarded: %u, preparse time: %.3fs, main thread time saved: %.3fs",
+        scripts.scriptsPreparsed, scripts.scriptsAdopted, scripts.scriptsDiscarded, scripts.preparseTime, scripts.mainThreadTimeSaved));
+    HTMLConstructionSite::AttributeSharingStatistics attributes = HTMLConstructionSite::attributeSharingStatistics();
+    lines.append(String::format("Parsed elements with attributes: %u, sharing them: %u; attributes shared: %u (%u bytes)",
+        attributes.elementsWithAttributes, attributes.elementsSharingAttributes, attributes.attributesShared,
+        attributes.attributesShared * static_cast<unsigned>(sizeof(Attribute))));
+    Node::NodeListInvalidationStatistics nodeLists = Node::attributeNodeListInvalidationStatistics();
+    lines.append(String::format("Attribute changes that invalidated node lists: %u, skipped: %u",
+        nodeLists.invalidationsPerformed, nodeLists.invalidationsSkipped));
+    EventDispatcher::PathCacheStatistics eventPaths = EventDispatcher::pathCacheStatistics();
+    lines.append(String::format("Event paths built: %u, reused: %u", eventPaths.pathsBuilt, eventPaths.pathsReused));
+    CSSPreparser::Statistics sheets = CSSPreparser::instance()->statistics();
+    lines.append(String::format("Style sheets preparsed: %u, adopted: %u, discarded: %u, decode time: %.3fs, scan time: %.3fs, main thread time saved: %.3fs",
+        sheets.sheetsPreparsed, sheets.sheetsAdopted, sheets.sheetsDiscarded, sheets.decodeTime, sheets.scanTime, sheets.mainThreadTimeSaved));
+    CSSParser::LazyParsingStatistics css = CSSParser::lazyParsingStatistics();
+    lines.append(String::format("Style sheets parsed lazily: %u, in %.3fs; declaration blocks skipped: %u, parsed later: %u, in %.3fs",
+        css.sheetsParsedLazily, css.sheetParseTime, css.declarationBlocksSkipped, css.declarationBlocksParsed, css.declarationBlockParseTime));
+    StyleInterner::Statistics styles = StyleInterner::instance()->statistics();
+    appendStyleInternerStatistics(lines, "box", styles.box);
+    appendStyleInternerStatistics(lines, "visual", styles.visual);
+    appendStyleInternerStatistics(lines, "background", styles.background);
+    appendStyleInternerStatistics(lines, "surround", styles.surround);
+    appendStyleInternerStatistics(lines, "rare non-inherited", styles.rareNonInherited);
+    appendStyleInternerStatistics(lines, "rare inherited", styles.rareInherited);
+    appendStyleInternerStatistics(lines, "inherited", styles.inherited);
+    const WordWidthCache::Statistics& words = WordWidthCache::statistics();
+    lines.append(String::format("Word widths looked up: %u, hits: %u (%.1f%%), full caches cleared: %u",
+        words.lookups, words.hits, percentage(words.hits, words.lookups), words.clears));
+
+    if (CSSStyleSelector* styleSelector = document->styleSelectorIfExists()) {
+        const CSSStyleSelector::MatchedPropertiesCacheStatistics& cache = styleSelector->matchedPropertiesCacheStatistics();
+        lines.append(String::format("Matched properties cache lookups: %u, hits: %u, inherited only hits: %u, additions: %u",
+            cache.lookups, cache.hits, cache.inheritedOnlyHits, cache.additions));
+        const CSSStyleSelector::StyleInvalidationStatistics& invalidations = styleSelector->styleInvalidationStatistics();
+        lines.append(String::format("Class, id and attribute changes: %u, ignored: %u; invalidated elements: %u, subtrees: %u, siblings: %u; elements restyled: %u",
+            invalidations.mutations, invalidations.mutationsIgnored, invalidations.elementInvalidations,
+            invalidations.subtreeInvalidations, invalidations.siblingInvalidations, invalidations.elementsRecalculated));
+    }
+
+    return lines;
+}
+
+} // namespace WebCore
+
+#endif // ENABLE(PERFORMANCE_STATISTICS)
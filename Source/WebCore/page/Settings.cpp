@@ -27,6 +27,8 @@
 #include "Settings.h"
 
 #include "BackForwardController.h"
+#include "BackgroundHTMLParser.h"
+#include "CSSPreparser.h"
 #include "CachedResourceLoader.h"
 #include "CookieStorage.h"
 #include "DOMTimer.h"
@@ -38,6 +40,7 @@
 #include "Page.h"
 #include "PageCache.h"
 #include "ResourceHandle.h"
+#include "ScriptPreparser.h"
 #include "StorageMap.h"
 #include <limits>
 
@@ -495,6 +498,36 @@ double Settings::defaultMinDOMTimerInterval()
     return DOMTimer::defaultMinTimerInterval();
 }
 
+void Settings::setScriptPreparsingEnabled(bool enabled)
+{
+    ScriptPreparser::setEnabled(enabled);
+}
+
+bool Settings::scriptPreparsingEnabled()
+{
+    return ScriptPreparser::isEnabled();
+}
+
+void Settings::setStyleSheetPreparsingEnabled(bool enabled)
+{
+    CSSPreparser::setEnabled(enabled);
+}
+
+bool Settings::styleSheetPreparsingEnabled()
+{
+    return CSSPreparser::isEnabled();
+}
+
+void Settings::setBackgroundHTMLParserEnabled(bool enabled)
+{
+    BackgroundHTMLParser::setEnabled(enabled);
+}
+
+bool Settings::backgroundHTMLParserEnabled()
+{
+    return BackgroundHTMLParser::isEnabled();
+}
+
 void Settings::setMinDOMTimerInterval(double interval)
 {
     m_page->setMinimumTimerInterval(interval);
@@ -234,6 +234,18 @@ namespace WebCore {
         
         static void setDefaultMinDOMTimerInterval(double); // Interval specified in seconds.
         static double defaultMinDOMTimerInterval();
+
+        // Preparses large external scripts on a background thread once they have loaded.
+        static void setScriptPreparsingEnabled(bool);
+        static bool scriptPreparsingEnabled();
+
+        // Decodes and scans large external style sheets on a background thread once they have loaded.
+        static void setStyleSheetPreparsingEnabled(bool);
+        static bool styleSheetPreparsingEnabled();
+
+        // Tokenizes documents loaded from the network on a background thread.
+        static void setBackgroundHTMLParserEnabled(bool);
+        static bool backgroundHTMLParserEnabled();
         
         void setMinDOMTimerInterval(double); // Per-page; initialized to default value.
         double minDOMTimerInterval();
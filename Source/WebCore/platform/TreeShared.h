@@ -23,6 +23,7 @@
 
 #include <wtf/Assertions.h>
 #include <wtf/Noncopyable.h>
+#include <wtf/StdLibExtras.h>
 #include <wtf/Threading.h>
 
 namespace WebCore {
@@ -104,6 +105,10 @@ public:
         return m_parent;
     }
 
+#if ENABLE(CSS_SELECTOR_JIT)
+    static ptrdiff_t parentMemoryOffset() { return OBJECT_OFFSETOF(TreeShared, m_parent); }
+#endif
+
 #ifndef NDEBUG
     bool m_deletionHasBegun;
     bool m_inRemovedLastRefFunction;
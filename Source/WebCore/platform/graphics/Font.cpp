@@ -31,6 +31,7 @@
 #include "GlyphBuffer.h"
 #include "TextRun.h"
 #include "WidthIterator.h"
+#include "WordWidthCache.h"
 #include <wtf/MathExtras.h>
 #include <wtf/UnusedParam.h>
 
@@ -165,6 +166,39 @@ void Font::drawEmphasisMarks(GraphicsContext* context, const TextRun& run, const
         drawEmphasisMarksForComplexText(context, run, mark, point, from, to);
 }
 
+WordWidthCache* Font::wordWidthCache(const TextRun& run, HashSet<const SimpleFontData*>* fallbackFonts, GlyphOverflow* glyphOverflow) const
+{
+    if (static_cast<unsigned>(run.length()) > WordWidthCache::maximumWordLength)
+        return 0;
+    // Tabs depend on the position of the run, and expansion on the rest of the line.
+    if (run.allowTabs() || run.expansion())
+        return 0;
+#if ENABLE(SVG)
+    if (run.horizontalGlyphStretch() != 1)
+        return 0;
+#endif
+    // Fonts that share a fallback list can differ in spacing.
+    if (m_letterSpacing || m_wordSpacing)
+        return 0;
+    // The cache doesn't keep fallback fonts or glyph bounds.
+    if (fallbackFonts && canReturnFallbackFontsForComplexText())
+        return 0;
+    if (glyphOverflow && glyphOverflow->computeBounds)
+        return 0;
+    if (loadingCustomFonts())
+        return 0;
+    return m_fontList->wordWidthCache();
+}
+
+// Adds the overflow of one run to the overflow of the text it is part of, as measuring the run into it does.
+static inline void addGlyphOverflow(GlyphOverflow* glyphOverflow, const WordWidthCache::Entry& entry)
+{
+    glyphOverflow->top = std::max(glyphOverflow->top, entry.glyphOverflowTop);
+    glyphOverflow->bottom = std::max(glyphOverflow->bottom, entry.glyphOverflowBottom);
+    glyphOverflow->left = entry.glyphOverflowLeft;
+    glyphOverflow->right = entry.glyphOverflowRight;
+}
+
 float Font::width(const TextRun& run, HashSet<const SimpleFontData*>* fallbackFonts, GlyphOverflow* glyphOverflow) const
 {
 #if ENABLE(SVG_FONTS)
@@ -172,15 +206,41 @@ float Font::width(const TextRun& run, HashSet<const SimpleFontData*>* fallbackFo
         return floatWidthUsingSVGFont(run);
 #endif
 
+    WordWidthCache* cache = wordWidthCache(run, fallbackFonts, glyphOverflow);
+    WordWidthCache::Entry entry;
+    if (cache && cache->get(run, entry)) {
+        if (glyphOverflow && entry.hasGlyphOverflow)
+            addGlyphOverflow(glyphOverflow, entry);
+        return entry.width;
+    }
+
+    // The caller's GlyphOverflow holds what the runs before this one overflow by, so a run that
+    // goes into the cache is measured into an empty one instead, even if the caller wants none.
     CodePath codePathToUse = codePath(run);
+    GlyphOverflow runGlyphOverflow;
+    GlyphOverflow* measuredGlyphOverflow = cache && codePathToUse != Simple ? &runGlyphOverflow : glyphOverflow;
+
+    float width;
     if (codePathToUse != Complex) {
         // If the complex text implementation cannot return fallback fonts, avoid
         // returning them for simple text as well.
         static bool returnFallbackFonts = canReturnFallbackFontsForComplexText();
-        return floatWidthForSimpleText(run, 0, returnFallbackFonts ? fallbackFonts : 0, codePathToUse == SimpleWithGlyphOverflow || (glyphOverflow && glyphOverflow->computeBounds) ? glyphOverflow : 0);
+        width = floatWidthForSimpleText(run, 0, returnFallbackFonts ? fallbackFonts : 0, codePathToUse == SimpleWithGlyphOverflow || (measuredGlyphOverflow && measuredGlyphOverflow->computeBounds) ? measuredGlyphOverflow : 0);
+    } else
+        width = floatWidthForComplexText(run, fallbackFonts, measuredGlyphOverflow);
+
+    if (cache) {
+        entry.width = width;
+        entry.hasGlyphOverflow = codePathToUse != Simple;
+        entry.glyphOverflowLeft = runGlyphOverflow.left;
+        entry.glyphOverflowRight = runGlyphOverflow.right;
+        entry.glyphOverflowTop = runGlyphOverflow.top;
+        entry.glyphOverflowBottom = runGlyphOverflow.bottom;
+        cache->add(run, entry);
+        if (glyphOverflow && entry.hasGlyphOverflow)
+            addGlyphOverflow(glyphOverflow, entry);
     }
-
-    return floatWidthForComplexText(run, fallbackFonts, glyphOverflow);
+    return width;
 }
 
 float Font::width(const TextRun& run, int extraCharsAvailable, int& charsConsumed, String& glyphName) const
@@ -52,6 +52,7 @@ class GlyphPageTreeNode;
 class GraphicsContext;
 class SVGFontElement;
 class TextRun;
+class WordWidthCache;
 
 struct GlyphData;
 
@@ -167,6 +168,9 @@ private:
 
     enum ForTextEmphasisOrNot { NotForTextEmphasis, ForTextEmphasis };
 
+    // Returns 0 if the width of the run can't be cached.
+    WordWidthCache* wordWidthCache(const TextRun&, HashSet<const SimpleFontData*>* fallbackFonts, GlyphOverflow*) const;
+
     // Returns the initial in-stream advance.
     float getGlyphsAndAdvancesForSimpleText(const TextRun&, int from, int to, GlyphBuffer&, ForTextEmphasisOrNot = NotForTextEmphasis) const;
     void drawSimpleText(GraphicsContext*, const TextRun&, const FloatPoint&, int from, int to) const;
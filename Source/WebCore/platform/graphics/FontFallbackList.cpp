@@ -58,6 +58,7 @@ void FontFallbackList::invalidate(PassRefPtr<FontSelector> fontSelector)
     m_loadingCustomFonts = false;
     m_fontSelector = fontSelector;
     m_generation = fontCache()->generation();
+    m_wordWidthCache.clear();
 }
 
 void FontFallbackList::releaseFontData()
@@ -23,7 +23,9 @@
 
 #include "FontSelector.h"
 #include "SimpleFontData.h"
+#include "WordWidthCache.h"
 #include <wtf/Forward.h>
+#include <wtf/OwnPtr.h>
 
 namespace WebCore {
 
@@ -52,6 +54,13 @@ public:
     FontSelector* fontSelector() const { return m_fontSelector.get(); }
     unsigned generation() const { return m_generation; }
 
+    WordWidthCache* wordWidthCache() const
+    {
+        if (!m_wordWidthCache)
+            m_wordWidthCache = adoptPtr(new WordWidthCache);
+        return m_wordWidthCache.get();
+    }
+
 private:
     FontFallbackList();
 
@@ -79,6 +88,7 @@ private:
     mutable Pitch m_pitch;
     mutable bool m_loadingCustomFonts;
     unsigned m_generation;
+    mutable OwnPtr<WordWidthCache> m_wordWidthCache;
 
     friend class Font;
 };
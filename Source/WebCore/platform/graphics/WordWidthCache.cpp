@@ -0,0 +1,111 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WordWidthCache.h"
+
+#include "TextRun.h"
+#include <wtf/StringHasher.h>
+
+namespace WebCore {
+
+// Throwing a full cache away is cheaper than keeping track of which widths are still useful.
+static const unsigned maximumCacheSize = 512;
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+WordWidthCache::Statistics WordWidthCache::s_statistics;
+#endif
+
+namespace {
+
+struct WordKey {
+    WordKey(const TextRun& run)
+        : characters(run.characters())
+        , length(run.length())
+        , flags(run.rtl() | run.directionalOverride() << 1 | run.spacingDisabled() << 2)
+    {
+        StringHasher hasher;
+        for (unsigned i = 0; i < length; ++i)
+            hasher.addCharacter(characters[i]);
+        hasher.addCharacter(flags);
+        hash = hasher.hash();
+    }
+
+    const UChar* characters;
+    unsigned length;
+    UChar flags;
+    unsigned hash;
+};
+
+struct WordKeyTranslator {
+    static unsigned hash(const WordKey& key) { return key.hash; }
+
+    static bool equal(const String& string, const WordKey& key)
+    {
+        return string.length() == key.length + 1
+            && string[key.length] == key.flags
+            && !memcmp(string.characters(), key.characters, key.length * sizeof(UChar));
+    }
+
+    static void translate(String& location, const WordKey& key, unsigned)
+    {
+        UChar* characters;
+        location = String::createUninitialized(key.length + 1, characters);
+        memcpy(characters, key.characters, key.length * sizeof(UChar));
+        characters[key.length] = key.flags;
+    }
+};
+
+} // namespace
+
+bool WordWidthCache::get(const TextRun& run, Entry& entry)
+{
+    ASSERT(static_cast<unsigned>(run.length()) <= maximumWordLength);
+#if ENABLE(PERFORMANCE_STATISTICS)
+    ++s_statistics.lookups;
+#endif
+    WidthMap::iterator it = m_widths.find<WordKey, WordKeyTranslator>(WordKey(run));
+    if (it == m_widths.end())
+        return false;
+#if ENABLE(PERFORMANCE_STATISTICS)
+    ++s_statistics.hits;
+#endif
+    entry = it->second;
+    return true;
+}
+
+void WordWidthCache::add(const TextRun& run, const Entry& entry)
+{
+    ASSERT(static_cast<unsigned>(run.length()) <= maximumWordLength);
+    if (m_widths.size() >= maximumCacheSize) {
+        m_widths.clear();
+#if ENABLE(PERFORMANCE_STATISTICS)
+        ++s_statistics.clears;
+#endif
+    }
+    m_widths.add<WordKey, WordKeyTranslator>(WordKey(run), entry);
+}
+
+} // namespace WebCore
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WordWidthCache_h
+#define WordWidthCache_h
+
+#include <wtf/FastAllocBase.h>
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/text/StringHash.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+class TextRun;
+
+// Remembers the widths of short runs measured with one FontFallbackList, so
+// that a word laid out again, or appearing many times, is only measured once.
+// Font::width() decides which runs can be cached.
+class WordWidthCache {
+    WTF_MAKE_NONCOPYABLE(WordWidthCache); WTF_MAKE_FAST_ALLOCATED;
+public:
+    // Longer runs are rarely measured twice.
+    static const unsigned maximumWordLength = 32;
+
+    WordWidthCache() { }
+
+    struct Entry {
+        Entry()
+            : width(0)
+            , hasGlyphOverflow(false)
+            , glyphOverflowLeft(0)
+            , glyphOverflowRight(0)
+            , glyphOverflowTop(0)
+            , glyphOverflowBottom(0)
+        {
+        }
+
+        float width;
+        // Whether the code path that measured the run reports glyph overflow, and what it
+        // reported when measuring into an empty GlyphOverflow.
+        bool hasGlyphOverflow;
+        int glyphOverflowLeft;
+        int glyphOverflowRight;
+        int glyphOverflowTop;
+        int glyphOverflowBottom;
+    };
+
+    bool get(const TextRun&, Entry&);
+    void add(const TextRun&, const Entry&);
+    void clear() { m_widths.clear(); }
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    struct Statistics {
+        Statistics()
+            : lookups(0)
+            , hits(0)
+            , clears(0)
+        {
+        }
+
+        unsigned lookups;
+        unsigned hits;
+        // Caches emptied because they were full.
+        unsigned clears;
+    };
+
+    // Totals over all caches.
+    static const Statistics& statistics() { return s_statistics; }
+#endif
+
+private:
+    // The key is the run's characters followed by one character holding the
+    // flags of the run that can change its width.
+    typedef HashMap<String, Entry> WidthMap;
+    WidthMap m_widths;
+
+#if ENABLE(PERFORMANCE_STATISTICS)
+    static Statistics s_statistics;
+#endif
+};
+
+} // namespace WebCore
+
+#endif // WordWidthCache_h
@@ -204,6 +204,24 @@ public:
     // Writes the consumed characters into consumedCharacters, which must
     // have space for at least |count| characters.
     void advance(unsigned count, UChar* consumedCharacters);
+    // Counts the newlines among the |count| characters as advance(int&) does.
+    void advance(unsigned count, int& lineNumber);
+
+    // The characters left in the current substring, starting with the
+    // current character, for callers that scan ahead. There are none while
+    // a pushed character is current.
+    const UChar* currentSubstringCharacters() const { return m_currentString.m_current; }
+    unsigned currentSubstringLength() const { return m_pushedChar1 ? 0 : m_currentString.m_length; }
+
+    // Advances past |count| characters of the current substring, none of
+    // which may be a newline, and stays within it.
+    void advancePastNonNewlines(unsigned count)
+    {
+        ASSERT(!m_pushedChar1);
+        ASSERT(count < static_cast<unsigned>(m_currentString.m_length));
+        m_currentString.m_length -= count;
+        m_currentChar = m_currentString.m_current += count;
+    }
 
     bool escaped() const { return m_pushedChar1; }
 
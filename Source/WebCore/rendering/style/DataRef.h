@@ -48,6 +48,9 @@ public:
         m_data = T::create();
     }
 
+    // Lets a StyleInterner table replace the data with an equal copy.
+    template<typename Table> void internIn(Table& table) { table.intern(m_data); }
+
     bool operator==(const DataRef<T>& o) const
     {
         ASSERT(m_data);
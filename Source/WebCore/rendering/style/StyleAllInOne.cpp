@@ -41,6 +41,7 @@
 #include "StyleFlexibleBoxData.cpp"
 #include "StyleGeneratedImage.cpp"
 #include "StyleInheritedData.cpp"
+#include "StyleInterner.cpp"
 #include "StyleMarqueeData.cpp"
 #include "StyleMultiColData.cpp"
 #include "StyleRareInheritedData.cpp"
@@ -0,0 +1,268 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "StyleInterner.h"
+
+#include "RenderStyle.h"
+#include <wtf/HashFunctions.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/Vector.h>
+
+#define DUMP_STYLE_INTERNER_STATISTICS 0
+
+#if DUMP_STYLE_INTERNER_STATISTICS
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+namespace WebCore {
+
+// Dropping unused data means walking every table, so it is done after this many styles.
+static const unsigned stylesBetweenPrunes = 1024;
+
+namespace {
+
+class DataHasher {
+public:
+    DataHasher()
+        : m_hash(0)
+    {
+    }
+
+    void add(unsigned value) { m_hash = WTF::intHash((static_cast<uint64_t>(m_hash) << 32) | value); }
+    // 0 and -0 compare equal, so they must hash alike.
+    void add(float value) { add(value ? bitwise_cast<unsigned>(value) : 0u); }
+    void add(const Length& length)
+    {
+        add(static_cast<unsigned>(length.type()));
+        add(static_cast<unsigned>(length.value()));
+    }
+    void add(const LengthBox& box)
+    {
+        add(box.left());
+        add(box.right());
+        add(box.top());
+        add(box.bottom());
+    }
+    void add(const Color& color) { add(static_cast<unsigned>(color.rgb())); }
+
+    unsigned hash() const { return m_hash; }
+
+private:
+    unsigned m_hash;
+};
+
+} // namespace
+
+StyleInterner* StyleInterner::instance()
+{
+    DEFINE_STATIC_LOCAL(StyleInterner*, instance, (new StyleInterner));
+    return instance;
+}
+
+StyleInterner::StyleInterner()
+    : m_stylesSincePrune(0)
+{
+#if DUMP_STYLE_INTERNER_STATISTICS
+    atexit(StyleInterner::dumpStatistics);
+#endif
+}
+
+void StyleInterner::intern(RenderStyle* style)
+{
+    style->m_box.internIn(m_box);
+    style->visual.internIn(m_visual);
+    style->m_background.internIn(m_background);
+    style->surround.internIn(m_surround);
+    style->rareNonInheritedData.internIn(m_rareNonInherited);
+    style->rareInheritedData.internIn(m_rareInherited);
+    style->inherited.internIn(m_inherited);
+
+    if (++m_stylesSincePrune == stylesBetweenPrunes)
+        prune();
+}
+
+void StyleInterner::prune()
+{
+    m_box.prune();
+    m_visual.prune();
+    m_background.prune();
+    m_surround.prune();
+    m_rareNonInherited.prune();
+    m_rareInherited.prune();
+    m_inherited.prune();
+    m_stylesSincePrune = 0;
+}
+
+StyleInterner::Statistics StyleInterner::statistics() const
+{
+    Statistics statistics;
+    statistics.box = m_box.statistics();
+    statistics.visual = m_visual.statistics();
+    statistics.background = m_background.statistics();
+    statistics.surround = m_surround.statistics();
+    statistics.rareNonInherited = m_rareNonInherited.statistics();
+    statistics.rareInherited = m_rareInherited.statistics();
+    statistics.inherited = m_inherited.statistics();
+    return statistics;
+}
+
+#if DUMP_STYLE_INTERNER_STATISTICS
+static void dumpTableStatistics(const char* name, const StyleInterner::TableStatistics& table)
+{
+    printf("%-20s %10u interned, %10u shared, %10u unique\n", name, table.interned, table.shared, table.unique);
+}
+#endif
+
+void StyleInterner::dumpStatistics()
+{
+#if DUMP_STYLE_INTERNER_STATISTICS
+    Statistics statistics = instance()->statistics();
+    printf("\nStyleInterner statistics\n\n");
+    dumpTableStatistics("box", statistics.box);
+    dumpTableStatistics("visual", statistics.visual);
+    dumpTableStatistics("background", statistics.background);
+    dumpTableStatistics("surround", statistics.surround);
+    dumpTableStatistics("rare non-inherited", statistics.rareNonInherited);
+    dumpTableStatistics("rare inherited", statistics.rareInherited);
+    dumpTableStatistics("inherited", statistics.inherited);
+#endif
+}
+
+template<typename T> void StyleInterner::Table<T>::intern(RefPtr<T>& data)
+{
+    ++m_statistics.interned;
+    pair<typename HashSet<RefPtr<T>, Hash>::iterator, bool> result = m_data.add(data);
+    if (!result.second && *result.first != data) {
+        data = *result.first;
+        ++m_statistics.shared;
+    }
+}
+
+template<typename T> void StyleInterner::Table<T>::prune()
+{
+    // The table's own reference is the only one left on data no style uses.
+    Vector<T*> unused;
+    typename HashSet<RefPtr<T>, Hash>::iterator end = m_data.end();
+    for (typename HashSet<RefPtr<T>, Hash>::iterator it = m_data.begin(); it != end; ++it) {
+        if ((*it)->hasOneRef())
+            unused.append(it->get());
+    }
+    for (size_t i = 0; i < unused.size(); ++i)
+        m_data.remove(unused[i]);
+}
+
+template<typename T> StyleInterner::TableStatistics StyleInterner::Table<T>::statistics() const
+{
+    TableStatistics statistics = m_statistics;
+    statistics.unique = m_data.size();
+    return statistics;
+}
+
+unsigned StyleInterner::hash(const StyleBoxData& data)
+{
+    DataHasher hasher;
+    hasher.add(data.width());
+    hasher.add(data.height());
+    hasher.add(data.minWidth());
+    hasher.add(data.maxWidth());
+    hasher.add(data.minHeight());
+    hasher.add(data.maxHeight());
+    hasher.add(data.verticalAlign());
+    hasher.add(static_cast<unsigned>(data.zIndex()));
+    return hasher.hash();
+}
+
+unsigned StyleInterner::hash(const StyleVisualData& data)
+{
+    DataHasher hasher;
+    hasher.add(data.clip);
+    hasher.add(data.textDecoration);
+    hasher.add(data.m_zoom);
+    return hasher.hash();
+}
+
+unsigned StyleInterner::hash(const StyleBackgroundData& data)
+{
+    DataHasher hasher;
+    hasher.add(data.color());
+    hasher.add(static_cast<unsigned>(data.background().hasImage()));
+    hasher.add(data.outline().color());
+    return hasher.hash();
+}
+
+unsigned StyleInterner::hash(const StyleSurroundData& data)
+{
+    DataHasher hasher;
+    hasher.add(data.offset);
+    hasher.add(data.margin);
+    hasher.add(data.padding);
+    return hasher.hash();
+}
+
+unsigned StyleInterner::hash(const StyleRareNonInheritedData& data)
+{
+    DataHasher hasher;
+    hasher.add(data.opacity);
+    hasher.add(data.userDrag);
+    hasher.add(data.marginBeforeCollapse);
+    hasher.add(data.marginAfterCollapse);
+    hasher.add(data.m_appearance);
+    hasher.add(static_cast<unsigned>(data.m_counterIncrement));
+    hasher.add(static_cast<unsigned>(data.m_counterReset));
+    hasher.add(data.m_perspective);
+    return hasher.hash();
+}
+
+unsigned StyleInterner::hash(const StyleRareInheritedData& data)
+{
+    DataHasher hasher;
+    hasher.add(data.textStrokeColor);
+    hasher.add(data.textStrokeWidth);
+    hasher.add(data.textFillColor);
+    hasher.add(data.indent);
+    hasher.add(data.m_effectiveZoom);
+    hasher.add(static_cast<unsigned>(data.widows));
+    hasher.add(static_cast<unsigned>(data.orphans));
+    hasher.add(data.userModify);
+    hasher.add(data.wordWrap);
+    return hasher.hash();
+}
+
+unsigned StyleInterner::hash(const StyleInheritedData& data)
+{
+    DataHasher hasher;
+    hasher.add(data.line_height);
+    hasher.add(data.color);
+    hasher.add(data.font.fontDescription().computedSize());
+    hasher.add(static_cast<unsigned>(data.font.fontDescription().weight()));
+    hasher.add(static_cast<unsigned>(data.font.fontDescription().italic()));
+    hasher.add(static_cast<unsigned>(data.horizontal_border_spacing));
+    hasher.add(static_cast<unsigned>(data.vertical_border_spacing));
+    return hasher.hash();
+}
+
+} // namespace WebCore
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef StyleInterner_h
+#define StyleInterner_h
+
+#include <wtf/FastAllocBase.h>
+#include <wtf/HashSet.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/RefPtr.h>
+
+namespace WebCore {
+
+class RenderStyle;
+class StyleBackgroundData;
+class StyleBoxData;
+class StyleInheritedData;
+class StyleRareInheritedData;
+class StyleRareNonInheritedData;
+class StyleSurroundData;
+class StyleVisualData;
+
+// Keeps one copy of each distinct value of the data that RenderStyle shares
+// copy-on-write, so that styles resolved separately to equal values share it
+// too. Copies that no style uses any more are dropped every so often.
+class StyleInterner {
+    WTF_MAKE_NONCOPYABLE(StyleInterner); WTF_MAKE_FAST_ALLOCATED;
+public:
+    static StyleInterner* instance();
+
+    // Replaces the style's data with equal data used by an earlier style,
+    // where there is any.
+    void intern(RenderStyle*);
+    void prune();
+
+    struct TableStatistics {
+        TableStatistics()
+            : interned(0)
+            , shared(0)
+            , unique(0)
+        {
+        }
+
+        // Data passed to intern(), and how much of it was replaced by an equal copy.
+        unsigned interned;
+        unsigned shared;
+        // Distinct values in use now.
+        unsigned unique;
+    };
+
+    struct Statistics {
+        TableStatistics box;
+        TableStatistics visual;
+        TableStatistics background;
+        TableStatistics surround;
+        TableStatistics rareNonInherited;
+        TableStatistics rareInherited;
+        TableStatistics inherited;
+    };
+
+    Statistics statistics() const;
+
+    // Does nothing unless DUMP_STYLE_INTERNER_STATISTICS is set in StyleInterner.cpp, which also calls it at exit.
+    static void dumpStatistics();
+
+private:
+    StyleInterner();
+
+    template<typename T> class Table {
+    public:
+        void intern(RefPtr<T>&);
+        void prune();
+        TableStatistics statistics() const;
+
+    private:
+        struct Hash {
+            static unsigned hash(const RefPtr<T>& data) { return StyleInterner::hash(*data); }
+            static bool equal(const RefPtr<T>& a, const RefPtr<T>& b) { return a == b || *a == *b; }
+            static const bool safeToCompareToEmptyOrDeleted = false;
+        };
+
+        HashSet<RefPtr<T>, Hash> m_data;
+        TableStatistics m_statistics;
+    };
+
+    // Equal data must hash alike, so these only look at values that operator== compares.
+    static unsigned hash(const StyleBoxData&);
+    static unsigned hash(const StyleVisualData&);
+    static unsigned hash(const StyleBackgroundData&);
+    static unsigned hash(const StyleSurroundData&);
+    static unsigned hash(const StyleRareNonInheritedData&);
+    static unsigned hash(const StyleRareInheritedData&);
+    static unsigned hash(const StyleInheritedData&);
+
+    Table<StyleBoxData> m_box;
+    Table<StyleVisualData> m_visual;
+    Table<StyleBackgroundData> m_background;
+    Table<StyleSurroundData> m_surround;
+    Table<StyleRareNonInheritedData> m_rareNonInherited;
+    Table<StyleRareInheritedData> m_rareInherited;
+    Table<StyleInheritedData> m_inherited;
+
+    unsigned m_stylesSincePrune;
+};
+
+} // namespace WebCore
+
+#endif // StyleInterner_h
@@ -348,7 +348,7 @@ void Step::nodesInAxis(Node* context, NodeSet& nodes) const
                 return;
 
             for (unsigned i = 0; i < attrs->length(); ++i) {
-                RefPtr<Attr> attr = attrs->attributeItem(i)->createAttrIfNeeded(static_cast<Element*>(context));
+                RefPtr<Attr> attr = static_pointer_cast<Attr>(attrs->item(i));
                 if (nodeMatches(attr.get(), AttributeAxis, m_nodeTest))
                     nodes.append(attr.release());
             }
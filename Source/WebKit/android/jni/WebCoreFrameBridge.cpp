@@ -79,6 +79,7 @@
 #include "SecurityOrigin.h"
 #include "SelectionController.h"
 #include "Settings.h"
+#include "StyleInterner.h"
 #include "SubstituteData.h"
 #include "UrlInterceptResponse.h"
 #include "UserGestureIndicator.h"
@@ -1623,6 +1624,9 @@ static void ClearWebCoreCache()
     WebCore::pageCache()->setCapacity(0);
     WebCore::pageCache()->releaseAutoreleasedPagesNow();
     WebCore::pageCache()->setCapacity(pageCapacity);
+
+    // Drop the style data that only the released pages were using.
+    WebCore::StyleInterner::instance()->prune();
 }
 
 static void ClearWebViewCache()
@@ -160,6 +160,9 @@
 #include "AndroidLog.h"
 #include "RenderTreeAsText.h"
 #include <wtf/text/CString.h>
+#if ENABLE(PERFORMANCE_STATISTICS)
+#include "PerformanceStatistics.h"
+#endif
 
 FILE* gDomTreeFile = 0;
 FILE* gRenderTreeFile = 0;
@@ -1253,6 +1256,11 @@ void WebViewCore::dumpDomTree(bool useFile)
     if (useFile)
         gDomTreeFile = fopen(DOM_TREE_LOG_FILE, "w");
     m_mainFrame->document()->showTreeForThis();
+#if ENABLE(PERFORMANCE_STATISTICS)
+    Vector<String> statistics = WebCore::performanceStatistics(m_mainFrame->document());
+    for (size_t i = 0; i < statistics.size(); ++i)
+        DUMP_DOM_LOGD("%s\n", statistics[i].utf8().data());
+#endif
     if (gDomTreeFile) {
         fclose(gDomTreeFile);
         gDomTreeFile = 0;
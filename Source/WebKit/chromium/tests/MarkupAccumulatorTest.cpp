@@ -0,0 +1,169 @@
+/*
+ * Copyright 2011, The Android Open Source Project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "markup.h"
+
+#include "Document.h"
+#include "Element.h"
+#include "ExceptionCode.h"
+#include "Frame.h"
+#include "HTMLElement.h"
+#include "HTMLNames.h"
+#include "Text.h"
+#include "WebFrameClient.h"
+#include "WebFrameImpl.h"
+#include "WebString.h"
+#include "WebURL.h"
+#include "WebURLRequest.h"
+#include "WebURLResponse.h"
+#include "WebView.h"
+
+#include <googleurl/src/gurl.h>
+#include <gtest/gtest.h>
+#include <webkit/support/webkit_support.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringBuilder.h>
+
+using namespace WebCore;
+using namespace WebKit;
+
+namespace {
+
+class TestWebFrameClient : public WebFrameClient {
+};
+
+class ChunkCollector : public MarkupChunkClient {
+public:
+    virtual void didSerializeMarkupChunk(const String& chunk) { chunks.append(chunk); }
+
+    String joinedChunks() const
+    {
+        StringBuilder builder;
+        for (size_t i = 0; i < chunks.size(); ++i)
+            builder.append(chunks[i]);
+        return builder.toString();
+    }
+
+    Vector<String> chunks;
+};
+
+class MarkupAccumulatorTest : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        WebURL url = GURL("http://www.test.com/markup_chunks.html");
+        WebURLResponse response;
+        response.initialize();
+        response.setMIMEType("text/html");
+        std::string filePath = webkit_support::GetWebKitRootDir().utf8();
+        filePath += "/Source/WebKit/chromium/tests/data/markup_chunks.html";
+        webkit_support::RegisterMockedURL(url, response, WebString::fromUTF8(filePath));
+
+        m_webView = WebView::create(0);
+        m_webView->initializeMainFrame(&m_webFrameClient);
+
+        WebURLRequest urlRequest;
+        urlRequest.initialize();
+        urlRequest.setURL(url);
+        m_webView->mainFrame()->loadRequest(urlRequest);
+        webkit_support::ServeAsynchronousMockedRequests();
+    }
+
+    virtual void TearDown()
+    {
+        webkit_support::UnregisterAllMockedURLs();
+        m_webView->close();
+    }
+
+    Document* document() const
+    {
+        return static_cast<WebFrameImpl*>(m_webView->mainFrame())->frame()->document();
+    }
+
+    // Adds enough paragraphs to the body for its markup to take several chunks.
+    void appendParagraphs(unsigned count)
+    {
+        ExceptionCode ec = 0;
+        for (unsigned i = 0; i < count; ++i) {
+            RefPtr<Element> paragraph = document()->createElement(HTMLNames::pTag, false);
+            paragraph->setAttribute(HTMLNames::classAttr, "paragraph");
+            paragraph->appendChild(document()->createTextNode("Text with characters to escape: <&>"), ec);
+            document()->body()->appendChild(paragraph.release(), ec);
+        }
+        ASSERT_FALSE(ec);
+    }
+
+    WebView* m_webView;
+
+private:
+    TestWebFrameClient m_webFrameClient;
+};
+
+// The accumulator hands a chunk over once it has this many characters.
+static const size_t markupChunkLength = 64 * 1024;
+
+TEST_F(MarkupAccumulatorTest, SmallSubtreeIsOneChunk)
+{
+    ChunkCollector collector;
+    createMarkupInChunks(document()->documentElement(), &collector);
+
+    ASSERT_EQ(1u, collector.chunks.size());
+    EXPECT_TRUE(collector.chunks[0] == createMarkup(document()->documentElement()));
+}
+
+TEST_F(MarkupAccumulatorTest, ChunksJoinToWholeMarkup)
+{
+    appendParagraphs(5000);
+
+    ChunkCollector collector;
+    createMarkupInChunks(document()->documentElement(), &collector);
+
+    EXPECT_LT(1u, collector.chunks.size());
+    for (size_t i = 0; i + 1 < collector.chunks.size(); ++i)
+        EXPECT_LE(markupChunkLength, collector.chunks[i].length());
+    EXPECT_TRUE(collector.joinedChunks() == createMarkup(document()->documentElement()));
+}
+
+TEST_F(MarkupAccumulatorTest, ChildrenOnlyChunks)
+{
+    appendParagraphs(5000);
+
+    ChunkCollector collector;
+    createMarkupInChunks(document()->body(), &collector, ChildrenOnly);
+
+    EXPECT_LT(1u, collector.chunks.size());
+    EXPECT_TRUE(collector.joinedChunks() == createMarkup(document()->body(), ChildrenOnly));
+}
+
+TEST_F(MarkupAccumulatorTest, NoChunksForNullNode)
+{
+    ChunkCollector collector;
+    createMarkupInChunks(0, &collector);
+
+    EXPECT_TRUE(collector.chunks.isEmpty());
+}
+
+} // namespace
@@ -695,6 +695,11 @@ void DumpRenderTreeSupportGtk::setMinimumTimerInterval(WebKitWebView* webView, d
     core(webView)->settings()->setMinDOMTimerInterval(interval);
 }
 
+void DumpRenderTreeSupportGtk::setBackgroundHTMLParserEnabled(bool enabled)
+{
+    Settings::setBackgroundHTMLParserEnabled(enabled);
+}
+
 static void modifyAccessibilityValue(AtkObject* axObject, bool increment)
 {
     if (!axObject || !WEBKIT_IS_ACCESSIBLE(axObject))
@@ -98,6 +98,7 @@ public:
     static bool selectedRange(WebKitWebView*, int* start, int* end);
     static double defaultMinimumTimerInterval(); // Not really tied to WebView
     static void setMinimumTimerInterval(WebKitWebView*, double);
+    static void setBackgroundHTMLParserEnabled(bool); // Not really tied to WebView
     static void rectangleForSelection(WebKitWebFrame*, GdkRectangle*);
 
     // Accessibility
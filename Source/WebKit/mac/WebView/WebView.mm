@@ -2826,6 +2826,11 @@ static PassOwnPtr<Vector<String> > toStringVector(NSArray* patterns)
         _private->page->settings()->setMinDOMTimerInterval(intervalInSeconds);
 }
 
++ (void)_setBackgroundHTMLParserEnabled:(BOOL)enabled
+{
+    Settings::setBackgroundHTMLParserEnabled(enabled);
+}
+
 + (BOOL)_HTTPPipeliningEnabled
 {
     return ResourceRequest::httpPipeliningEnabled();
@@ -594,6 +594,14 @@ Could be worth adding to the API.
 */
 - (void)_setMinimumTimerInterval:(double)intervalInSeconds;
 
+/*!
+    @method _setBackgroundHTMLParserEnabled:
+    @discussion Lets documents loaded from the network be tokenized on a separate
+    thread. This applies to every WebView in the process. Defaults to NO.
+    @param enabled YES to tokenize on the parser thread, NO to tokenize on the main thread.
+*/
++ (void)_setBackgroundHTMLParserEnabled:(BOOL)enabled;
+
 /*!
     @method _HTTPPipeliningEnabled
     @abstract Checks the HTTP pipelining status.
@@ -1022,6 +1022,11 @@ void DumpRenderTreeSupportQt::setMinimumTimerInterval(QWebPage* page, double int
     corePage->settings()->setMinDOMTimerInterval(interval);
 }
 
+void DumpRenderTreeSupportQt::setBackgroundHTMLParserEnabled(bool enabled)
+{
+    Settings::setBackgroundHTMLParserEnabled(enabled);
+}
+
 QUrl DumpRenderTreeSupportQt::mediaContentUrlByElementId(QWebFrame* frame, const QString& elementId)
 {
     QUrl res;
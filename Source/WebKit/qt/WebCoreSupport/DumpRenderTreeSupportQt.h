@@ -197,6 +197,7 @@ public:
 
     static double defaultMinimumTimerInterval(); // Not really tied to WebView
     static void setMinimumTimerInterval(QWebPage*, double);
+    static void setBackgroundHTMLParserEnabled(bool); // Not really tied to WebView
 
     static QUrl mediaContentUrlByElementId(QWebFrame*, const QString& elementId);
     static void setAlternateHtml(QWebFrame*, const QString& html, const QUrl& baseUrl, const QUrl& failingUrl);
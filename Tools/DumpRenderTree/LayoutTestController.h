@@ -334,6 +334,10 @@ public:
 
     void setMinimumTimerInterval(double);
 
+    // Tokenizes documents loaded from the network on the parser thread. This is
+    // process-wide, so DumpRenderTree turns it back off after every test.
+    void setBackgroundHTMLParserEnabled(bool);
+
 private:
     LayoutTestController(const std::string& testPathOrURL, const std::string& expectedPixelHash);
 
@@ -446,6 +446,7 @@ static void resetDefaultsToConsistentValues()
 
     webkit_web_view_set_zoom_level(webView, 1.0);
     DumpRenderTreeSupportGtk::setMinimumTimerInterval(webView, DumpRenderTreeSupportGtk::defaultMinimumTimerInterval());
+    DumpRenderTreeSupportGtk::setBackgroundHTMLParserEnabled(false);
 
     DumpRenderTreeSupportGtk::resetOriginAccessWhiteLists();
 
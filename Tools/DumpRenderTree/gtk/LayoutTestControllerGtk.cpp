@@ -955,3 +955,8 @@ void LayoutTestController::setMinimumTimerInterval(double minimumTimerInterval)
     WebKitWebView* webView = webkit_web_frame_get_web_view(mainFrame);
     DumpRenderTreeSupportGtk::setMinimumTimerInterval(webView, minimumTimerInterval);
 }
+
+void LayoutTestController::setBackgroundHTMLParserEnabled(bool enabled)
+{
+    DumpRenderTreeSupportGtk::setBackgroundHTMLParserEnabled(enabled);
+}
@@ -140,6 +140,7 @@ StorageTrackerDelegate *storageDelegate;
 
 static int dumpPixels;
 static int threaded;
+static int backgroundHTMLParser;
 static int dumpTree = YES;
 static int forceComplexText;
 static BOOL printSeparators;
@@ -585,6 +586,7 @@ static void initializeGlobalsFromCommandLineOptions(int argc, const char *argv[]
         {"pixel-tests", no_argument, &dumpPixels, YES},
         {"tree", no_argument, &dumpTree, YES},
         {"threaded", no_argument, &threaded, YES},
+        {"background-html-parser", no_argument, &backgroundHTMLParser, YES},
         {"complex-text", no_argument, &forceComplexText, YES},
         {NULL, 0, NULL, 0}
     };
@@ -1053,6 +1055,7 @@ static void resetWebViewToConsistentStateBeforeTesting()
     [WebView _removeAllUserContentFromGroup:[webView groupName]];
     [[webView window] setAutodisplay:NO];
     [webView _setMinimumTimerInterval:[WebView _defaultMinimumTimerInterval]];
+    [WebView _setBackgroundHTMLParserEnabled:backgroundHTMLParser];
 
     resetDefaultsToConsistentValues();
 
@@ -1105,3 +1105,8 @@ void LayoutTestController::setMinimumTimerInterval(double minimumTimerInterval)
 {
     [[mainFrame webView] _setMinimumTimerInterval:minimumTimerInterval];
 }
+
+void LayoutTestController::setBackgroundHTMLParserEnabled(bool enabled)
+{
+    [WebView _setBackgroundHTMLParserEnabled:enabled];
+}
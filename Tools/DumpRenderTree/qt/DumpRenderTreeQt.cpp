@@ -207,6 +207,7 @@ void WebPage::resetSettings()
     settings()->setUserStyleSheetUrl(QUrl()); // reset to default
 
     DumpRenderTreeSupportQt::setMinimumTimerInterval(this, DumpRenderTreeSupportQt::defaultMinimumTimerInterval());
+    DumpRenderTreeSupportQt::setBackgroundHTMLParserEnabled(false);
 
     m_pendingGeolocationRequests.clear();
 }
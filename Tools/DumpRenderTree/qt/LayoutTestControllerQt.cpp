@@ -871,6 +871,11 @@ void LayoutTestController::setMinimumTimerInterval(double minimumTimerInterval)
     DumpRenderTreeSupportQt::setMinimumTimerInterval(m_drt->webPage(), minimumTimerInterval);
 }
 
+void LayoutTestController::setBackgroundHTMLParserEnabled(bool enabled)
+{
+    DumpRenderTreeSupportQt::setBackgroundHTMLParserEnabled(enabled);
+}
+
 void LayoutTestController::originsWithLocalStorage()
 {
     // FIXME: Implement.
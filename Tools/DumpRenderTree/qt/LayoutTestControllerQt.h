@@ -258,6 +258,7 @@ public slots:
     void addUserStyleSheet(const QString& sourceCode);
 
     void setMinimumTimerInterval(double);
+    void setBackgroundHTMLParserEnabled(bool);
     
     void originsWithLocalStorage();
     void deleteAllLocalStorage();
@@ -1517,4 +1517,9 @@ void LayoutTestController::setMinimumTimerInterval(double minimumTimerInterval)
     viewPrivate->setMinimumTimerInterval(minimumTimerInterval);
 }
 
+void LayoutTestController::setBackgroundHTMLParserEnabled(bool)
+{
+    // FIXME: Implement.
+}
+
 
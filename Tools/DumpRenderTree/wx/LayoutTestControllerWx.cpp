@@ -587,6 +587,11 @@ void LayoutTestController::setMinimumTimerInterval(double interval) {
 
 }
 
+void LayoutTestController::setBackgroundHTMLParserEnabled(bool)
+{
+    // FIXME: Implement.
+}
+
 void LayoutTestController::syncLocalStorage()
 {
     // FIXME: Implement.